@@ -37,9 +37,18 @@ THE SOFTWARE.
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "platform/CCStdC.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(Sequence, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(RotateBy, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(MoveBy, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(MoveTo, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(ScaleTo, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(FadeTo, 100)
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(DelayTime, 100)
+
 // Extra action for making a Sequence or Spawn when only adding one action to it.
 class ExtraAction : public FiniteTimeAction
 {
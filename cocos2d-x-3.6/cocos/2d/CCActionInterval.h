@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "2d/CCAnimation.h"
 #include "base/CCProtocols.h"
 #include "base/CCVector.h"
+#include "base/allocator/CCAllocatorMacros.h"
 
 NS_CC_BEGIN
 
@@ -120,6 +121,8 @@ protected:
 class CC_DLL Sequence : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(Sequence)
+
     /** Helper constructor to create an array of sequenceable actions.
      *
      * @return An autoreleased Sequence object.
@@ -507,6 +510,8 @@ private:
 class CC_DLL RotateBy : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(RotateBy)
+
     /** 
      * Creates the action.
      *
@@ -577,6 +582,8 @@ private:
 class CC_DLL MoveBy : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(MoveBy)
+
     /** 
      * Creates the action.
      *
@@ -632,6 +639,8 @@ private:
 class CC_DLL MoveTo : public MoveBy
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(MoveTo)
+
     /** 
      * Creates the action.
      * @param duration Duration time, in seconds.
@@ -956,6 +965,8 @@ private:
 class CC_DLL ScaleTo : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(ScaleTo)
+
     /** 
      * Creates the action with the same scale factor for X and Y.
      * @param duration Duration time, in seconds.
@@ -1133,6 +1144,8 @@ private:
 class CC_DLL FadeTo : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(FadeTo)
+
     /** 
      * Creates an action with duration and opacity.
      * @param duration Duration time, in seconds.
@@ -1344,6 +1357,8 @@ private:
 class CC_DLL DelayTime : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(DelayTime)
+
     /** 
      * Creates the action.
      * @param d Duration time, in seconds.
@@ -368,6 +368,19 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
     return 0;
 }
 
+bool ActionManager::hasRunningActions() const
+{
+    for (tHashElement *elt = _targets; elt != nullptr; elt = (tHashElement*)(elt->hh.next))
+    {
+        if (! elt->paused && elt->actions && elt->actions->num > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 // main loop
 void ActionManager::update(float dt)
 {
@@ -137,6 +137,11 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE inline ssize_t numberOfRunningActionsInTarget(Node *target) const { return getNumberOfRunningActionsInTarget(target); }
 
+    /** Whether an action is running in a target which isn't paused.
+     * Used by the render on demand mode of the Director.
+     */
+    bool hasRunningActions() const;
+
     /** Pauses the target: all running actions and newly added actions will be paused.
      *
      * @param target    A certain target.
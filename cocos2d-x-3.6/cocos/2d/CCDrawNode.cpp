@@ -172,6 +172,9 @@ void DrawNode::ensureCapacity(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    // every draw* call reserves room here before appending vertices
+    _director->requestRedraw();
+
     if(_bufferCount + count > _bufferCapacity)
     {
         _bufferCapacity += MAX(_bufferCapacity, count);
@@ -183,6 +186,8 @@ void DrawNode::ensureCapacityGLPoint(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    _director->requestRedraw();
+
     if(_bufferCountGLPoint + count > _bufferCapacityGLPoint)
     {
         _bufferCapacityGLPoint += MAX(_bufferCapacityGLPoint, count);
@@ -194,6 +199,8 @@ void DrawNode::ensureCapacityGLLine(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    _director->requestRedraw();
+
     if(_bufferCountGLLine + count > _bufferCapacityGLLine)
     {
         _bufferCapacityGLLine += MAX(_bufferCapacityGLLine, count);
@@ -921,6 +928,7 @@ void DrawNode::clear()
     _dirtyGLLine = true;
     _bufferCountGLPoint = 0;
     _dirtyGLPoint = true;
+    _director->requestRedraw();
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
@@ -931,6 +939,7 @@ const BlendFunc& DrawNode::getBlendFunc() const
 void DrawNode::setBlendFunc(const BlendFunc &blendFunc)
 {
     _blendFunc = blendFunc;
+    _director->requestRedraw();
 }
 
 NS_CC_END
@@ -480,6 +480,7 @@ void Label::setString(const std::string& text)
     {
         _originalUTF8String = text;
         _contentDirty = true;
+        _director->requestRedraw();
 
         std::u16string utf16String;
         if (StringUtils::UTF8ToUTF16(_originalUTF8String, utf16String))
@@ -1480,6 +1481,21 @@ void Label::updateColor()
     }
 }
 
+void Label::resetForReuse()
+{
+    CCASSERT(!_running && _parent == nullptr, "Only a node removed from its parent can be reset");
+
+    resetStateForReuse();
+
+    setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    setString("");
+    disableEffect();
+    if ((_currentLabelType == LabelType::TTF || _currentLabelType == LabelType::STRING_TEXTURE) && _textColor != Color4B::WHITE)
+    {
+        setTextColor(Color4B::WHITE);
+    }
+}
+
 std::string Label::getDescription() const
 {
     std::string utf8str;
@@ -462,6 +462,11 @@ public:
 
     virtual void setCameraMask(unsigned short mask, bool applyChildren = true) override;
 
+    /** Also clears the string and the effects and centers the anchor point.
+     * The font, the alignment and the dimensions are kept, the children of a label are internal and aren't removed.
+     */
+    virtual void resetForReuse() override;
+
     CC_DEPRECATED_ATTRIBUTE static Label* create(const std::string& text, const std::string& font, float fontSize,
         const Size& dimensions = Size::ZERO, TextHAlignment hAlignment = TextHAlignment::LEFT,
         TextVAlignment vAlignment = TextVAlignment::TOP);
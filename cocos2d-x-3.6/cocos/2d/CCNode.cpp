@@ -32,20 +32,24 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCProfiling.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
+#include "2d/CCTransformHierarchy.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsBody.h"
@@ -62,6 +66,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(Node, 500)
+
 bool nodeComparisonLess(Node* n1, Node* n2)
 {
     return( n1->getLocalZOrder() < n2->getLocalZOrder() ||
@@ -69,8 +75,25 @@ bool nodeComparisonLess(Node* n1, Node* n2)
            );
 }
 
+static bool nodeComparisonLessY(Node* n1, Node* n2)
+{
+    if (n1->getLocalZOrder() != n2->getLocalZOrder())
+        return n1->getLocalZOrder() < n2->getLocalZOrder();
+    // higher nodes are drawn first
+    if (n1->getPositionY() != n2->getPositionY())
+        return n1->getPositionY() > n2->getPositionY();
+    return n1->getOrderOfArrival() < n2->getOrderOfArrival();
+}
+
+// Above this many nodes out of order, sortNodes() sorts the whole array
+static const size_t MAX_NODES_INSERTED = 32;
+// Shifts allowed per node to sortNodesByY() before it sorts the whole array
+static const ssize_t MAX_SHIFTS_PER_NODE = 4;
+
 // FIXME:: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 int Node::s_globalOrderOfArrival = 1;
+unsigned int Node::s_hierarchyVersion = 0;
+unsigned int Node::s_visualVersion = 0;
 
 // MARK: Constructor, Destructor, Init
 
@@ -90,7 +113,9 @@ Node::Node(void)
 , _contentSize(Size::ZERO)
 , _contentSizeDirty(true)
 , _transformDirty(true)
+, _inverse(nullptr)
 , _inverseDirty(true)
+, _additionalTransform(nullptr)
 , _useAdditionalTransform(false)
 , _transformUpdated(true)
 // children (lazy allocs)
@@ -100,17 +125,14 @@ Node::Node(void)
 , _parent(nullptr)
 // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
 , _tag(Node::INVALID_TAG)
-, _name("")
-, _hashOfName(0)
-// userData is always inited as nil
-, _userData(nullptr)
-, _userObject(nullptr)
+, _extraData(nullptr)
 , _glProgramState(nullptr)
 , _orderOfArrival(0)
 , _running(false)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _ySortChildren(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -134,6 +156,9 @@ Node::Node(void)
 , _cascadeColorEnabled(false)
 , _cascadeOpacityEnabled(false)
 , _cameraMask(1)
+, _touchBoundsIndexed(false)
+, _transformHierarchy(nullptr)
+, _transformIndex(-1)
 {
     // set default scheduler and actionManager
     _director = Director::getInstance();
@@ -148,7 +173,7 @@ Node::Node(void)
     ScriptEngineProtocol* engine = ScriptEngineManager::getInstance()->getScriptEngine();
     _scriptType = engine != nullptr ? engine->getScriptType() : kScriptTypeNone;
 #endif
-    _transform = _inverse = _additionalTransform = Mat4::IDENTITY;
+    _transform = Mat4::IDENTITY;
 }
 
 Node * Node::create()
@@ -178,11 +203,19 @@ Node::~Node()
 
     // User object has to be released before others, since userObject may have a weak reference of this node
     // It may invoke `node->stopAllAction();` while `_actionManager` is null if the next line is after `CC_SAFE_RELEASE_NULL(_actionManager)`.
-    CC_SAFE_RELEASE_NULL(_userObject);
+    if (_extraData)
+    {
+        CC_SAFE_RELEASE_NULL(_extraData->userObject);
+    }
     
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
 
+    if (_transformHierarchy && _transformIndex == 0)
+    {
+        delete _transformHierarchy;
+    }
+
     //for (auto& child : _children)
     for (auto p_child = _children.begin(); p_child != _children.end(); ++p_child)
 	{
@@ -212,6 +245,10 @@ Node::~Node()
 
     CCASSERT(!_running, "Node still marked as running on node destruction! Was base class onExit() called in derived class onExit() implementations?");
     CC_SAFE_RELEASE(_eventDispatcher);
+
+    CC_SAFE_DELETE(_inverse);
+    CC_SAFE_DELETE(_additionalTransform);
+    CC_SAFE_DELETE(_extraData);
 }
 
 bool Node::init()
@@ -219,6 +256,61 @@ bool Node::init()
     return true;
 }
 
+struct Node::ChildIndex
+{
+    std::unordered_multimap<size_t, Node*> names;   ///< children by hash of name
+    std::unordered_multimap<int, Node*> tags;       ///< children by tag
+};
+
+Node::ExtraData::ExtraData()
+: hashOfName(0)
+, userData(nullptr)
+, userObject(nullptr)
+, childIndex(nullptr)
+{
+}
+
+Node::ExtraData::~ExtraData()
+{
+    CC_SAFE_DELETE(childIndex);
+}
+
+Node::ExtraData* Node::getExtraData()
+{
+    if (_extraData == nullptr)
+    {
+        _extraData = new (std::nothrow) ExtraData();
+    }
+    return _extraData;
+}
+
+size_t Node::getExtraDataMemory() const
+{
+    size_t size = 0;
+    if (_inverse)
+        size += sizeof(Mat4);
+    if (_additionalTransform)
+        size += sizeof(Mat4);
+    if (_extraData)
+    {
+        size += sizeof(ExtraData);
+        // heap allocated characters, short strings may fit in the string itself
+        if (_extraData->name.capacity() >= sizeof(std::string))
+            size += _extraData->name.capacity() + 1;
+
+        // approximation: buckets plus one hash node per entry
+        ChildIndex* index = _extraData->childIndex;
+        if (index)
+        {
+            size += sizeof(ChildIndex);
+            size += (index->names.bucket_count() + index->tags.bucket_count()) * sizeof(void*);
+            size += index->names.size() * (sizeof(void*) * 2 + sizeof(size_t) + sizeof(Node*));
+            size += index->tags.size() * (sizeof(void*) * 2 + sizeof(int) + sizeof(Node*));
+        }
+    }
+    return size;
+}
+
 void Node::cleanup()
 {
     // actions
@@ -244,6 +336,60 @@ void Node::cleanup()
 	}
 }
 
+void Node::resetForReuse()
+{
+    CCASSERT(!_running && _parent == nullptr, "Only a node removed from its parent can be reset");
+
+    removeAllChildrenWithCleanup(true);
+    resetStateForReuse();
+}
+
+void Node::resetStateForReuse()
+{
+    stopAllActions();
+    unscheduleAllCallbacks();
+    _eventDispatcher->removeEventListenersForTarget(this);
+    removeAllComponents();
+
+    _position = Vec2::ZERO;
+    _positionZ = 0.0f;
+    _usingNormalizedPosition = false;
+    _normalizedPositionDirty = false;
+    _rotationX = _rotationY = _rotationZ_X = _rotationZ_Y = 0.0f;
+    _rotationQuat.set(0.0f, 0.0f, 0.0f, 1.0f);
+    _scaleX = _scaleY = _scaleZ = 1.0f;
+    _skewX = _skewY = 0.0f;
+    _anchorPoint = Vec2::ZERO;
+    _anchorPointInPoints = Vec2::ZERO;
+    _ignoreAnchorPointForPosition = false;
+    setAdditionalTransform(nullptr);
+
+    _visible = true;
+    _localZOrder = 0;
+    _globalZOrder = 0;
+    _orderOfArrival = 0;
+    _cameraMask = 1;
+    _tag = Node::INVALID_TAG;
+
+    if (_extraData)
+    {
+        setName("");
+        _extraData->userData = nullptr;
+        setUserObject(nullptr);
+        _extraData->onEnterCallback = nullptr;
+        _extraData->onExitCallback = nullptr;
+        _extraData->onEnterTransitionDidFinishCallback = nullptr;
+        _extraData->onExitTransitionDidStartCallback = nullptr;
+    }
+
+    // virtual, so the subclasses update their vertices
+    setColor(Color3B::WHITE);
+    setOpacity(255);
+
+    _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
+}
+
 std::string Node::getDescription() const
 {
     return StringUtils::format("<Node | Tag = %d", _tag);
@@ -270,6 +416,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 }
 
 float Node::getSkewY() const
@@ -291,6 +438,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 }
 
 void Node::setLocalZOrder(int z)
@@ -303,8 +451,9 @@ void Node::setLocalZOrder(int z)
     {
         _parent->reorderChild(this, z);
     }
+    ++s_visualVersion;
 
-    _eventDispatcher->setDirtyForNode(this);
+    _eventDispatcher->setDirtyForLocalZOrder(this);
 }
 
 /// zOrder setter : private method
@@ -320,6 +469,7 @@ void Node::setGlobalZOrder(float globalZOrder)
     {
         _globalZOrder = globalZOrder;
         _eventDispatcher->setDirtyForNode(this);
+        ++s_visualVersion;
     }
 }
 
@@ -338,6 +488,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -361,6 +512,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -417,6 +569,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 }
 
 Quaternion Node::getRotationQuat() const
@@ -438,6 +591,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
     
     updateRotationQuat();
 }
@@ -461,6 +615,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
     
     updateRotationQuat();
 }
@@ -480,6 +635,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -503,6 +659,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -519,6 +676,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -548,6 +706,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 }
 
 /// scaleY getter
@@ -564,6 +723,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -600,6 +760,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
     _usingNormalizedPosition = false;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
@@ -651,6 +812,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 
     _positionZ = positionZ;
 }
@@ -671,6 +833,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
 #if CC_USE_PHYSICS
     if (_physicsWorld && _physicsBodyAssociatedWith > 0)
     {
@@ -698,6 +861,7 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        ++s_visualVersion;
     }
 }
 
@@ -727,6 +891,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        ++s_visualVersion;
     }
 }
 
@@ -744,6 +909,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        ++s_visualVersion;
     }
 }
 
@@ -772,6 +938,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        ++s_visualVersion;
     }
 }
 
@@ -784,25 +951,48 @@ int Node::getTag() const
 /// tag setter
 void Node::setTag(int tag)
 {
+    Node* indexingParent = (_parent && _parent->getChildIndex()) ? _parent : nullptr;
+    if (indexingParent)
+        indexingParent->unindexChild(this);
+
     _tag = tag ;
+
+    if (indexingParent)
+        indexingParent->indexChild(this);
 }
 
 std::string Node::getName() const
 {
-    return _name;
+    return _extraData ? _extraData->name : std::string();
 }
 
 void Node::setName(const std::string& name)
 {
-    _name = name;
+    // don't allocate the extra data to clear a name that isn't set
+    if (_extraData == nullptr && name.empty())
+        return;
+
+    Node* indexingParent = (_parent && _parent->getChildIndex()) ? _parent : nullptr;
+    if (indexingParent)
+        indexingParent->unindexChild(this);
+
+    ExtraData* extraData = getExtraData();
+    extraData->name = name;
     std::hash<std::string> h;
-    _hashOfName = h(name);
+    extraData->hashOfName = h(name);
+
+    if (indexingParent)
+        indexingParent->indexChild(this);
+    ++s_hierarchyVersion;
 }
 
 /// userData setter
 void Node::setUserData(void *userData)
 {
-    _userData = userData;
+    if (_extraData == nullptr && userData == nullptr)
+        return;
+
+    getExtraData()->userData = userData;
 }
 
 int Node::getOrderOfArrival() const
@@ -818,9 +1008,67 @@ void Node::setOrderOfArrival(int orderOfArrival)
 
 void Node::setUserObject(Ref *userObject)
 {
+    if (_extraData == nullptr && userObject == nullptr)
+        return;
+
+    ExtraData* extraData = getExtraData();
     CC_SAFE_RETAIN(userObject);
-    CC_SAFE_RELEASE(_userObject);
-    _userObject = userObject;
+    CC_SAFE_RELEASE(extraData->userObject);
+    extraData->userObject = userObject;
+}
+
+static const std::function<void()> s_emptyCallback;
+
+void Node::setOnEnterCallback(const std::function<void()>& callback)
+{
+    if (_extraData == nullptr && !callback)
+        return;
+
+    getExtraData()->onEnterCallback = callback;
+}
+
+const std::function<void()>& Node::getOnEnterCallback() const
+{
+    return _extraData ? _extraData->onEnterCallback : s_emptyCallback;
+}
+
+void Node::setOnExitCallback(const std::function<void()>& callback)
+{
+    if (_extraData == nullptr && !callback)
+        return;
+
+    getExtraData()->onExitCallback = callback;
+}
+
+const std::function<void()>& Node::getOnExitCallback() const
+{
+    return _extraData ? _extraData->onExitCallback : s_emptyCallback;
+}
+
+void Node::setonEnterTransitionDidFinishCallback(const std::function<void()>& callback)
+{
+    if (_extraData == nullptr && !callback)
+        return;
+
+    getExtraData()->onEnterTransitionDidFinishCallback = callback;
+}
+
+const std::function<void()>& Node::getonEnterTransitionDidFinishCallback() const
+{
+    return _extraData ? _extraData->onEnterTransitionDidFinishCallback : s_emptyCallback;
+}
+
+void Node::setonExitTransitionDidStartCallback(const std::function<void()>& callback)
+{
+    if (_extraData == nullptr && !callback)
+        return;
+
+    getExtraData()->onExitTransitionDidStartCallback = callback;
+}
+
+const std::function<void()>& Node::getonExitTransitionDidStartCallback() const
+{
+    return _extraData ? _extraData->onExitTransitionDidStartCallback : s_emptyCallback;
 }
 
 GLProgramState* Node::getGLProgramState() const
@@ -881,10 +1129,108 @@ void Node::childrenAlloc()
     _children.reserve(4);
 }
 
+void Node::setChildIndexEnabled(bool enabled)
+{
+    if (enabled == isChildIndexEnabled())
+        return;
+
+    if (enabled)
+    {
+        ExtraData* extraData = getExtraData();
+        extraData->childIndex = new (std::nothrow) ChildIndex();
+        //for (const auto& child : _children)
+        for (auto p_child = _children.begin(); p_child != _children.end(); ++p_child)
+        {
+            indexChild(*p_child);
+        }
+    }
+    else
+    {
+        CC_SAFE_DELETE(_extraData->childIndex);
+    }
+}
+
+bool Node::isChildIndexEnabled() const
+{
+    return getChildIndex() != nullptr;
+}
+
+void Node::indexChild(Node* child)
+{
+    ChildIndex* index = getChildIndex();
+    if (child->_extraData && !child->_extraData->name.empty())
+        index->names.insert(std::make_pair(child->_extraData->hashOfName, child));
+    if (child->_tag != INVALID_TAG)
+        index->tags.insert(std::make_pair(child->_tag, child));
+}
+
+void Node::unindexChild(Node* child)
+{
+    ChildIndex* index = getChildIndex();
+    if (child->_extraData && !child->_extraData->name.empty())
+    {
+        auto range = index->names.equal_range(child->_extraData->hashOfName);
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == child)
+            {
+                index->names.erase(iter);
+                break;
+            }
+        }
+    }
+    if (child->_tag != INVALID_TAG)
+    {
+        auto range = index->tags.equal_range(child->_tag);
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == child)
+            {
+                index->tags.erase(iter);
+                break;
+            }
+        }
+    }
+}
+
+bool Node::lookupIndexedChildByName(const std::string& name, size_t hash, Node** child) const
+{
+    ChildIndex* index = getChildIndex();
+    if (index == nullptr)
+        return false;
+
+    Node* found = nullptr;
+    auto range = index->names.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second->_extraData->name.compare(name) == 0)
+        {
+            // the first one in the children order has to be returned
+            if (found)
+                return false;
+            found = iter->second;
+        }
+    }
+    *child = found;
+    return true;
+}
+
 Node* Node::getChildByTag(int tag) const
 {
     CCASSERT( tag != Node::INVALID_TAG, "Invalid tag");
 
+    ChildIndex* index = getChildIndex();
+    if (index)
+    {
+        auto range = index->tags.equal_range(tag);
+        if (range.first == range.second)
+            return nullptr;
+        // the first one in the children order has to be returned
+        auto next = range.first;
+        if (++next == range.second)
+            return range.first->second;
+    }
+
     //for (const auto& child : _children)
     for (auto p_child = _children.begin(); p_child != _children.end(); ++p_child)
 	{
@@ -901,13 +1247,17 @@ Node* Node::getChildByName(const std::string& name) const
     
     std::hash<std::string> h;
     size_t hash = h(name);
+
+    Node* indexed = nullptr;
+    if (lookupIndexedChildByName(name, hash, &indexed))
+        return indexed;
     
     //for (const auto& child : _children)
     for (auto p_child = _children.begin(); p_child != _children.end(); ++p_child)
 	{
 		const auto& child = *p_child;
         // Different strings may have the same hash code, but can use it to compare first for speed
-        if(child->_hashOfName == hash && child->_name.compare(name) == 0)
+        if(child->_extraData && child->_extraData->hashOfName == hash && child->_extraData->name.compare(name) == 0)
             return child;
     }
     return nullptr;
@@ -1011,7 +1361,7 @@ bool Node::doEnumerate(std::string name, std::function<bool (Node *)> callback)
     for (auto p_child = _children.begin(); p_child != _children.end(); ++p_child)
 	{
 		const auto& child = *p_child;
-        if (boost::regex_match(child->_name, boost::regex(searchName)))
+        if (boost::regex_match(child->getName(), boost::regex(searchName)))
         {
             if (!needRecursive)
             {
@@ -1063,6 +1413,9 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
     }
     
     this->insertChild(child, localZOrder);
+
+    if (_transformHierarchy)
+        _transformHierarchy->setStructureDirty();
     
     if (setTag)
         child->setTag(tag);
@@ -1071,6 +1424,10 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
     
     child->setParent(this);
     child->setOrderOfArrival(s_globalOrderOfArrival++);
+
+    if (getChildIndex())
+        indexChild(child);
+    ++s_hierarchyVersion;
     
 #if CC_USE_PHYSICS
     _physicsBodyAssociatedWith += child->_physicsBodyAssociatedWith;
@@ -1114,13 +1471,13 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
 void Node::addChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Argument must be non-nil");
-    this->addChild(child, zOrder, child->_name);
+    this->addChild(child, zOrder, child->getName());
 }
 
 void Node::addChild(Node *child)
 {
     CCASSERT( child != nullptr, "Argument must be non-nil");
-    this->addChild(child, child->_localZOrder, child->_name);
+    this->addChild(child, child->_localZOrder, child->getName());
 }
 
 void Node::removeFromParent()
@@ -1231,11 +1588,24 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
         {
             child->cleanup();
         }
+
+        if (child->_transformHierarchy && child->_transformIndex != 0)
+        {
+            child->_transformHierarchy->removeSubtree(child);
+        }
         // set parent nil at the end
         child->setParent(nullptr);
     }
     
     _children.clear();
+
+    ChildIndex* index = getChildIndex();
+    if (index)
+    {
+        index->names.clear();
+        index->tags.clear();
+    }
+    ++s_hierarchyVersion;
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1260,6 +1630,15 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
         child->cleanup();
     }
 
+    if (child->_transformHierarchy && child->_transformIndex != 0)
+    {
+        child->_transformHierarchy->removeSubtree(child);
+    }
+
+    if (getChildIndex())
+        unindexChild(child);
+    ++s_hierarchyVersion;
+
     // set parent nil at the end
     child->setParent(nullptr);
 
@@ -1286,11 +1665,112 @@ void Node::reorderChild(Node *child, int zOrder)
 
 void Node::sortAllChildren()
 {
-    if (_reorderChildDirty)
+    if (_ySortChildren)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortNodesByY(_children);
         _reorderChildDirty = false;
     }
+    else if (_reorderChildDirty)
+    {
+        sortNodes(_children);
+        _reorderChildDirty = false;
+    }
+}
+
+void Node::setYSortEnabled(bool enabled)
+{
+    _ySortChildren = enabled;
+    _reorderChildDirty = true;
+}
+
+void Node::sortNodes(Vector<Node*>& nodes)
+{
+    // main thread only, kept to avoid an allocation per sort
+    static std::vector<Node*> s_nodesOutOfOrder;
+
+    ssize_t count = nodes.size();
+    if (count < 2)
+        return;
+
+    auto first = nodes.begin();
+
+    // Compacts the nodes which are in order with both their kept predecessor and their successor,
+    // the others were reordered or added since the last sort.
+    ssize_t kept = 0;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Node* node = first[i];
+        if ((kept == 0 || !nodeComparisonLess(node, first[kept - 1])) &&
+            (i + 1 == count || !nodeComparisonLess(first[i + 1], node)))
+        {
+            first[kept++] = node;
+        }
+        else
+        {
+            s_nodesOutOfOrder.push_back(node);
+
+            if (s_nodesOutOfOrder.size() > MAX_NODES_INSERTED)
+            {
+                // too many to insert, stops the pass and sorts everything: the nodes before i+1 are either kept or out of order
+                std::copy(s_nodesOutOfOrder.begin(), s_nodesOutOfOrder.end(), first + kept);
+                s_nodesOutOfOrder.clear();
+                std::sort(first, first + count, nodeComparisonLess);
+                return;
+            }
+        }
+    }
+
+    if (s_nodesOutOfOrder.empty())
+        return;
+
+    std::copy(s_nodesOutOfOrder.begin(), s_nodesOutOfOrder.end(), first + kept);
+    s_nodesOutOfOrder.clear();
+
+    std::sort(first + kept, first + count, nodeComparisonLess);
+
+    // binary insertion, the inserted nodes are sorted so each one goes after the previous one
+    auto lowest = first;
+    for (ssize_t i = kept; i < count; ++i)
+    {
+        auto position = std::upper_bound(lowest, first + i, first[i], nodeComparisonLess);
+        std::rotate(position, first + i, first + i + 1);
+        lowest = position + 1;
+    }
+}
+
+bool Node::sortNodesByY(Vector<Node*>& nodes)
+{
+    ssize_t count = nodes.size();
+    auto first = nodes.begin();
+    ssize_t shiftsLeft = count * MAX_SHIFTS_PER_NODE;
+    bool changed = false;
+
+    for (ssize_t i = 1; i < count; ++i)
+    {
+        Node* node = first[i];
+        ssize_t j = i;
+        while (j > 0 && nodeComparisonLessY(node, first[j - 1]))
+        {
+            first[j] = first[j - 1];
+            --j;
+        }
+
+        if (j != i)
+        {
+            first[j] = node;
+            changed = true;
+
+            shiftsLeft -= i - j;
+            if (shiftsLeft < 0)
+            {
+                // far from sorted, e.g. the first sort
+                std::sort(first, first + count, nodeComparisonLessY);
+                return true;
+            }
+        }
+    }
+
+    return changed;
 }
 
 // MARK: draw / visit
@@ -1322,19 +1802,15 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
 #endif
     if(_usingNormalizedPosition)
     {
-        CCASSERT(_parent, "setNormalizedPosition() doesn't work with orphan nodes");
-        if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
-        {
-            auto& s = _parent->getContentSize();
-            _position.x = _normalizedPosition.x * s.width;
-            _position.y = _normalizedPosition.y * s.height;
-            _transformUpdated = _transformDirty = _inverseDirty = true;
-            _normalizedPositionDirty = false;
-        }
+        applyNormalizedPosition((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) != 0);
     }
     
     if (!isVisitableByVisitingCamera())
+    {
+        if (_transformHierarchy && _transformIndex == 0)
+            _transformHierarchy->update(_modelViewTransform, parentFlags);
         return parentFlags;
+    }
     
     uint32_t flags = parentFlags;
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
@@ -1342,7 +1818,23 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
+    {
+        // Batched descendants use the world transform computed by the hierarchy update,
+        // unless their transform or an ancestor one changed since then.
+        if (_transformHierarchy && _transformIndex > 0 && !_transformDirty && _transformHierarchy->isUpToDate(_transformIndex))
+        {
+            _modelViewTransform = _transformHierarchy->getWorldTransform(_transformIndex);
+        }
+        else
+        {
+            _modelViewTransform = this->transform(parentTransform);
+            if (_transformHierarchy && _transformIndex > 0)
+                _transformHierarchy->setOutOfDate(_transformIndex);
+        }
+        
+        if (_touchBoundsIndexed)
+            _eventDispatcher->setDirtyForNodeBounds(this);
+    }
     
 #if CC_USE_PHYSICS
     if (_updateTransformFromPhysics) {
@@ -1354,9 +1846,25 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     _contentSizeDirty = false;
 #endif
 
+    if (_transformHierarchy && _transformIndex == 0)
+        _transformHierarchy->update(_modelViewTransform, flags);
+
     return flags;
 }
 
+void Node::applyNormalizedPosition(bool parentContentSizeDirty)
+{
+    CCASSERT(_parent, "setNormalizedPosition() doesn't work with orphan nodes");
+    if (parentContentSizeDirty || _normalizedPositionDirty)
+    {
+        auto& s = _parent->getContentSize();
+        _position.x = _normalizedPosition.x * s.width;
+        _position.y = _normalizedPosition.y * s.height;
+        _transformUpdated = _transformDirty = _inverseDirty = true;
+        _normalizedPositionDirty = false;
+    }
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -1372,6 +1880,8 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         return;
     }
 
+    CC_PROFILER_ZONE_CATEGORY(kProfilerCategoryNode, "Node::visit");
+
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
     // IMPORTANT:
@@ -1426,8 +1936,8 @@ Mat4 Node::transform(const Mat4& parentTransform)
 
 void Node::onEnter()
 {
-    if (_onEnterCallback)
-        _onEnterCallback();
+    if (_extraData && _extraData->onEnterCallback)
+        _extraData->onEnterCallback();
 
 #if CC_ENABLE_SCRIPT_BINDING
     if (_scriptType == kScriptTypeJavascript)
@@ -1460,8 +1970,8 @@ void Node::onEnter()
 
 void Node::onEnterTransitionDidFinish()
 {
-    if (_onEnterTransitionDidFinishCallback)
-        _onEnterTransitionDidFinishCallback();
+    if (_extraData && _extraData->onEnterTransitionDidFinishCallback)
+        _extraData->onEnterTransitionDidFinishCallback();
         
 #if CC_ENABLE_SCRIPT_BINDING
     if (_scriptType == kScriptTypeJavascript)
@@ -1489,8 +1999,8 @@ void Node::onEnterTransitionDidFinish()
 
 void Node::onExitTransitionDidStart()
 {
-    if (_onExitTransitionDidStartCallback)
-        _onExitTransitionDidStartCallback();
+    if (_extraData && _extraData->onExitTransitionDidStartCallback)
+        _extraData->onExitTransitionDidStartCallback();
     
 #if CC_ENABLE_SCRIPT_BINDING
     if (_scriptType == kScriptTypeJavascript)
@@ -1517,8 +2027,8 @@ void Node::onExitTransitionDidStart()
 
 void Node::onExit()
 {
-    if (_onExitCallback)
-        _onExitCallback();
+    if (_extraData && _extraData->onExitCallback)
+        _extraData->onExitCallback();
     
 #if CC_ENABLE_SCRIPT_BINDING
     if (_scriptType == kScriptTypeJavascript)
@@ -1878,7 +2388,7 @@ const Mat4& Node::getNodeToParentTransform() const
         
         if (_useAdditionalTransform)
         {
-            _transform = _transform * _additionalTransform;
+            _transform = _transform * (*_additionalTransform);
         }
         
         _transformDirty = false;
@@ -1892,6 +2402,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    ++s_visualVersion;
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1909,10 +2420,48 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
     }
     else
     {
-        _additionalTransform = *additionalTransform;
+        if (_additionalTransform == nullptr)
+        {
+            _additionalTransform = new (std::nothrow) Mat4();
+        }
+        *_additionalTransform = *additionalTransform;
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++s_visualVersion;
+}
+
+void Node::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled == isTransformHierarchyEnabled())
+        return;
+
+    // The parent hierarchy, if any, stops or starts batching this subtree
+    TransformHierarchy* parentHierarchy = (_parent && _parent->_transformHierarchy) ? _parent->_transformHierarchy : nullptr;
+
+    if (enabled)
+    {
+        if (_transformHierarchy)
+        {
+            _transformHierarchy->removeSubtree(this);
+        }
+        _transformHierarchy = new (std::nothrow) TransformHierarchy(this);
+    }
+    else
+    {
+        delete _transformHierarchy;
+    }
+
+    if (parentHierarchy)
+    {
+        parentHierarchy->setStructureDirty();
+    }
+    _transformUpdated = true;
+}
+
+bool Node::isTransformHierarchyEnabled() const
+{
+    return _transformHierarchy != nullptr && _transformIndex == 0;
 }
 
 
@@ -1926,13 +2475,19 @@ AffineTransform Node::getParentToNodeAffineTransform() const
 
 const Mat4& Node::getParentToNodeTransform() const
 {
+    if (_inverse == nullptr)
+    {
+        _inverse = new (std::nothrow) Mat4();
+        _inverseDirty = true;
+    }
+
     if ( _inverseDirty )
     {
-        _inverse = getNodeToParentTransform().getInversed();
+        *_inverse = getNodeToParentTransform().getInversed();
         _inverseDirty = false;
     }
 
-    return _inverse;
+    return *_inverse;
 }
 
 
@@ -2204,6 +2759,7 @@ GLubyte Node::getDisplayedOpacity() const
 void Node::setOpacity(GLubyte opacity)
 {
     _displayedOpacity = _realOpacity = opacity;
+    ++s_visualVersion;
     
     updateCascadeOpacity();
 }
@@ -2285,6 +2841,7 @@ const Color3B& Node::getDisplayedColor() const
 void Node::setColor(const Color3B& color)
 {
     _displayedColor = _realColor = color;
+    ++s_visualVersion;
     
     updateCascadeColor();
 }
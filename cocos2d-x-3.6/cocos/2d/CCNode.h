@@ -30,6 +30,7 @@
 #define __CCNODE_H__
 
 #include "base/ccMacros.h"
+#include "base/allocator/CCAllocatorMacros.h"
 #include "base/CCVector.h"
 #include "base/CCProtocols.h"
 #include "base/CCScriptSupport.h"
@@ -52,6 +53,7 @@ class Renderer;
 class Director;
 class GLProgram;
 class GLProgramState;
+class TransformHierarchy;
 #if CC_USE_PHYSICS
 class PhysicsBody;
 class PhysicsWorld;
@@ -104,6 +106,8 @@ class EventListener;
 class CC_DLL Node : public Ref
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(Node)
+
     /** Default tag used for all the nodes */
     static const int INVALID_TAG = -1;
 
@@ -787,6 +791,27 @@ public:
     */
     template <typename T>
     inline T getChildByName(const std::string& name) const { return static_cast<T>(getChildByName(name)); }
+    /**
+     * Enables a hash index of the children by name and by tag, so `getChildByName()` and `getChildByTag()`
+     * don't scan the children. Worth it for nodes with many children that are looked up often.
+     *
+     * The index is kept in sync when children are added, removed, renamed or retagged.
+     *
+     * @param enabled Whether the children are indexed.
+     */
+    void setChildIndexEnabled(bool enabled);
+    /** Whether the children of this node are indexed by name and by tag. */
+    bool isChildIndexEnabled() const;
+    /**
+     * Gets a counter incremented whenever a node is added to or removed from a parent, or renamed.
+     * Used to invalidate cached lookups, e.g. the results of NodePathQuery.
+     */
+    static unsigned int getHierarchyVersion() { return s_hierarchyVersion; }
+    /**
+     * Gets a counter incremented whenever a node is moved, rotated, scaled, resized, shown, hidden, reordered or recolored.
+     * Used by the render on demand mode of the Director.
+     */
+    static unsigned int getVisualVersion() { return s_visualVersion; }
     /** Search the children of the receiving node to perform processing for nodes which share a name.
      *
      * @param name The name to search for, supports c++11 regular expression.
@@ -920,6 +945,19 @@ public:
      */
     virtual void sortAllChildren();
 
+    /**
+     * Sorts the children by local z order, then from top to bottom by y position, so that the children lower
+     * on the screen are drawn on top. Meant for isometric layers.
+     *
+     * Positions change without notifying the parent, so the children are checked on every visit. As their order
+     * barely changes from one frame to the next, it is done with an insertion sort, linear when nothing moved.
+     *
+     * @param enabled Whether the children are sorted by y position.
+     */
+    void setYSortEnabled(bool enabled);
+    /** Whether the children are sorted by y position, see setYSortEnabled(). */
+    bool isYSortEnabled() const { return _ySortChildren; }
+
     /// @} end of Children and Parent
     
     /// @{
@@ -966,11 +1004,11 @@ public:
      * @return A custom user data pointer.
      * @lua NA
      */
-    virtual void* getUserData() { return _userData; }
+    virtual void* getUserData() { return _extraData ? _extraData->userData : nullptr; }
     /**
     * @lua NA
     */
-    virtual const void* getUserData() const { return _userData; }
+    virtual const void* getUserData() const { return _extraData ? _extraData->userData : nullptr; }
 
     /**
      * Sets a custom user data pointer.
@@ -992,11 +1030,11 @@ public:
      * @return A user assigned Object.
      * @lua NA
      */
-    virtual Ref* getUserObject() { return _userObject; }
+    virtual Ref* getUserObject() { return _extraData ? _extraData->userObject : nullptr; }
     /**
     * @lua NA
     */
-    virtual const Ref* getUserObject() const { return _userObject; }
+    virtual const Ref* getUserObject() const { return _extraData ? _extraData->userObject : nullptr; }
 
     /**
      * Returns a user assigned Object.
@@ -1116,6 +1154,16 @@ public:
      */
     virtual void cleanup();
 
+    /**
+     * Brings a node removed from its parent back to the state it had after init(), so it can be reused, see NodePool.
+     * Stops the actions and the scheduled callbacks, removes the event listeners, the components and the children,
+     * and resets the transform, the visibility, the z orders, the color, the opacity, the tag, the name, the user data
+     * and the enter/exit callbacks.
+     * The content size, the GL program and the options of the node (e.g. the child index) are kept.
+     * Subclasses reset their own state after calling the parent method.
+     */
+    virtual void resetForReuse();
+
     /**
      * Override this method to draw your own node.
      * The following GL states will be enabled by default:
@@ -1603,6 +1651,25 @@ public:
     void setAdditionalTransform(Mat4* additionalTransform);
     void setAdditionalTransform(const AffineTransform& additionalTransform);
 
+    /**
+     * Enables the batched transform update of the descendants of this node.
+     *
+     * Their local and world transforms are kept in contiguous arrays owned by this node, and the dirty
+     * world transforms are computed in a single pass when this node is visited, instead of one at a time
+     * while the descendants are visited.
+     *
+     * @note The descendants are still visited one at a time, so this adds a pass over the arrays to the visit.
+     *       In the transform hierarchy benchmark of the test project it was slower than the per node update,
+     *       measure it before enabling it.
+     * @note Descendants with a physics body, and their own descendants, keep the regular update.
+     *       A descendant which enables it too updates its own subtree.
+     *
+     * @param enabled Whether the transforms of the descendants are updated in batch.
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+    /** Whether this node updates the transforms of its descendants in batch. */
+    bool isTransformHierarchyEnabled() const;
+
     /// @} end of Coordinate Converters
 
       /// @{
@@ -1695,19 +1762,24 @@ public:
     virtual void setOpacityModifyRGB(bool value) {CC_UNUSED_PARAM(value);}
     virtual bool isOpacityModifyRGB() const { return false; };
 
-    void setOnEnterCallback(const std::function<void()>& callback) { _onEnterCallback = callback; }
-    const std::function<void()>& getOnEnterCallback() const { return _onEnterCallback; }   
-    void setOnExitCallback(const std::function<void()>& callback) { _onExitCallback = callback; }
-    const std::function<void()>& getOnExitCallback() const { return _onExitCallback; }   
-    void setonEnterTransitionDidFinishCallback(const std::function<void()>& callback) { _onEnterTransitionDidFinishCallback = callback; }
-    const std::function<void()>& getonEnterTransitionDidFinishCallback() const { return _onEnterTransitionDidFinishCallback; }   
-    void setonExitTransitionDidStartCallback(const std::function<void()>& callback) { _onExitTransitionDidStartCallback = callback; }
-    const std::function<void()>& getonExitTransitionDidStartCallback() const { return _onExitTransitionDidStartCallback; }
+    void setOnEnterCallback(const std::function<void()>& callback);
+    const std::function<void()>& getOnEnterCallback() const;
+    void setOnExitCallback(const std::function<void()>& callback);
+    const std::function<void()>& getOnExitCallback() const;
+    void setonEnterTransitionDidFinishCallback(const std::function<void()>& callback);
+    const std::function<void()>& getonEnterTransitionDidFinishCallback() const;
+    void setonExitTransitionDidStartCallback(const std::function<void()>& callback);
+    const std::function<void()>& getonExitTransitionDidStartCallback() const;
     
     /** get & set camera mask, the node is visible by the camera whose camera flag & node's camera mask is true */
     unsigned short getCameraMask() const { return _cameraMask; }
     virtual void setCameraMask(unsigned short mask, bool applyChildren = true);
 
+    /** Returns the bytes allocated by the node on top of sizeof(Node) for its rarely used state, for memory reports.
+     * Children, components and subclass data aren't counted.
+     */
+    size_t getExtraDataMemory() const;
+
 CC_CONSTRUCTOR_ACCESS:
     // Nodes should be created using create();
     Node();
@@ -1718,6 +1790,59 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     /// lazy allocs
     void childrenAlloc(void);
+
+    /** Children by name and by tag, see setChildIndexEnabled() */
+    struct ChildIndex;
+
+    /** State that few nodes use, allocated on first use to keep Node small */
+    struct ExtraData
+    {
+        ExtraData();
+        ~ExtraData();
+
+        std::string name;               ///<a string label, an user defined string to identify this node
+        size_t hashOfName;              ///<hash value of name, used for speed in getChildByName
+        void *userData;                 ///< A user assingned void pointer, Can be point to any cpp object
+        Ref *userObject;                ///< A user assigned Object
+        std::function<void()> onEnterCallback;
+        std::function<void()> onExitCallback;
+        std::function<void()> onEnterTransitionDidFinishCallback;
+        std::function<void()> onExitTransitionDidStartCallback;
+        ChildIndex* childIndex;         ///< children by name and by tag, nullptr unless setChildIndexEnabled(true)
+    };
+
+    /// returns the extra data, allocating it if needed
+    ExtraData* getExtraData();
+
+    /// resetForReuse() except removing the children, for the nodes whose children are internal (e.g. Label)
+    void resetStateForReuse();
+
+    /// returns the child index, nullptr if it isn't enabled
+    ChildIndex* getChildIndex() const { return _extraData ? _extraData->childIndex : nullptr; }
+    /// adds a child to the child index
+    void indexChild(Node* child);
+    /// removes a child from the child index
+    void unindexChild(Node* child);
+    /**
+     * Looks a child up in the child index.
+     * Returns false if the index isn't enabled or if several children share the name, then the children have to be scanned.
+     */
+    bool lookupIndexedChildByName(const std::string& name, size_t hash, Node** child) const;
+
+    /**
+     * Sorts nodes with nodeComparisonLess.
+     * Only the nodes out of order (reordered or just added since the last sort) are sorted and inserted back with a
+     * binary search, the whole array is sorted when there are many of them.
+     */
+    static void sortNodes(Vector<Node*>& nodes);
+    /**
+     * Sorts nodes by local z order, then by descending y position, with an insertion sort.
+     * @return True if the order changed.
+     */
+    static bool sortNodesByY(Vector<Node*>& nodes);
+
+    /// updates the position from the normalized position if needed
+    void applyNormalizedPosition(bool parentContentSizeDirty);
     
     /// helper that reorder a child
     void insertChild(Node* child, int z);
@@ -1787,9 +1912,9 @@ protected:
     // "cache" variables are allowed to be mutable
     mutable Mat4 _transform;      ///< transform
     mutable bool _transformDirty;   ///< transform dirty flag
-    mutable Mat4 _inverse;        ///< inverse transform
+    mutable Mat4* _inverse;       ///< inverse transform, allocated by the first getParentToNodeTransform()
     mutable bool _inverseDirty;     ///< inverse transform dirty flag
-    mutable Mat4 _additionalTransform; ///< transform
+    Mat4* _additionalTransform;     ///< transform, allocated by the first setAdditionalTransform()
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
 
@@ -1801,11 +1926,7 @@ protected:
     Director* _director;            //cached director pointer to improve rendering performance
     int _tag;                         ///< a tag. Can be any number you assigned just to identify this node
     
-    std::string _name;               ///<a string label, an user defined string to identify this node
-    size_t _hashOfName;            ///<hash value of _name, used for speed in getChildByName
-
-    void *_userData;                ///< A user assingned void pointer, Can be point to any cpp object
-    Ref *_userObject;               ///< A user assigned Object
+    ExtraData* _extraData;          ///< name, user data and callbacks, nullptr until one of them is set
 
     GLProgramState *_glProgramState; ///< OpenGL Program State
 
@@ -1825,6 +1946,7 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _ySortChildren;              ///< children sorted by y position on every visit
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1857,18 +1979,24 @@ protected:
     bool        _cascadeOpacityEnabled;
 
     static int s_globalOrderOfArrival;
+    static unsigned int s_hierarchyVersion;
+    static unsigned int s_visualVersion;
     
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
     
-    std::function<void()> _onEnterCallback;
-    std::function<void()> _onExitCallback;
-    std::function<void()> _onEnterTransitionDidFinishCallback;
-    std::function<void()> _onExitTransitionDidStartCallback;
+    bool _touchBoundsIndexed;       ///< whether the event dispatcher keeps the bounds of the node in its touch spatial index
+
+    TransformHierarchy* _transformHierarchy;    ///< the hierarchy batching the transform of the node, owned by the node if _transformIndex is 0
+    int _transformIndex;            ///< index of the node in _transformHierarchy
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
     
+    friend class EventDispatcher;
+    friend class TransformHierarchy;
+    friend class NodePathQuery;
+    
 #if CC_USE_PHYSICS
     friend class Scene;
 #endif //CC_USTPS
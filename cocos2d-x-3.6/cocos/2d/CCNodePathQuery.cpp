@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "2d/CCNodePathQuery.h"
+
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+NodePathQuery::NodePathQuery(const std::string& path)
+: _path(path)
+, _recursive(false)
+, _cachedRoot(nullptr)
+, _cachedVersion(0)
+{
+    CCASSERT(!path.empty(), "Invalid path");
+
+    size_t start = 0;
+    if (path.length() > 2 && path[0] == '/' && path[1] == '/')
+    {
+        _recursive = true;
+        start = 2;
+    }
+
+    std::hash<std::string> h;
+    while (start <= path.length())
+    {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos)
+            end = path.length();
+
+        Component component;
+        component.name = path.substr(start, end - start);
+        component.hash = 0;
+        CCASSERT(!component.name.empty(), "Empty name in node path");
+
+        if (component.name == "*")
+        {
+            component.type = Component::ANY;
+        }
+        else if (component.name == "..")
+        {
+            component.type = Component::PARENT;
+        }
+        else
+        {
+            component.type = Component::NAME;
+            component.hash = h(component.name);
+        }
+        _components.push_back(component);
+
+        start = end + 1;
+    }
+}
+
+void NodePathQuery::invalidate()
+{
+    _cachedRoot = nullptr;
+    _matches.clear();
+}
+
+const std::vector<Node*>& NodePathQuery::find(const Node* root)
+{
+    CCASSERT(root, "Invalid root");
+
+    if (root != _cachedRoot || Node::getHierarchyVersion() != _cachedVersion)
+    {
+        resolve(root);
+    }
+    return _matches;
+}
+
+Node* NodePathQuery::findFirst(const Node* root)
+{
+    auto& matches = find(root);
+    return matches.empty() ? nullptr : matches.front();
+}
+
+void NodePathQuery::enumerate(const Node* root, const std::function<bool(Node*)>& callback)
+{
+    CCASSERT(callback != nullptr, "Invalid callback function");
+
+    // copied, the callback may change the hierarchy and make the next query resolve again
+    auto matches = find(root);
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        // terminate enumeration if callback return true
+        if (callback(matches[i]))
+            break;
+    }
+}
+
+void NodePathQuery::resolve(const Node* root)
+{
+    _matches.clear();
+
+    if (_recursive)
+        resolveRecursively(root);
+    else
+        match(root, 0);
+
+    _cachedRoot = root;
+    _cachedVersion = Node::getHierarchyVersion();
+}
+
+void NodePathQuery::resolveRecursively(const Node* node)
+{
+    match(node, 0);
+
+    auto& children = node->getChildren();
+    //for (const auto& child : children)
+    for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
+    {
+        resolveRecursively(*p_child);
+    }
+}
+
+void NodePathQuery::match(const Node* node, size_t component)
+{
+    if (component == _components.size())
+    {
+        _matches.push_back(const_cast<Node*>(node));
+        return;
+    }
+
+    const Component& current = _components[component];
+    switch (current.type)
+    {
+    case Component::PARENT:
+        if (node->_parent)
+            match(node->_parent, component + 1);
+        break;
+
+    case Component::ANY:
+        {
+            auto& children = node->getChildren();
+            //for (const auto& child : children)
+            for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
+            {
+                match(*p_child, component + 1);
+            }
+        }
+        break;
+
+    case Component::NAME:
+        {
+            Node* indexed = nullptr;
+            if (node->lookupIndexedChildByName(current.name, current.hash, &indexed))
+            {
+                if (indexed)
+                    match(indexed, component + 1);
+                break;
+            }
+
+            auto& children = node->getChildren();
+            //for (const auto& child : children)
+            for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
+            {
+                const Node* child = *p_child;
+                // Different strings may have the same hash code, but can use it to compare first for speed
+                if (child->_extraData && child->_extraData->hashOfName == current.hash && child->_extraData->name.compare(current.name) == 0)
+                    match(child, component + 1);
+            }
+        }
+        break;
+    }
+}
+
+NS_CC_END
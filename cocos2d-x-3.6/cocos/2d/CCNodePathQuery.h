@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_NODE_PATH_QUERY_H__
+#define __CC_NODE_PATH_QUERY_H__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/** @class NodePathQuery
+ * @brief A node path parsed once, whose matches are cached until the node hierarchy changes.
+ *
+ * Meant for paths resolved every frame, e.g. by gameplay code. Search syntax:
+ * - `/` separates the names of the successive generations.
+ * - `//` at the beginning searches recursively, the path may start at any descendant.
+ * - `*` matches any name.
+ * - `..` moves up to the parent.
+ *
+ * @code
+ * static NodePathQuery query("//Enemy/Weapon");
+ * Node* weapon = query.findFirst(scene);
+ * @endcode
+ *
+ * The matches are recomputed when a node was added, removed or renamed anywhere since the
+ * last query (see Node::getHierarchyVersion()), or when the query is made from another node.
+ * Names are looked up in the child index of the nodes which enable it, see Node::setChildIndexEnabled().
+ * @js NA
+ */
+class CC_DLL NodePathQuery
+{
+public:
+    /** Constructor of NodePathQuery.
+     * @param path The path to search, relative to the node the query is made from.
+     */
+    explicit NodePathQuery(const std::string& path);
+
+    /** Gets the path given to the constructor. */
+    const std::string& getPath() const { return _path; }
+
+    /** Gets all the nodes matching the path from root, in the children order. */
+    const std::vector<Node*>& find(const Node* root);
+
+    /** Gets the first node matching the path from root, nullptr if there is none. */
+    Node* findFirst(const Node* root);
+
+    /** Calls callback for every node matching the path from root, stops when it returns true.
+     * The callback must not remove the nodes it wasn't called for yet.
+     */
+    void enumerate(const Node* root, const std::function<bool(Node*)>& callback);
+
+    /** Drops the cached matches, e.g. if the node the query was made from was deleted and another one got its address. */
+    void invalidate();
+
+protected:
+    struct Component
+    {
+        enum Type
+        {
+            NAME,
+            ANY,
+            PARENT
+        };
+
+        Type type;
+        std::string name;
+        size_t hash;
+    };
+
+    void resolve(const Node* root);
+    void resolveRecursively(const Node* node);
+    void match(const Node* node, size_t component);
+
+    std::string _path;
+    std::vector<Component> _components;
+    bool _recursive;
+
+    const Node* _cachedRoot;
+    unsigned int _cachedVersion;
+    std::vector<Node*> _matches;
+};
+
+NS_CC_END
+
+// end of _2d group
+/// @}
+
+#endif // __CC_NODE_PATH_QUERY_H__
@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "2d/CCNodePool.h"
+
+NS_CC_BEGIN
+
+NodePool::NodePool(const std::function<Node*()>& factory, ssize_t capacity)
+: _factory(factory)
+, _capacity(capacity)
+, _hits(0)
+, _misses(0)
+{
+    CCASSERT(factory != nullptr, "Invalid factory function");
+    CCASSERT(capacity >= 0, "Invalid capacity");
+}
+
+NodePool::~NodePool()
+{
+    clear();
+}
+
+void NodePool::prewarm(ssize_t count)
+{
+    if (_capacity > 0)
+    {
+        count = MIN(count, _capacity);
+    }
+
+    _freeNodes.reserve(count);
+    while (_freeNodes.size() < count)
+    {
+        Node* node = _factory();
+        if (node == nullptr)
+        {
+            CCLOG("cocos2d: NodePool: the factory failed to create a node");
+            break;
+        }
+        _freeNodes.pushBack(node);
+    }
+}
+
+Node* NodePool::acquire()
+{
+    if (_freeNodes.empty())
+    {
+        ++_misses;
+        return _factory();
+    }
+
+    ++_hits;
+    Node* node = _freeNodes.back();
+    // the pool's reference is handed over to the autorelease pool
+    node->retain();
+    node->autorelease();
+    _freeNodes.popBack();
+    return node;
+}
+
+void NodePool::recycle(Node* node)
+{
+    CCASSERT(node != nullptr, "Invalid node");
+    CCASSERT(!_freeNodes.contains(node), "The node was already given back");
+
+    // keeps the node alive while it is removed from its parent
+    node->retain();
+    if (node->getParent())
+    {
+        node->removeFromParentAndCleanup(true);
+    }
+
+    if (_capacity == 0 || _freeNodes.size() < _capacity)
+    {
+        node->resetForReuse();
+        _freeNodes.pushBack(node);
+    }
+    node->release();
+}
+
+void NodePool::clear()
+{
+    _freeNodes.clear();
+}
+
+float NodePool::getHitRate() const
+{
+    unsigned int total = _hits + _misses;
+    return total > 0 ? (float)_hits / total : 0.0f;
+}
+
+void NodePool::resetStatistics()
+{
+    _hits = _misses = 0;
+}
+
+NS_CC_END
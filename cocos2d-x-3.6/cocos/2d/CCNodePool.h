@@ -0,0 +1,115 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_NODE_POOL_H__
+#define __CC_NODE_POOL_H__
+
+#include <functional>
+
+#include "2d/CCNode.h"
+#include "base/CCVector.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class NodePool
+ * @brief Keeps the nodes which aren't used anymore to reuse them instead of creating new ones.
+ *
+ * Meant for the nodes created and destroyed at a high rate, e.g. bullets or particles made of sprites.
+ * A pool holds one kind of nodes, made by its factory. The nodes given back are reset with Node::resetForReuse(),
+ * so they are handed out again in the state they were created in.
+ *
+ * @code
+ * NodePool bullets([](){ return Sprite::create("bullet.png"); }, 512);
+ * bullets.prewarm(128);
+ *
+ * auto bullet = static_cast<Sprite*>(bullets.acquire());
+ * layer->addChild(bullet);
+ * ...
+ * bullets.recycle(bullet);
+ * @endcode
+ * @js NA
+ */
+class CC_DLL NodePool
+{
+public:
+    /** Constructor of NodePool.
+     * @param factory Creates an autoreleased node when the pool is empty, like the create() functions do.
+     * @param capacity The maximum number of nodes kept by the pool, 0 to keep all the nodes given back.
+     */
+    NodePool(const std::function<Node*()>& factory, ssize_t capacity = 0);
+    /** Destructor of NodePool, releases the nodes it keeps. */
+    ~NodePool();
+
+    /** Creates nodes until the pool keeps count of them, e.g. while loading a level. */
+    void prewarm(ssize_t count);
+
+    /** Gets a node from the pool, or creates one if the pool is empty. The node is autoreleased, like a created one. */
+    Node* acquire();
+
+    /** Gives a node back to the pool: it is removed from its parent with cleanup, reset and kept until it is acquired again.
+     * The node is released instead if the pool is full.
+     */
+    void recycle(Node* node);
+
+    /** Releases the nodes kept by the pool. */
+    void clear();
+
+    /** Gets the number of nodes kept by the pool. */
+    ssize_t getFreeCount() const { return _freeNodes.size(); }
+    /** Gets the maximum number of nodes kept by the pool, 0 if it isn't limited. */
+    ssize_t getCapacity() const { return _capacity; }
+
+    /** Gets the number of acquired nodes which came from the pool. */
+    unsigned int getHits() const { return _hits; }
+    /** Gets the number of acquired nodes which had to be created. */
+    unsigned int getMisses() const { return _misses; }
+    /** Gets the ratio of the acquired nodes which came from the pool, between 0 and 1. */
+    float getHitRate() const;
+    /** Resets the hits and the misses, e.g. at the beginning of a level. */
+    void resetStatistics();
+
+protected:
+    std::function<Node*()> _factory;
+    ssize_t _capacity;
+    Vector<Node*> _freeNodes;
+
+    unsigned int _hits;
+    unsigned int _misses;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(NodePool);
+};
+
+NS_CC_END
+
+// end of _2d group
+/// @}
+
+#endif // __CC_NODE_POOL_H__
@@ -657,6 +657,12 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    // live particles move every tick, so render on demand must not skip the frame
+    if (_isActive || _particleCount > 0)
+    {
+        _director->requestRedraw();
+    }
+
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
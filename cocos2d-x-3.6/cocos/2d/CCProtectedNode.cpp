@@ -263,7 +263,7 @@ void ProtectedNode::insertProtectedChild(cocos2d::Node *child, int z)
 void ProtectedNode::sortAllProtectedChildren()
 {
     if( _reorderProtectedChildDirty ) {
-        std::sort( std::begin(_protectedChildren), std::end(_protectedChildren), nodeComparisonLess );
+        sortNodes(_protectedChildren);
         _reorderProtectedChildDirty = false;
     }
 }
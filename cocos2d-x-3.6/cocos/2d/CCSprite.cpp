@@ -39,10 +39,13 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 
 #include "deprecated/CCString.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(Sprite, 500)
+
 #if CC_SPRITEBATCHNODE_RENDER_SUBPIXEL
 #define RENDER_IN_SUBPIXEL
 #else
@@ -346,6 +349,7 @@ void Sprite::setTexture(Texture2D *texture)
         CC_SAFE_RELEASE(_texture);
         _texture = texture;
         updateBlendFunc();
+        _director->requestRedraw();
     }
 }
 
@@ -362,6 +366,8 @@ void Sprite::setTextureRect(const Rect& rect)
 void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimmedSize)
 {
     _rectRotated = rotated;
+    // the frame may change without changing the size
+    _director->requestRedraw();
 
     setContentSize(untrimmedSize);
     setVertexRect(rect);
@@ -705,7 +711,7 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortNodes(_children);
 
         if ( _batchNode)
         {
@@ -972,7 +978,7 @@ void Sprite::setSpriteFrame(SpriteFrame *spriteFrame)
         setTexture(texture);
     }
 
-    // update rect
+    // update rect (also requests a redraw)
     _rectRotated = spriteFrame->isRotated();
     setTextureRect(spriteFrame->getRect(), _rectRotated, spriteFrame->getOriginalSize());
 }
@@ -1045,6 +1051,12 @@ void Sprite::setBatchNode(SpriteBatchNode *spriteBatchNode)
 
 // MARK: Texture protocol
 
+void Sprite::setBlendFunc(const BlendFunc &blendFunc)
+{
+    _blendFunc = blendFunc;
+    _director->requestRedraw();
+}
+
 void Sprite::updateBlendFunc(void)
 {
     CCASSERT(! _batchNode, "CCSprite: updateBlendFunc doesn't work when the sprite is rendered using a SpriteBatchNode");
@@ -1062,6 +1074,16 @@ void Sprite::updateBlendFunc(void)
     }
 }
 
+void Sprite::resetForReuse()
+{
+    Node::resetForReuse();
+
+    setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    setFlippedX(false);
+    setFlippedY(false);
+    updateBlendFunc();
+}
+
 std::string Sprite::getDescription() const
 {
     int texture_id = -1;
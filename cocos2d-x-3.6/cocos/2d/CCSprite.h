@@ -74,6 +74,8 @@ struct transformValues_;
 class CC_DLL Sprite : public Node, public TextureProtocol
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(Sprite)
+
      /** Sprite invalid index on the SpriteBatchNode. */
     static const int INDEX_NOT_INITIALIZED = -1;
 
@@ -393,7 +395,7 @@ public:
     *In lua: local setBlendFunc(local src, local dst).
     *@endcode
     */
-    /*inline*/ void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; }
+    virtual void setBlendFunc(const BlendFunc &blendFunc) override;
     /**
     * @js  NA
     * @lua NA
@@ -437,6 +439,10 @@ public:
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
     virtual void setOpacityModifyRGB(bool modify) override;
     virtual bool isOpacityModifyRGB() const override;
+    /** Also centers the anchor point, unflips the sprite and restores the blend function of its texture.
+     * The texture and the texture rect are kept.
+     */
+    virtual void resetForReuse() override;
     /// @}
 
 CC_CONSTRUCTOR_ACCESS:
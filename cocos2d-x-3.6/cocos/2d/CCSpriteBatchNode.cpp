@@ -246,10 +246,19 @@ void SpriteBatchNode::removeAllChildrenWithCleanup(bool doCleanup)
 //override sortAllChildren
 void SpriteBatchNode::sortAllChildren()
 {
-    if (_reorderChildDirty)
+    bool reordered = _reorderChildDirty;
+    if (_ySortChildren)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        // checked on every visit, the atlas is only updated if a child moved
+        reordered = sortNodesByY(_children) || reordered;
+    }
+    else if (reordered)
+    {
+        sortNodes(_children);
+    }
 
+    if (reordered)
+    {
         //sorted now check all children
         if (!_children.empty())
         {
@@ -169,6 +169,11 @@ TMXMapInfo::TMXMapInfo()
 TMXMapInfo::~TMXMapInfo()
 {
     CCLOGINFO("deallocing TMXMapInfo: %p", this);
+    // left by a parse which didn't reach the end of the map
+    for (size_t i = 0; i < _compressedLayers.size(); ++i)
+    {
+        free(_compressedLayers[i].data);
+    }
 }
 
 bool TMXMapInfo::parseXMLString(const std::string& xmlString)
@@ -640,24 +645,23 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
             
             if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib))
             {
-                unsigned char *deflated = nullptr;
                 Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-                
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "");
+                ssize_t tilesLength = s.width * s.height * sizeof(unsigned int);
                 
-                free(buffer);
-                buffer = nullptr;
-                
-                if (!deflated)
+                // inflated in place with the other layers when the map ends
+                layer->_tiles = reinterpret_cast<uint32_t*>(malloc(tilesLength));
+                if (!layer->_tiles)
                 {
+                    free(buffer);
                     CCLOG("cocos2d: TiledMap: inflate data error");
                     return;
                 }
                 
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
+                CompressedLayerData compressed;
+                compressed.layer = layer;
+                compressed.data = buffer;
+                compressed.length = len;
+                _compressedLayers.push_back(compressed);
             }
             else
             {
@@ -675,6 +679,7 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
     {
         // The map element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
+        inflateCompressedLayers();
     }    
     else if (elementName == "layer")
     {
@@ -697,6 +702,42 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
     }
 }
 
+void TMXMapInfo::inflateCompressedLayers()
+{
+    if (_compressedLayers.empty())
+        return;
+
+    std::vector<ZipUtils::InflateJob> jobs(_compressedLayers.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const CompressedLayerData& compressed = _compressedLayers[i];
+        Size s = compressed.layer->_layerSize;
+        jobs[i].in = compressed.data;
+        jobs[i].inLength = compressed.length;
+        jobs[i].out = reinterpret_cast<unsigned char*>(compressed.layer->_tiles);
+        jobs[i].outLength = s.width * s.height * sizeof(unsigned int);
+        jobs[i].result = -1;
+    }
+
+    // the layers are independent streams, large maps inflate them on several threads
+    ZipUtils::inflateMemoryParallel(&jobs[0], jobs.size());
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        TMXLayerInfo* layer = _compressedLayers[i].layer;
+        free(_compressedLayers[i].data);
+
+        // result is negative on error, a layer which inflates to fewer tiles than its size is as broken
+        if (jobs[i].result != jobs[i].outLength)
+        {
+            CCLOG("cocos2d: TiledMap: inflate data error, layer %s", layer->_name.c_str());
+            free(layer->_tiles);
+            layer->_tiles = nullptr;
+        }
+    }
+    _compressedLayers.clear();
+}
+
 void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
@@ -282,6 +282,15 @@ public:
 
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
+    void inflateCompressedLayers();
+
+    /** Compressed tiles of a layer, inflated with the other layers when the map element ends */
+    struct CompressedLayerData
+    {
+        TMXLayerInfo* layer;
+        unsigned char* data;
+        ssize_t length;
+    };
 
     /// map orientation
     int    _orientation;
@@ -318,6 +327,8 @@ protected:
     ValueMapIntKey _tileProperties;
     int _currentFirstGID;
     bool _recordFirstGID;
+    //! layers waiting to be inflated
+    std::vector<CompressedLayerData> _compressedLayers;
 };
 
 // end of tilemap_parallax_nodes group
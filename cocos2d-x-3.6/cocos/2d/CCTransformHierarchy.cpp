@@ -0,0 +1,180 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "2d/CCTransformHierarchy.h"
+
+#include "2d/CCNode.h"
+#include "base/CCProfiling.h"
+
+NS_CC_BEGIN
+
+TransformHierarchy::TransformHierarchy(Node* root)
+: _root(root)
+, _structureDirty(true)
+{
+    _root->_transformHierarchy = this;
+    _root->_transformIndex = 0;
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    clearSubtree(_root);
+    _root->_transformHierarchy = nullptr;
+    _root->_transformIndex = -1;
+}
+
+bool TransformHierarchy::isHierarchyRoot(Node* node)
+{
+    return node->_transformHierarchy && node->_transformHierarchy->_root == node;
+}
+
+void TransformHierarchy::clearSubtree(Node* node)
+{
+    auto& children = node->getChildren();
+    //for (auto& child : children)
+    for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
+    {
+        Node* child = *p_child;
+        if (child->_parent != node || isHierarchyRoot(child))
+            continue;
+
+        child->_transformHierarchy = nullptr;
+        child->_transformIndex = -1;
+        clearSubtree(child);
+    }
+}
+
+void TransformHierarchy::removeSubtree(Node* node)
+{
+    CCASSERT(node->_transformHierarchy == this && node != _root, "The node isn't a descendant in this hierarchy");
+
+    node->_transformHierarchy = nullptr;
+    node->_transformIndex = -1;
+    clearSubtree(node);
+    _structureDirty = true;
+}
+
+void TransformHierarchy::rebuild()
+{
+    _nodes.clear();
+    _parents.clear();
+
+    _nodes.push_back(_root);
+    _parents.push_back(0);
+
+    // Breadth first, so a parent always comes before its children
+    for (size_t i = 0; i < _nodes.size(); ++i)
+    {
+        Node* node = _nodes[i];
+        auto& children = node->getChildren();
+        //for (auto& child : children)
+        for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
+        {
+            Node* child = *p_child;
+            // Some nodes (e.g. armature bones) list children they aren't the parent of.
+            // The subtree of a nested hierarchy is updated by its own root.
+            if (child->_parent != node || isHierarchyRoot(child))
+                continue;
+
+            child->_transformHierarchy = this;
+            child->_transformIndex = (int)_nodes.size();
+            _nodes.push_back(child);
+            _parents.push_back((int)i);
+        }
+    }
+
+    size_t count = _nodes.size();
+    _locals.resize(count);
+    _worlds.resize(count);
+    _flags.assign(count, 0);
+    _structureDirty = false;
+}
+
+void TransformHierarchy::update(const Mat4& rootTransform, uint32_t rootFlags)
+{
+    CC_PROFILER_ZONE("TransformHierarchy::update");
+
+    if (_structureDirty)
+    {
+        rebuild();
+        // every node has to be computed once
+        rootFlags |= Node::FLAGS_TRANSFORM_DIRTY;
+    }
+
+    size_t count = _nodes.size();
+
+    _worlds[0] = rootTransform;
+    _flags[0] = BATCHED | UP_TO_DATE | VALID;
+    if (rootFlags & Node::FLAGS_DIRTY_MASK)
+        _flags[0] |= DIRTY;
+    if (rootFlags & Node::FLAGS_CONTENT_SIZE_DIRTY)
+        _flags[0] |= CONTENT_SIZE_DIRTY;
+
+    // Gather pass: propagates the dirty flags like processParentFlags() does and copies the
+    // local transforms of the nodes whose world transform has to be recomputed.
+    for (size_t i = 1; i < count; ++i)
+    {
+        Node* node = _nodes[i];
+        unsigned char parentFlags = _flags[_parents[i]];
+
+        bool batched = (parentFlags & BATCHED) != 0;
+#if CC_USE_PHYSICS
+        batched = batched && node->_physicsBody == nullptr;
+#endif
+        if (!batched)
+        {
+            _flags[i] = 0;
+            continue;
+        }
+
+        unsigned char flags = parentFlags & (DIRTY | CONTENT_SIZE_DIRTY);
+
+        // not computed by the last update: out of the batch, or computed by the node itself
+        if (!(_flags[i] & VALID))
+            flags |= DIRTY;
+
+        if (node->_usingNormalizedPosition)
+            node->applyNormalizedPosition((flags & CONTENT_SIZE_DIRTY) != 0);
+
+        if (node->_transformUpdated)
+            flags |= DIRTY;
+        if (node->_contentSizeDirty)
+            flags |= DIRTY | CONTENT_SIZE_DIRTY;
+
+        if (flags & DIRTY)
+            _locals[i] = node->getNodeToParentTransform();
+
+        _flags[i] = flags | BATCHED | UP_TO_DATE | VALID;
+    }
+
+    // Multiply pass: only touches the arrays
+    for (size_t i = 1; i < count; ++i)
+    {
+        if ((_flags[i] & (DIRTY | BATCHED)) == (DIRTY | BATCHED))
+        {
+            Mat4::multiply(_worlds[_parents[i]], _locals[i], &_worlds[i]);
+        }
+    }
+}
+
+NS_CC_END
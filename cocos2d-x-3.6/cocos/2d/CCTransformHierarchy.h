@@ -0,0 +1,124 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TRANSFORM_HIERARCHY_H__
+#define __CC_TRANSFORM_HIERARCHY_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/Mat4.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/** @class TransformHierarchy
+ * @brief Keeps the local and world transforms of the descendants of a node in contiguous arrays,
+ * ordered so that a parent always comes before its children.
+ *
+ * When the root node is visited, the local transforms of the dirty nodes are gathered and all
+ * the dirty world transforms are computed in a single pass over the arrays. The nodes then copy
+ * their world transform instead of multiplying it while they are visited.
+ *
+ * Nodes with a physics body, and their descendants, are not batched and keep using the regular
+ * per node update. It is created by Node::setTransformHierarchyEnabled().
+ * @js NA
+ */
+class CC_DLL TransformHierarchy
+{
+public:
+    /** Constructor of TransformHierarchy.
+     * @param root The node whose descendants are batched, it isn't retained.
+     */
+    explicit TransformHierarchy(Node* root);
+    /** Destructor of TransformHierarchy, it removes all the nodes from the hierarchy. */
+    ~TransformHierarchy();
+
+    /** Gets the node whose descendants are batched. */
+    Node* getRoot() const { return _root; }
+
+    /** Gets the number of batched nodes, the root included. The arrays are rebuilt by the next update if the structure is dirty. */
+    size_t getNodeCount() const { return _nodes.size(); }
+
+    /** Marks the structure dirty, the arrays will be rebuilt by the next update. Called when a child is added to a node of the hierarchy. */
+    void setStructureDirty() { _structureDirty = true; }
+
+    /** Removes a node and its descendants from the hierarchy. Called when the node is detached from its parent. */
+    void removeSubtree(Node* node);
+
+    /** Updates the world transforms of the dirty nodes.
+     * @param rootTransform The model view transform of the root.
+     * @param rootFlags The flags returned by processParentFlags() for the root.
+     */
+    void update(const Mat4& rootTransform, uint32_t rootFlags);
+
+    /** Whether the world transform of the node at index was computed by the last update and is still valid. */
+    bool isUpToDate(int index) const { return (_flags[index] & UP_TO_DATE) && (_flags[_parents[index]] & UP_TO_DATE); }
+
+    /** Gets the world transform of the node at index computed by the last update. */
+    const Mat4& getWorldTransform(int index) const { return _worlds[index]; }
+
+    /** Marks the world transform of the node at index as not computed by the hierarchy, its descendants won't use theirs either.
+     * The node computed its transform itself, the next update computes it again.
+     */
+    void setOutOfDate(int index) { _flags[index] &= ~(UP_TO_DATE | VALID); }
+
+protected:
+    enum
+    {
+        DIRTY = (1 << 0),
+        CONTENT_SIZE_DIRTY = (1 << 1),
+        BATCHED = (1 << 2),
+        UP_TO_DATE = (1 << 3),
+        /** _worlds holds the world transform of the node, else the next update has to compute it */
+        VALID = (1 << 4),
+    };
+
+    void rebuild();
+    /** Clears the hierarchy pointers of a node and its descendants, stops at the roots of other hierarchies. */
+    static void clearSubtree(Node* node);
+    /** Whether the node is the root of its own hierarchy. */
+    static bool isHierarchyRoot(Node* node);
+
+    Node* _root;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<Mat4> _locals;
+    std::vector<Mat4> _worlds;
+    std::vector<unsigned char> _flags;
+    bool _structureDirty;
+};
+
+NS_CC_END
+
+// end of _2d group
+/// @}
+
+#endif // __CC_TRANSFORM_HIERARCHY_H__
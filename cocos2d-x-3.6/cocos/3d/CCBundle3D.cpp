@@ -162,7 +162,7 @@ void Bundle3D::clear()
 {
     if (_isBinary)
     {
-        CC_SAFE_DELETE(_binaryBuffer);
+        CC_SAFE_RELEASE_NULL(_binaryBuffer);
         CC_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -1047,11 +1047,10 @@ bool Bundle3D::loadBinary(const std::string& path)
 {
     clear();
     
-    // get file data
-    CC_SAFE_DELETE(_binaryBuffer);
-    _binaryBuffer = new (std::nothrow) Data();
-    *_binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer->isNull())
+    // get file data, the reader reads the mapped file in place
+    CC_SAFE_RELEASE_NULL(_binaryBuffer);
+    _binaryBuffer = FileUtils::getInstance()->getMappedDataFromFile(path);
+    if (_binaryBuffer == nullptr)
     {
         clear();
         CCLOG("warning: Failed to read file: %s", path.c_str());
@@ -57,6 +57,9 @@ cocos2d.cpp \
 2d/CCMenuItem.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
+2d/CCNodePathQuery.cpp \
+2d/CCNodePool.cpp \
+2d/CCTransformHierarchy.cpp \
 2d/CCNodeGrid.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
@@ -90,6 +93,8 @@ cocos2d.cpp \
 3d/CCPlane.cpp \
 platform/CCGLView.cpp \
 platform/CCFileUtils.cpp \
+platform/CCValueFormats.cpp \
+platform/CCAsyncFileReader.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
 platform/CCImage.cpp \
@@ -108,6 +113,8 @@ base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
 base/CCData.cpp \
+base/CCMappedData.cpp \
+base/CCAssetPack.cpp \
 base/CCDataVisitor.cpp \
 base/CCDirector.cpp \
 base/CCEvent.cpp \
@@ -135,6 +142,7 @@ base/CCRef.cpp \
 base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
+base/CCTouchSpatialIndex.cpp \
 base/CCUserDefault.cpp \
 base/CCUserDefault-android.cpp \
 base/CCValue.cpp \
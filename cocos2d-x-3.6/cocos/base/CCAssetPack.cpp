@@ -0,0 +1,437 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCAssetPack.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include <algorithm>
+
+#include "base/ccMacros.h"
+#include "base/CCMappedData.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+static const char PACK_MAGIC[4] = { 'C', 'C', 'P', 'K' };
+static const uint32_t PACK_VERSION = 1;
+// entries are aligned, so the stored content can be read in place
+static const uint32_t PACK_ALIGNMENT = 16;
+// zlib can't inflate more than 1032 bytes per compressed byte
+static const uint64_t MAX_DEFLATE_RATIO = 1032;
+
+class AssetPack::Mapping
+{
+public:
+    explicit Mapping(MappedData* content)
+    : _content(content)
+    , _references(1)
+    {
+        pthread_mutex_init(&_mutex, NULL);
+    }
+
+    void retain()
+    {
+        pthread_mutex_lock(&_mutex);
+        ++_references;
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void release()
+    {
+        pthread_mutex_lock(&_mutex);
+        bool last = --_references == 0;
+        pthread_mutex_unlock(&_mutex);
+
+        if (last)
+        {
+            // the content was never handed to anybody else, it can be released on this thread
+            _content->release();
+            pthread_mutex_destroy(&_mutex);
+            delete this;
+        }
+    }
+
+    MappedData* getContent() const { return _content; }
+
+private:
+    MappedData* _content;
+    pthread_mutex_t _mutex;
+    int _references;
+};
+
+AssetPack* AssetPack::create(const std::string& filename)
+{
+    AssetPack* ret = new (std::nothrow) AssetPack();
+    if (ret && ret->initWithFile(filename))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+AssetPack::AssetPack()
+: _mapping(nullptr)
+, _bytes(nullptr)
+, _entries(nullptr)
+, _entryCount(0)
+, _names(nullptr)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    if (_mapping)
+    {
+        _mapping->release();
+    }
+}
+
+uint32_t AssetPack::hashPath(const char* path, size_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)path[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool AssetPack::initWithFile(const std::string& filename)
+{
+    CCASSERT(_mapping == nullptr, "AssetPack already initialized");
+
+    MappedData* content = FileUtils::getInstance()->getMappedDataFromFile(filename);
+    if (!content)
+        return false;
+
+    const unsigned char* bytes = content->getBytes();
+    size_t size = (size_t)content->getSize();
+
+    Header header;
+    bool valid = size >= sizeof(Header);
+    if (valid)
+    {
+        memcpy(&header, bytes, sizeof(Header));
+        valid = memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0
+            && header.version == PACK_VERSION
+            && header.indexOffset % sizeof(uint32_t) == 0
+            && header.indexOffset + (uint64_t)header.entryCount * sizeof(Entry) <= size
+            && header.namesOffset + (uint64_t)header.namesSize <= size;
+    }
+
+    const Entry* entries = valid ? (const Entry*)(bytes + header.indexOffset) : nullptr;
+    for (uint32_t i = 0; valid && i < header.entryCount; ++i)
+    {
+        const Entry& entry = entries[i];
+        // a stored entry is read in place, so its size must be its stored size, and a deflated entry
+        // can't claim more than zlib is able to inflate, getData() allocates that size up front
+        valid = entry.nameOffset + (uint64_t)entry.nameLength <= header.namesSize
+            && entry.dataOffset + (uint64_t)entry.storedSize <= size
+            && ((entry.storage == (uint32_t)Storage::STORED && entry.size == entry.storedSize)
+                || (entry.storage == (uint32_t)Storage::DEFLATED && entry.size <= (uint64_t)entry.storedSize * MAX_DEFLATE_RATIO))
+            && (i == 0 || entries[i - 1].hash <= entry.hash);
+    }
+
+    if (!valid)
+    {
+        CCLOG("cocos2d: AssetPack: %s isn't a valid asset pack.", filename.c_str());
+        content->release();
+        return false;
+    }
+
+    _mapping = new (std::nothrow) Mapping(content);
+    if (!_mapping)
+    {
+        content->release();
+        return false;
+    }
+    _bytes = bytes;
+    _entries = entries;
+    _entryCount = header.entryCount;
+    _names = (const char*)bytes + header.namesOffset;
+
+    for (ssize_t i = 0; i < _entryCount; ++i)
+    {
+        std::string name(_names + _entries[i].nameOffset, _entries[i].nameLength);
+        size_t pos = name.rfind('/');
+        while (pos != std::string::npos && pos > 0)
+        {
+            name.erase(pos);
+            if (!_directories.insert(name).second)
+                break;
+            pos = name.rfind('/');
+        }
+    }
+    return true;
+}
+
+const AssetPack::Entry* AssetPack::findEntry(const std::string& path) const
+{
+    if (!_entries)
+        return nullptr;
+
+    uint32_t hash = hashPath(path.c_str(), path.length());
+    const Entry* end = _entries + _entryCount;
+    const Entry* entry = std::lower_bound(_entries, end, hash, [](const Entry& e, uint32_t h) { return e.hash < h; });
+
+    // Different paths may have the same hash, compare the names of all of them
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        if (entry->nameLength == path.length() && memcmp(_names + entry->nameOffset, path.c_str(), path.length()) == 0)
+            return entry;
+    }
+    return nullptr;
+}
+
+bool AssetPack::hasDirectory(const std::string& path) const
+{
+    if (path.empty())
+        return _entries != nullptr;
+
+    return _directories.find(path) != _directories.end();
+}
+
+ssize_t AssetPack::getFileSize(const std::string& path) const
+{
+    const Entry* entry = findEntry(path);
+    return entry ? entry->size : -1;
+}
+
+AssetPack::Storage AssetPack::getStorage(const std::string& path) const
+{
+    const Entry* entry = findEntry(path);
+    CCASSERT(entry, "The file isn't in the pack");
+    return entry ? (Storage)entry->storage : Storage::STORED;
+}
+
+bool AssetPack::inflateEntry(const Entry* entry, unsigned char* out) const
+{
+    // uncompress() writes at most outSize bytes and fails with Z_BUF_ERROR if the data inflates to more
+    uLongf outSize = entry->size;
+    int err = ::uncompress(out, &outSize, _bytes + entry->dataOffset, entry->storedSize);
+    if (err != Z_OK || outSize != entry->size)
+    {
+        CCLOG("cocos2d: AssetPack: Failed to uncompress %s, error %d.", std::string(_names + entry->nameOffset, entry->nameLength).c_str(), err);
+        return false;
+    }
+    return true;
+}
+
+Data AssetPack::getData(const std::string& path) const
+{
+    Data ret;
+    const Entry* entry = findEntry(path);
+    if (!entry)
+        return ret;
+
+    if (entry->storage == (uint32_t)Storage::STORED)
+    {
+        ret.copy(_bytes + entry->dataOffset, entry->size);
+        return ret;
+    }
+
+    unsigned char* buffer = (unsigned char*)malloc(entry->size);
+    if (buffer && inflateEntry(entry, buffer))
+    {
+        ret.fastSet(buffer, entry->size);
+    }
+    else
+    {
+        free(buffer);
+    }
+    return ret;
+}
+
+MappedData* AssetPack::getMappedData(const std::string& path)
+{
+    const Entry* entry = findEntry(path);
+    if (!entry)
+        return nullptr;
+
+    MappedData* ret = new (std::nothrow) MappedData();
+    if (!ret)
+        return nullptr;
+
+    if (entry->storage == (uint32_t)Storage::STORED)
+    {
+        Mapping* mapping = _mapping;
+        mapping->retain();
+        ret->initWithBytes(_bytes + entry->dataOffset, entry->size, [mapping]() { mapping->release(); });
+        return ret;
+    }
+
+    Data data = getData(path);
+    if (!ret->initWithData(data))
+    {
+        CC_SAFE_RELEASE_NULL(ret);
+    }
+    return ret;
+}
+
+std::vector<std::string> AssetPack::getFiles() const
+{
+    std::vector<std::string> files;
+    files.reserve(_entryCount);
+    for (ssize_t i = 0; i < _entryCount; ++i)
+    {
+        files.push_back(std::string(_names + _entries[i].nameOffset, _entries[i].nameLength));
+    }
+    return files;
+}
+
+static bool isCompressedAlready(const std::string& path)
+{
+    static const char* extensions[] = { ".png", ".jpg", ".jpeg", ".webp", ".pkm", ".ccz", ".gz", ".zip", ".ogg", ".mp3", ".m4a", ".mp4", ".ccpk" };
+
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); ++i)
+    {
+        size_t length = strlen(extensions[i]);
+        if (lower.length() >= length && lower.compare(lower.length() - length, length, extensions[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool writePadding(FILE* fp, uint64_t* offset)
+{
+    static const char zeros[PACK_ALIGNMENT] = { 0 };
+    size_t padding = (size_t)((PACK_ALIGNMENT - *offset % PACK_ALIGNMENT) % PACK_ALIGNMENT);
+    *offset += padding;
+    return fwrite(zeros, 1, padding, fp) == padding;
+}
+
+bool AssetPack::build(const std::string& sourceDir, const std::vector<std::string>& files, const std::string& packPath,
+                      const std::function<bool(const std::string&)>& shouldCompress)
+{
+    std::string root = sourceDir;
+    if (!root.empty() && root[root.length() - 1] != '/')
+        root += '/';
+
+    std::vector<std::pair<uint32_t, std::string>> sorted;
+    sorted.reserve(files.size());
+    //for (const auto& file : files)
+    for (auto p_file = files.begin(); p_file != files.end(); ++p_file)
+    {
+        sorted.push_back(std::make_pair(hashPath(p_file->c_str(), p_file->length()), *p_file));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    Header header;
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.entryCount = (uint32_t)sorted.size();
+    header.indexOffset = sizeof(Header);
+    header.namesOffset = header.indexOffset + header.entryCount * sizeof(Entry);
+    header.reserved[0] = header.reserved[1] = 0;
+
+    std::string names;
+    std::vector<Entry> entries(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        Entry& entry = entries[i];
+        memset(&entry, 0, sizeof(Entry));
+        entry.hash = sorted[i].first;
+        entry.nameOffset = (uint32_t)names.length();
+        entry.nameLength = (uint32_t)sorted[i].second.length();
+        names += sorted[i].second;
+    }
+    header.namesSize = (uint32_t)names.length();
+
+    FILE* fp = fopen(packPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: AssetPack: Can't open %s.", packPath.c_str());
+        return false;
+    }
+
+    uint64_t offset = header.namesOffset + (uint64_t)header.namesSize;
+    bool ok = fwrite(&header, sizeof(Header), 1, fp) == 1
+        && (entries.empty() || fwrite(&entries[0], sizeof(Entry), entries.size(), fp) == entries.size())
+        && fwrite(names.c_str(), 1, names.length(), fp) == names.length()
+        && writePadding(fp, &offset);
+
+    std::vector<unsigned char> compressed;
+    for (size_t i = 0; ok && i < sorted.size(); ++i)
+    {
+        const std::string& path = sorted[i].second;
+        Data data = FileUtils::getInstance()->getDataFromFile(root + path);
+        if (data.isNull() && !FileUtils::getInstance()->isFileExist(root + path))
+        {
+            CCLOG("cocos2d: AssetPack: Can't read %s%s.", root.c_str(), path.c_str());
+            ok = false;
+            break;
+        }
+
+        Entry& entry = entries[i];
+        entry.size = (uint32_t)data.getSize();
+        entry.storage = (uint32_t)Storage::STORED;
+
+        const unsigned char* bytes = data.getBytes();
+        uLongf storedSize = entry.size;
+        bool compress = shouldCompress ? shouldCompress(path) : !isCompressedAlready(path);
+        if (compress && entry.size > 0)
+        {
+            uLongf bound = compressBound(entry.size);
+            compressed.resize(bound);
+            if (compress2(&compressed[0], &bound, bytes, entry.size, Z_BEST_COMPRESSION) == Z_OK && bound < entry.size)
+            {
+                entry.storage = (uint32_t)Storage::DEFLATED;
+                bytes = &compressed[0];
+                storedSize = bound;
+            }
+        }
+
+        entry.dataOffset = (uint32_t)offset;
+        entry.storedSize = (uint32_t)storedSize;
+        offset += storedSize;
+        // the offsets are 32 bits
+        ok = offset <= 0xffffffffu
+            && fwrite(bytes, 1, storedSize, fp) == storedSize
+            && writePadding(fp, &offset);
+    }
+
+    // the index is written once the offsets are known
+    ok = ok && fseek(fp, header.indexOffset, SEEK_SET) == 0
+        && (entries.empty() || fwrite(&entries[0], sizeof(Entry), entries.size(), fp) == entries.size());
+
+    ok = fclose(fp) == 0 && ok;
+    if (!ok)
+    {
+        CCLOG("cocos2d: AssetPack: Failed to write %s.", packPath.c_str());
+        remove(packPath.c_str());
+    }
+    return ok;
+}
+
+NS_CC_END
@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_ASSET_PACK_H__
+#define __CC_ASSET_PACK_H__
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class MappedData;
+
+/** @class AssetPack
+ * @brief A read only archive of assets, memory mapped and looked up through a sorted hash index.
+ *
+ * Unlike a zip archive, the pack has no central directory to parse: the index is used in place, and
+ * a file is found with a binary search on the hash of its path. Each entry is either stored, and then
+ * read straight from the mapping without any copy, or compressed with zlib, which suits the data that
+ * isn't compressed already (plists, json, shaders, fonts...). Entries are 16 bytes aligned.
+ *
+ * A pack is usually mounted with FileUtils::mountAssetPack(), its files are then found like the
+ * files of a search path. Packs are made on the desktop with AssetPack::build(), e.g.:
+ *
+ * @code
+ * auto fileUtils = FileUtils::getInstance();
+ * fileUtils->buildAssetIndex(sourceDir);
+ * AssetPack::build(sourceDir, fileUtils->getAssetIndexFiles(sourceDir), packPath);
+ * @endcode
+ *
+ * @note On Android, keep the pack uncompressed in the APK (e.g. `aapt -0 ccpk`), otherwise the
+ *       whole pack is inflated into memory when it is mounted.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AssetPack : public Ref
+{
+public:
+    /** How an entry is stored in the pack. */
+    enum class Storage
+    {
+        STORED = 0,
+        DEFLATED = 1
+    };
+
+    /** Creates a pack from a file, searched like any other file. The pack is autoreleased. */
+    static AssetPack* create(const std::string& filename);
+
+    /**
+     * Writes a pack with the given files.
+     * @param sourceDir The directory the files are relative to.
+     * @param files The paths of the files, relative to sourceDir, using '/' as separator.
+     * @param packPath The full path of the pack to write.
+     * @param shouldCompress Tells whether a file is worth compressing. If null, all the files are compressed
+     *        except the ones already compressed (png, jpg, webp, pkm, pvr.ccz, ogg, mp3...). A compressed
+     *        entry which doesn't get smaller is stored anyway.
+     * @return True if the pack was written, false if not.
+     */
+    static bool build(const std::string& sourceDir, const std::vector<std::string>& files, const std::string& packPath,
+                      const std::function<bool(const std::string&)>& shouldCompress = nullptr);
+
+    AssetPack();
+    virtual ~AssetPack();
+
+    /** Maps a pack, searched like any other file.
+     * @return False if the file can't be loaded or isn't a valid pack.
+     */
+    bool initWithFile(const std::string& filename);
+
+    /** Checks whether the pack has a file, given by its path relative to the root of the pack. */
+    bool hasFile(const std::string& path) const { return findEntry(path) != nullptr; }
+
+    /** Checks whether the pack has files in a directory, given without the trailing '/'. */
+    bool hasDirectory(const std::string& path) const;
+
+    /** Gets the size of a file once uncompressed, -1 if the pack doesn't have it. */
+    ssize_t getFileSize(const std::string& path) const;
+
+    /** Gets the storage of a file, which must be in the pack. */
+    Storage getStorage(const std::string& path) const;
+
+    /** Reads a file, uncompressing it when needed. Returns Data::Null if the pack doesn't have it. */
+    Data getData(const std::string& path) const;
+
+    /** Gets a read only view of a file, which isn't autoreleased: the caller releases it.
+     * Stored entries aren't copied, the view keeps the mapping of the pack alive. Can be called on any thread.
+     * @return nullptr if the pack doesn't have the file.
+     */
+    MappedData* getMappedData(const std::string& path);
+
+    /** Gets the paths of all the files in the pack. */
+    std::vector<std::string> getFiles() const;
+
+    /** Gets the number of files in the pack. */
+    ssize_t getFileCount() const { return _entryCount; }
+
+protected:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t indexOffset;
+        uint32_t namesOffset;
+        uint32_t namesSize;
+        uint32_t reserved[2];
+    };
+
+    /** Sorted by hash, then by name */
+    struct Entry
+    {
+        uint32_t hash;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t storage;
+        uint32_t dataOffset;
+        uint32_t storedSize;
+        uint32_t size;
+        uint32_t reserved;
+    };
+
+    /** The mapped content, shared with the views of the stored entries, which may be released on any thread */
+    class Mapping;
+
+    static uint32_t hashPath(const char* path, size_t length);
+
+    const Entry* findEntry(const std::string& path) const;
+    bool inflateEntry(const Entry* entry, unsigned char* out) const;
+
+    Mapping* _mapping;
+    const unsigned char* _bytes;
+    const Entry* _entries;
+    ssize_t _entryCount;
+    const char* _names;
+    std::unordered_set<std::string> _directories;
+};
+
+NS_CC_END
+/**
+ end of base group
+ @}
+ */
+#endif // __CC_ASSET_PACK_H__
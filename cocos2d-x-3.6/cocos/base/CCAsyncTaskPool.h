@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCProfiling.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -117,6 +118,7 @@ protected:
 		}
 		void loadData()
 		{
+            CC_PROFILER_THREAD_NAME("AsyncTaskPool");
 			for(;;)
             {
                 std::function<void()> task;
@@ -138,8 +140,11 @@ protected:
                     this->_taskCallBacks.pop();
 					pthread_mutex_unlock(&this->_queueMutex);
 				}                    
-                task();
-                Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
+                {
+                    CC_PROFILER_ZONE("AsyncTaskPool::task");
+                    task();
+                }
+                Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
             }
 		}
         ~ThreadTasks()
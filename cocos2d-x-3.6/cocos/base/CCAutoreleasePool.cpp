@@ -23,27 +23,33 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
+#include <algorithm>
+#include <typeinfo>
 #include "base/ccMacros.h"
 
 NS_CC_BEGIN
 
 AutoreleasePool::AutoreleasePool()
-: _name("")
+: _cursor(nullptr)
+, _chunkEnd(nullptr)
+, _reservedChunks(1)
+, _name("")
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
 {
-    _managedObjectArray.reserve(150);
     PoolManager::getInstance()->push(this);
 }
 
 AutoreleasePool::AutoreleasePool(const std::string &name)
-: _name(name)
+: _cursor(nullptr)
+, _chunkEnd(nullptr)
+, _reservedChunks(1)
+, _name(name)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
 {
-    _managedObjectArray.reserve(150);
     PoolManager::getInstance()->push(this);
 }
 
@@ -51,13 +57,40 @@ AutoreleasePool::~AutoreleasePool()
 {
     CCLOGINFO("deallocing AutoreleasePool: %p", this);
     clear();
+
+    //for (const auto &chunk : _freeChunks)
+    for (auto p_chunk = _freeChunks.begin(); p_chunk != _freeChunks.end(); ++p_chunk)
+    {
+        delete [] *p_chunk;
+    }
     
     PoolManager::getInstance()->pop();
 }
 
-void AutoreleasePool::addObject(Ref* object)
+void AutoreleasePool::addChunk()
+{
+    Ref** chunk = nullptr;
+    if (_freeChunks.empty())
+    {
+        chunk = new Ref*[CHUNK_CAPACITY];
+    }
+    else
+    {
+        chunk = _freeChunks.back();
+        _freeChunks.pop_back();
+    }
+
+    _chunks.push_back(chunk);
+    _cursor = chunk;
+    _chunkEnd = chunk + CHUNK_CAPACITY;
+}
+
+size_t AutoreleasePool::getObjectCount() const
 {
-    _managedObjectArray.push_back(object);
+    if (_chunks.empty())
+        return 0;
+
+    return (_chunks.size() - 1) * CHUNK_CAPACITY + (_cursor - _chunks.back());
 }
 
 void AutoreleasePool::clear()
@@ -65,13 +98,57 @@ void AutoreleasePool::clear()
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = true;
 #endif
-    std::vector<Ref*> releasings;
-    releasings.swap(_managedObjectArray);
-    //for (const auto &obj : releasings)
-    for (auto p_obj = releasings.begin(); p_obj != releasings.end(); ++p_obj)
-	{
-		const auto& obj = *p_obj;
-        obj->release();
+    // the objects autoreleased while releasing go to other chunks, they are released by the next clear
+    std::vector<Ref**> releasings;
+    releasings.swap(_chunks);
+    Ref** lastEnd = _cursor;
+    _cursor = _chunkEnd = nullptr;
+
+    bool diagnostics = PoolManager::isDiagnosticsEnabled();
+    size_t chunkCount = releasings.size();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        Ref** chunk = releasings[i];
+        Ref** end = (i + 1 == chunkCount) ? lastEnd : chunk + CHUNK_CAPACITY;
+        for (Ref** p_obj = chunk; p_obj != end; ++p_obj)
+        {
+            Ref* obj = *p_obj;
+            if (diagnostics && obj->getReferenceCount() > 1)
+            {
+                PoolManager::getInstance()->objectSurvived(obj);
+            }
+            obj->release();
+        }
+    }
+
+    // learn how many chunks the frames need, the reserve shrinks slowly after a peak
+    if (chunkCount >= _reservedChunks)
+    {
+        _reservedChunks = chunkCount;
+    }
+    else
+    {
+        _reservedChunks -= (_reservedChunks - chunkCount + 7) / 8;
+    }
+
+    _freeChunks.insert(_freeChunks.end(), releasings.begin(), releasings.end());
+    size_t reserved = MAX(_reservedChunks, 1);
+    while (!_freeChunks.empty() && _freeChunks.size() + _chunks.size() > reserved)
+    {
+        delete [] _freeChunks.back();
+        _freeChunks.pop_back();
+    }
+
+    // keep the capacity of the chunk list
+    if (_chunks.empty())
+    {
+        releasings.clear();
+        _chunks.swap(releasings);
+    }
+
+    if (diagnostics)
+    {
+        PoolManager::getInstance()->poolCleared(this);
     }
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
@@ -80,26 +157,35 @@ void AutoreleasePool::clear()
 
 bool AutoreleasePool::contains(Ref* object) const
 {
-    //for (const auto& obj : _managedObjectArray)
-    for (auto p_obj = _managedObjectArray.begin(); p_obj != _managedObjectArray.end(); ++p_obj)
-	{
-		const auto& obj = *p_obj;
-        if (obj == object)
-            return true;
+    size_t chunkCount = _chunks.size();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        Ref** chunk = _chunks[i];
+        Ref** end = (i + 1 == chunkCount) ? _cursor : chunk + CHUNK_CAPACITY;
+        for (Ref** p_obj = chunk; p_obj != end; ++p_obj)
+        {
+            if (*p_obj == object)
+                return true;
+        }
     }
     return false;
 }
 
 void AutoreleasePool::dump()
 {
-    CCLOG("autorelease pool: %s, number of managed object %d\n", _name.c_str(), static_cast<int>(_managedObjectArray.size()));
+    CCLOG("autorelease pool: %s, number of managed object %d\n", _name.c_str(), static_cast<int>(getObjectCount()));
     CCLOG("%20s%20s%20s", "Object pointer", "Object id", "reference count");
-    //for (const auto &obj : _managedObjectArray)
-    for (auto p_obj = _managedObjectArray.begin(); p_obj != _managedObjectArray.end(); ++p_obj)
-	{
-		const auto& obj = *p_obj;
-        CC_UNUSED_PARAM(obj);
-        CCLOG("%20p%20u\n", obj, obj->getReferenceCount());
+    size_t chunkCount = _chunks.size();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        Ref** chunk = _chunks[i];
+        Ref** end = (i + 1 == chunkCount) ? _cursor : chunk + CHUNK_CAPACITY;
+        for (Ref** p_obj = chunk; p_obj != end; ++p_obj)
+        {
+            Ref* obj = *p_obj;
+            CC_UNUSED_PARAM(obj);
+            CCLOG("%20p%20u\n", obj, obj->getReferenceCount());
+        }
     }
 }
 
@@ -111,6 +197,7 @@ void AutoreleasePool::dump()
 //--------------------------------------------------------------------
 
 PoolManager* PoolManager::s_singleInstance = nullptr;
+std::atomic<bool> PoolManager::s_diagnosticsEnabled(false);
 
 PoolManager* PoolManager::getInstance()
 {
@@ -130,8 +217,10 @@ void PoolManager::destroyInstance()
 }
 
 PoolManager::PoolManager()
+: _frame(0)
 {
     _releasePoolStack.reserve(10);
+    pthread_mutex_init(&_diagnosticsMutex, nullptr);
 }
 
 PoolManager::~PoolManager()
@@ -144,6 +233,9 @@ PoolManager::~PoolManager()
         
         delete pool;
     }
+
+    s_diagnosticsEnabled = false;
+    pthread_mutex_destroy(&_diagnosticsMutex);
 }
 
 
@@ -175,4 +267,112 @@ void PoolManager::pop()
     _releasePoolStack.pop_back();
 }
 
+void PoolManager::setDiagnosticsEnabled(bool enabled)
+{
+    pthread_mutex_lock(&_diagnosticsMutex);
+    s_diagnosticsEnabled = enabled;
+    if (!enabled)
+    {
+        _frameCounts.clear();
+        _lastFrameCounts.clear();
+        _survivors.clear();
+    }
+    pthread_mutex_unlock(&_diagnosticsMutex);
+}
+
+std::unordered_map<std::string, unsigned int> PoolManager::getLastFrameCounts() const
+{
+    pthread_mutex_lock(&_diagnosticsMutex);
+    std::unordered_map<std::string, unsigned int> counts(_lastFrameCounts);
+    pthread_mutex_unlock(&_diagnosticsMutex);
+    return counts;
+}
+
+void PoolManager::objectAutoreleased(Ref* obj)
+{
+    const char* name = typeid(*obj).name();
+    pthread_mutex_lock(&_diagnosticsMutex);
+    ++_frameCounts[name];
+    pthread_mutex_unlock(&_diagnosticsMutex);
+}
+
+void PoolManager::objectSurvived(Ref* obj)
+{
+    pthread_mutex_lock(&_diagnosticsMutex);
+    // keeps the frame it first outlived
+    _survivors.insert(std::make_pair(obj, _frame));
+    pthread_mutex_unlock(&_diagnosticsMutex);
+}
+
+void PoolManager::objectDeleted(Ref* obj)
+{
+    pthread_mutex_lock(&_diagnosticsMutex);
+    _survivors.erase(obj);
+    pthread_mutex_unlock(&_diagnosticsMutex);
+}
+
+void PoolManager::poolCleared(AutoreleasePool* pool)
+{
+    // the engine's pool is cleared once per frame
+    if (_releasePoolStack.empty() || pool != _releasePoolStack.front())
+        return;
+
+    pthread_mutex_lock(&_diagnosticsMutex);
+    _lastFrameCounts.clear();
+    //for (const auto& count : _frameCounts)
+    for (auto p_count = _frameCounts.begin(); p_count != _frameCounts.end(); ++p_count)
+    {
+        _lastFrameCounts[p_count->first] += p_count->second;
+    }
+    _frameCounts.clear();
+    ++_frame;
+    pthread_mutex_unlock(&_diagnosticsMutex);
+}
+
+static bool countGreater(const std::pair<std::string, unsigned int>& a, const std::pair<std::string, unsigned int>& b)
+{
+    return a.second > b.second;
+}
+
+static void dumpCounts(const std::unordered_map<std::string, unsigned int>& counts)
+{
+    std::vector<std::pair<std::string, unsigned int> > sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), countGreater);
+
+    //for (const auto& count : sorted)
+    for (auto p_count = sorted.begin(); p_count != sorted.end(); ++p_count)
+    {
+        CCLOG("%10u  %s", p_count->second, p_count->first.c_str());
+    }
+}
+
+void PoolManager::dumpLastFrameCounts() const
+{
+    pthread_mutex_lock(&_diagnosticsMutex);
+    std::unordered_map<std::string, unsigned int> counts(_lastFrameCounts);
+    unsigned int frame = _frame;
+    pthread_mutex_unlock(&_diagnosticsMutex);
+
+    CCLOG("autoreleased objects during frame %u, by class:", frame);
+    dumpCounts(counts);
+}
+
+void PoolManager::dumpLongLivedObjects(unsigned int minFrames) const
+{
+    std::unordered_map<std::string, unsigned int> counts;
+    pthread_mutex_lock(&_diagnosticsMutex);
+    //for (const auto& survivor : _survivors)
+    for (auto p_survivor = _survivors.begin(); p_survivor != _survivors.end(); ++p_survivor)
+    {
+        if (_frame - p_survivor->second >= minFrames)
+        {
+            ++counts[typeid(*p_survivor->first).name()];
+        }
+    }
+    pthread_mutex_unlock(&_diagnosticsMutex);
+
+    CCLOG("autoreleased objects alive for %u frames or more, by class:", minFrames);
+    dumpCounts(counts);
+}
+
 NS_CC_END
@@ -27,6 +27,9 @@ THE SOFTWARE.
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <atomic>
+#include <pthread.h>
 #include "base/CCRef.h"
 
 /**
@@ -111,6 +114,13 @@ public:
      */
     bool contains(Ref* object) const;
 
+    /**
+     * Returns the number of objects in the autorelease pool.
+     * @js NA
+     * @lua NA
+     */
+    size_t getObjectCount() const;
+
     /**
      * Dump the objects that are put into the autorelease pool. It is used for debugging.
      *
@@ -123,16 +133,27 @@ public:
     void dump();
     
 private:
+    /** The number of objects in a chunk */
+    static const size_t CHUNK_CAPACITY = 256;
+
+    void addChunk();
+
     /**
-     * The underlying array of object managed by the pool.
+     * The objects managed by the pool, in fixed size chunks which are reused from a frame to another,
+     * so adding an object never moves the objects already added.
      *
-     * Although Array retains the object once when an object is added, proper
-     * Ref::release() is called outside the array to make sure that the pool
-     * does not affect the managed object's reference count. So an object can
-     * be destructed properly by calling Ref::release() even if the object
+     * The pool doesn't retain the objects, proper Ref::release() is called when the pool is
+     * cleared. So an object can be destructed properly by calling Ref::release() even if the object
      * is in the pool.
      */
-    std::vector<Ref*> _managedObjectArray;
+    std::vector<Ref**> _chunks;
+    /** Where the next object is added in the last chunk, and the end of that chunk */
+    Ref** _cursor;
+    Ref** _chunkEnd;
+    /** Chunks kept for the next frames */
+    std::vector<Ref**> _freeChunks;
+    /** Chunks needed by the last frames, the extra free chunks are deleted */
+    size_t _reservedChunks;
     std::string _name;
     
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
@@ -167,6 +188,29 @@ public:
 
     bool isObjectInPools(Ref* obj) const;
 
+    /**
+     * Enables or disables the diagnostics, which count the autoreleased objects by class and track the ones
+     * which outlive the frame they were autoreleased in. They slow autorelease() down, don't ship them enabled.
+     * The Refs released on other threads, e.g. by the texture loading thread, are tracked too, the diagnostics are locked.
+     */
+    void setDiagnosticsEnabled(bool enabled);
+    static bool isDiagnosticsEnabled() { return s_diagnosticsEnabled.load(std::memory_order_relaxed); }
+
+    /** Gets the number of objects autoreleased during the last frame, by class name. Empty if the diagnostics aren't enabled. */
+    std::unordered_map<std::string, unsigned int> getLastFrameCounts() const;
+
+    /** Logs the number of objects autoreleased during the last frame, by class. */
+    void dumpLastFrameCounts() const;
+
+    /**
+     * Logs, by class, the objects autoreleased since the diagnostics were enabled which are still alive
+     * minFrames frames after being autoreleased. A count which keeps growing from a dump to another points to a
+     * leak, e.g. an object retained and never released.
+     */
+    void dumpLongLivedObjects(unsigned int minFrames) const;
+
+    /** Called by the destructor of Ref while the diagnostics are enabled, on the thread which deletes it. */
+    void objectDeleted(Ref* obj);
 
     friend class AutoreleasePool;
     
@@ -176,15 +220,45 @@ private:
     
     void push(AutoreleasePool *pool);
     void pop();
+
+    // diagnostics
+    void objectAutoreleased(Ref* obj);
+    void objectSurvived(Ref* obj);
+    void poolCleared(AutoreleasePool* pool);
     
     static PoolManager* s_singleInstance;
+    /** read by the destructor of Ref on any thread */
+    static std::atomic<bool> s_diagnosticsEnabled;
     
     std::vector<AutoreleasePool*> _releasePoolStack;
+
+    /** The frames, counted by the clears of the engine's pool */
+    unsigned int _frame;
+    /** guards the counts and the survivors, the Refs can be deleted on any thread */
+    mutable pthread_mutex_t _diagnosticsMutex;
+    std::unordered_map<const char*, unsigned int> _frameCounts;
+    std::unordered_map<std::string, unsigned int> _lastFrameCounts;
+    /** The autoreleased objects which outlived their frame, with the frame they were autoreleased in */
+    std::unordered_map<Ref*, unsigned int> _survivors;
 };
 /**
  * @endcond
  */
 
+inline void AutoreleasePool::addObject(Ref *object)
+{
+    if (_cursor == _chunkEnd)
+    {
+        addChunk();
+    }
+    *_cursor++ = object;
+
+    if (PoolManager::isDiagnosticsEnabled())
+    {
+        PoolManager::getInstance()->objectAutoreleased(object);
+    }
+}
+
 NS_CC_END
 
 #endif //__AUTORELEASEPOOL_H__
@@ -141,20 +141,21 @@ static void sendPrompt(int fd)
     send(fd, prompt, strlen(prompt),0);
 }
 
-static int printSceneGraph(int fd, Node* node, int level)
+static int printSceneGraph(int fd, Node* node, int level, size_t* extraDataMemory)
 {
     int total = 1;
     for(int i=0; i<level; ++i)
         send(fd, "-", 1,0);
 
     mydprintf(fd, " %s\n", node->getDescription().c_str());
+    *extraDataMemory += node->getExtraDataMemory();
 
     //for(const auto& child: node->getChildren())
 	auto& children = node->getChildren();
 	for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
 	{
 		const auto& child = *p_child;
-        total += printSceneGraph(fd, child, level+1);
+        total += printSceneGraph(fd, child, level+1, extraDataMemory);
 	}
 
     return total;
@@ -164,8 +165,13 @@ static void printSceneGraphBoot(int fd)
 {
     send(fd,"\n",1,0);
     auto scene = Director::getInstance()->getRunningScene();
-    int total = printSceneGraph(fd, scene, 0);
+    size_t extraDataMemory = 0;
+    int total = printSceneGraph(fd, scene, 0, &extraDataMemory);
     mydprintf(fd, "Total Nodes: %d\n", total);
+    // subclasses are bigger than Node, so this is the lower bound of the memory used by the nodes
+    mydprintf(fd, "Node memory: %d x %d bytes + %d bytes of extra data (%.1f bytes per node)\n",
+              total, (int)sizeof(Node), (int)extraDataMemory,
+              sizeof(Node) + (double)extraDataMemory / total);
     sendPrompt(fd);
 }
 
@@ -516,6 +522,7 @@ Console::Console()
 , _endThread(false)
 , _sendDebugStrings(false)
 , _bindAddress("")
+, _perfStreaming(false)
 {
     // VS2012 doesn't support initializer list, so we create a new array and assign its elements to '_command'.
 	Command commands[] = {     
@@ -534,6 +541,7 @@ Console::Console()
         { "touch", "simulate touch event via console, type -h or [touch help] to list supported directives", std::bind(&Console::commandTouch, this, std::placeholders::_1, std::placeholders::_2) },
         { "upload", "upload file. Args: [filename base64_encoded_data]", std::bind(&Console::commandUpload, this, std::placeholders::_1) },
         { "version", "print version string ", std::bind(&Console::commandVersion, this, std::placeholders::_1, std::placeholders::_2) },
+        { "perf", "Stream per frame performance metrics, type -h or [perf help] to list supported directives", std::bind(&Console::commandPerf, this, std::placeholders::_1, std::placeholders::_2) },
     };
 
      ;
@@ -543,6 +551,7 @@ Console::Console()
 	}
 	_writablePath = FileUtils::getInstance()->getWritablePath();
 	pthread_mutex_init(&_DebugStringsMutex, NULL);
+	pthread_mutex_init(&_perfMutex, NULL);
 }
 
 void Console::commandDebugmsg(int fd, const std::string& args)
@@ -734,6 +743,7 @@ void Console::commandHelp(int fd, const std::string &args)
 
 void Console::commandExit(int fd, const std::string &args)
 {
+    removePerfClient(fd);
     FD_CLR(fd, &_read_set);
     _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -745,13 +755,13 @@ void Console::commandExit(int fd, const std::string &args)
 
 void Console::commandSceneGraph(int fd, const std::string &args)
 {
-    Scheduler *sched = Director::getInstance()->getScheduler();
+    Scheduler *sched = Director::getMainInstance()->getScheduler();
     sched->performFunctionInCocosThread( std::bind(&printSceneGraphBoot, fd) );
 }
 
 void Console::commandFileUtils(int fd, const std::string &args)
 {
-    Scheduler *sched = Director::getInstance()->getScheduler();
+    Scheduler *sched = Director::getMainInstance()->getScheduler();
 
     if( args.compare("flush") == 0 )
     {
@@ -769,7 +779,7 @@ void Console::commandFileUtils(int fd, const std::string &args)
 
 void Console::commandConfig(int fd, const std::string& args)
 {
-    Scheduler *sched = Director::getInstance()->getScheduler();
+    Scheduler *sched = Director::getMainInstance()->getScheduler();
     sched->performFunctionInCocosThread( [=](){
         mydprintf(fd, "%s", Configuration::getInstance()->getInfo().c_str());
         sendPrompt(fd);
@@ -810,7 +820,7 @@ void Console::commandResolution(int fd, const std::string& args)
         std::istringstream stream( args );
         stream >> width >> height>> policy;
 
-        Scheduler *sched = Director::getInstance()->getScheduler();
+        Scheduler *sched = Director::getMainInstance()->getScheduler();
         sched->performFunctionInCocosThread( [=](){
             Director::getInstance()->getOpenGLView()->setDesignResolutionSize(width, height, static_cast<ResolutionPolicy>(policy));
         } );
@@ -863,7 +873,7 @@ void Console::commandProjection(int fd, const std::string& args)
 
 void Console::commandTextures(int fd, const std::string& args)
 {
-    Scheduler *sched = Director::getInstance()->getScheduler();
+    Scheduler *sched = Director::getMainInstance()->getScheduler();
 
     if( args.compare("flush")== 0)
     {
@@ -960,7 +970,7 @@ void Console::commandTouch(int fd, const std::string& args)
 
                 srand ((unsigned)time(nullptr));
                 _touchId = rand();
-                Scheduler *sched = Director::getInstance()->getScheduler();
+                Scheduler *sched = Director::getMainInstance()->getScheduler();
                 sched->performFunctionInCocosThread( [&](){
                     Director::getInstance()->getOpenGLView()->handleTouchesBegin(1, &_touchId, &x, &y);
                     Director::getInstance()->getOpenGLView()->handleTouchesEnd(1, &_touchId, &x, &y);
@@ -989,7 +999,7 @@ void Console::commandTouch(int fd, const std::string& args)
                 srand ((unsigned)time(nullptr));
                 _touchId = rand();
 
-                Scheduler *sched = Director::getInstance()->getScheduler();
+                Scheduler *sched = Director::getMainInstance()->getScheduler();
                 sched->performFunctionInCocosThread( [=](){
                     float tempx = x1, tempy = y1;
                     Director::getInstance()->getOpenGLView()->handleTouchesBegin(1, &_touchId, &tempx, &tempy);
@@ -1083,6 +1093,150 @@ void Console::commandAllocator(int fd, const std::string& args)
 #endif
 }
 
+// Samples queued while the console thread doesn't keep up are dropped beyond this
+static const size_t MAX_QUEUED_PERF_SAMPLES = 600;
+static const unsigned int PERF_SAMPLE_MAGIC = 0x50455246; // "PERF"
+
+void Console::commandPerf(int fd, const std::string& args)
+{
+    auto argv = split(args, ' ');
+
+    if(argv.empty() || argv[0] == "help" || argv[0] == "-h")
+    {
+        const char help[] = "available perf directives:\n"
+                            "\tstream [text | binary] [interval], push the metrics of every 'interval' frames (1 by default) to this connection\n"
+                            "\tstop, stop streaming to this connection\n"
+                            "text lines: frame frame_us update_us visit_us render_us draw_calls vertices texture_kb autoreleased\n"
+                            "binary records: the same fields after the magic 0x50455246, 10 uint32 in network byte order\n";
+        send(fd, help, sizeof(help) - 1, 0);
+    }
+    else if(argv[0] == "stream")
+    {
+        PerfClient client;
+        client.fd = fd;
+        client.binary = (argv.size() > 1 && argv[1] == "binary");
+        client.interval = 1;
+        if(argv.size() > 2)
+        {
+            int interval = atoi(argv[2].c_str());
+            if(interval > 0)
+                client.interval = interval;
+        }
+
+        if(!client.binary)
+        {
+            const char header[] = "# frame frame_us update_us visit_us render_us draw_calls vertices texture_kb autoreleased\n";
+            send(fd, header, sizeof(header) - 1, 0);
+        }
+
+        removePerfClient(fd);
+        pthread_mutex_lock(&_perfMutex);
+        _perfClients.push_back(client);
+        _perfStreaming = true;
+        pthread_mutex_unlock(&_perfMutex);
+    }
+    else if(argv[0] == "stop")
+    {
+        removePerfClient(fd);
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'stream', 'stop' or 'help'\n", args.c_str());
+    }
+}
+
+void Console::removePerfClient(int fd)
+{
+    pthread_mutex_lock(&_perfMutex);
+    for (auto iter = _perfClients.begin(); iter != _perfClients.end(); ++iter)
+    {
+        if (iter->fd == fd)
+        {
+            _perfClients.erase(iter);
+            break;
+        }
+    }
+    _perfStreaming = !_perfClients.empty();
+    if (!_perfStreaming)
+        _perfSamples.clear();
+    pthread_mutex_unlock(&_perfMutex);
+}
+
+void Console::pushPerfSample(const PerfSample& sample)
+{
+    pthread_mutex_lock(&_perfMutex);
+    if (_perfStreaming && _perfSamples.size() < MAX_QUEUED_PERF_SAMPLES)
+    {
+        _perfSamples.push_back(sample);
+    }
+    pthread_mutex_unlock(&_perfMutex);
+}
+
+void Console::sendPerfSamples()
+{
+    std::vector<PerfSample> samples;
+    std::vector<PerfClient> clients;
+    pthread_mutex_lock(&_perfMutex);
+    samples.swap(_perfSamples);
+    clients = _perfClients;
+    pthread_mutex_unlock(&_perfMutex);
+
+    if (samples.empty())
+        return;
+
+#ifdef MSG_NOSIGNAL
+    // a client which went away must not raise SIGPIPE
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    std::vector<int> failed;
+    std::string buffer;
+    for (auto p_client = clients.begin(); p_client != clients.end(); ++p_client)
+    {
+        const auto& client = *p_client;
+        buffer.clear();
+        for (auto p_sample = samples.begin(); p_sample != samples.end(); ++p_sample)
+        {
+            const auto& sample = *p_sample;
+            if (sample.frame % client.interval != 0)
+                continue;
+
+            if (client.binary)
+            {
+                unsigned int record[10] = {
+                    PERF_SAMPLE_MAGIC, sample.frame, sample.frameTime, sample.updateTime, sample.visitTime,
+                    sample.renderTime, sample.drawCalls, sample.vertices, sample.textureMemory, sample.autoreleasedObjects
+                };
+                for (int i = 0; i < 10; ++i)
+                {
+                    record[i] = htonl(record[i]);
+                }
+                buffer.append((const char*)record, sizeof(record));
+            }
+            else
+            {
+                char line[160];
+                snprintf(line, sizeof(line), "%u %u %u %u %u %u %u %u %u\n",
+                         sample.frame, sample.frameTime, sample.updateTime, sample.visitTime, sample.renderTime,
+                         sample.drawCalls, sample.vertices, sample.textureMemory, sample.autoreleasedObjects);
+                buffer += line;
+            }
+        }
+
+        if (!buffer.empty() && send(client.fd, buffer.c_str(), buffer.length(), flags) < 0)
+        {
+            failed.push_back(client.fd);
+        }
+    }
+
+    for (auto p_fd = failed.begin(); p_fd != failed.end(); ++p_fd)
+    {
+        removePerfClient(*p_fd);
+    }
+}
+
 static char invalid_filename_char[] = {':', '/', '\\', '?', '%', '*', '<', '>', '"', '|', '\r', '\n', '\t'};
 
 void Console::commandUpload(int fd)
@@ -1411,6 +1565,7 @@ void Console::loop()
 			for (auto p_fd = to_remove.begin(); p_fd != to_remove.end(); ++p_fd)
 			{
 				const auto& fd = *p_fd;
+                removePerfClient(fd);
                 FD_CLR(fd, &_read_set);
                 _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
             }
@@ -1433,6 +1588,11 @@ void Console::loop()
             _DebugStrings.clear();
             pthread_mutex_unlock(&_DebugStringsMutex);
         }
+
+        /* Any frame metrics for the streaming clients ? */
+        if( _perfStreaming ) {
+            sendPerfSamples();
+        }
     }
 
     // clean up: ignore stdin, stdout and stderr
@@ -41,6 +41,7 @@ typedef SSIZE_T ssize_t;
 
 #include <pthread.h>
 #include <vector>
+#include <atomic>
 #include <map>
 #include <functional>
 #include <string>
@@ -80,6 +81,25 @@ public:
         std::function<void(int, const std::string&)> callback;
     };
 
+    /** Metrics of a frame, streamed to the clients which sent 'perf stream' */
+    struct PerfSample {
+        unsigned int frame;
+        /** microseconds since the previous frame */
+        unsigned int frameTime;
+        /** microseconds spent in Scheduler::update */
+        unsigned int updateTime;
+        /** microseconds spent visiting the scene graph */
+        unsigned int visitTime;
+        /** microseconds spent in Renderer::render */
+        unsigned int renderTime;
+        unsigned int drawCalls;
+        unsigned int vertices;
+        /** KB used by the textures of the TextureCache */
+        unsigned int textureMemory;
+        /** objects in the current autorelease pool at the end of the frame */
+        unsigned int autoreleasedObjects;
+    };
+
     /** Constructor */
     Console();
 
@@ -106,6 +126,11 @@ public:
      * @address : 127.0.0.1
      */
     void setBindAddress(const std::string &address);
+
+    /** Whether a client is streaming the performance metrics. Director only collects them in that case. */
+    bool isPerfStreaming() const { return _perfStreaming; }
+    /** Queues the metrics of a frame, the console thread sends them to the streaming clients */
+    void pushPerfSample(const PerfSample& sample);
  
 protected:
     void loop();
@@ -136,6 +161,10 @@ protected:
 	void commandDebugmsg(int fd, const std::string& args);
 	void commandFps(int fd, const std::string& args);
 	void commandVersion(int fd, const std::string& args);
+    void commandPerf(int fd, const std::string& args);
+
+    void removePerfClient(int fd);
+    void sendPerfSamples();
     // file descriptor: socket, console, etc.
     int _listenfd;
     int _maxfd;
@@ -159,6 +188,19 @@ protected:
     intptr_t _touchId;
 
     std::string _bindAddress;
+
+    // clients of 'perf stream'
+    struct PerfClient {
+        int fd;
+        bool binary;
+        /** a sample is sent every 'interval' frames */
+        unsigned int interval;
+    };
+    /** written by the console thread under _perfMutex, read without it by the cocos thread every frame */
+    std::atomic<bool> _perfStreaming;
+    pthread_mutex_t _perfMutex;
+    std::vector<PerfClient> _perfClients;
+    std::vector<PerfSample> _perfSamples;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Console);
 };
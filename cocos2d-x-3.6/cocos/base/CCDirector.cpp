@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 // standard includes
 #include <string>
+#include <pthread.h>
 
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCSpriteFrameCache.h"
@@ -58,6 +59,8 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCProfiling.h"
+#include "base/ccUtils.h"
 #include "platform/CCApplication.h"
 //#include "platform/CCGLViewImpl.h"
 
@@ -85,6 +88,27 @@ NS_CC_BEGIN
 
 // singleton stuff
 static DisplayLinkDirector *s_SharedDirector = nullptr;
+// per thread HeadlessDirector returned by getInstance() instead of the shared director.
+// Only the thread that steps or makes a headless director current sees it, the other threads keep the shared one
+static pthread_key_t s_currentDirectorKey;
+static pthread_once_t s_currentDirectorKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createCurrentDirectorKey()
+{
+    pthread_key_create(&s_currentDirectorKey, nullptr);
+}
+
+static Director* getCurrentDirector()
+{
+    pthread_once(&s_currentDirectorKeyOnce, createCurrentDirectorKey);
+    return static_cast<Director*>(pthread_getspecific(s_currentDirectorKey));
+}
+
+static void setCurrentDirector(Director* director)
+{
+    pthread_once(&s_currentDirectorKeyOnce, createCurrentDirectorKey);
+    pthread_setspecific(s_currentDirectorKey, director);
+}
 
 #define kDefaultFPS        60  // 60 frames per second
 extern const char* cocos2dVersion(void);
@@ -95,6 +119,17 @@ const char *Director::EVENT_AFTER_VISIT = "director_after_visit";
 const char *Director::EVENT_AFTER_UPDATE = "director_after_update";
 
 Director* Director::getInstance()
+{
+    Director* current = getCurrentDirector();
+    if (current)
+    {
+        return current;
+    }
+
+    return getMainInstance();
+}
+
+Director* Director::getMainInstance()
 {
     if (!s_SharedDirector)
     {
@@ -114,6 +149,7 @@ Director::Director()
 bool Director::init(void)
 {
     setDefaultValues();
+    CC_PROFILER_THREAD_NAME("Main");
 
     // scenes
     _runningScene = nullptr;
@@ -128,7 +164,12 @@ bool Director::init(void)
     _frameRate = 0.0f;
     _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
     _totalFrames = 0;
+    _renderOnDemand = false;
+    _redrawRequested = true;
+    _skippedFrames = 0;
+    _drawnVisualVersion = _drawnHierarchyVersion = _drawnInputEventCount = 0;
     _lastUpdate = new struct timeval;
+    _perfLastFrameTime = 0;
     _secondsPerFrame = 1.0f;
 
     // paused ?
@@ -155,13 +196,13 @@ bool Director::init(void)
     _scheduler->scheduleUpdate(_actionManager, Scheduler::PRIORITY_SYSTEM, false);
 
     _eventDispatcher = new (std::nothrow) EventDispatcher();
-    _eventAfterDraw = new (std::nothrow) EventCustom(EVENT_AFTER_DRAW);
+    _eventAfterDraw = new (std::nothrow) EventCustom(EventCustomID::get(EVENT_AFTER_DRAW));
     _eventAfterDraw->setUserData(this);
-    _eventAfterVisit = new (std::nothrow) EventCustom(EVENT_AFTER_VISIT);
+    _eventAfterVisit = new (std::nothrow) EventCustom(EventCustomID::get(EVENT_AFTER_VISIT));
     _eventAfterVisit->setUserData(this);
-    _eventAfterUpdate = new (std::nothrow) EventCustom(EVENT_AFTER_UPDATE);
+    _eventAfterUpdate = new (std::nothrow) EventCustom(EventCustomID::get(EVENT_AFTER_UPDATE));
     _eventAfterUpdate->setUserData(this);
-    _eventProjectionChanged = new (std::nothrow) EventCustom(EVENT_PROJECTION_CHANGED);
+    _eventProjectionChanged = new (std::nothrow) EventCustom(EventCustomID::get(EVENT_PROJECTION_CHANGED));
     _eventProjectionChanged->setUserData(this);
 
 
@@ -202,9 +243,17 @@ Director::~Director(void)
     // delete _lastUpdate
     CC_SAFE_DELETE(_lastUpdate);
 
-    Configuration::destroyInstance();
+    if (getCurrentDirector() == this)
+    {
+        setCurrentDirector(nullptr);
+    }
 
-    s_SharedDirector = nullptr;
+    if (s_SharedDirector == this)
+    {
+        Configuration::destroyInstance();
+
+        s_SharedDirector = nullptr;
+    }
 }
 
 void Director::setDefaultValues(void)
@@ -256,9 +305,20 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_PROFILER_ZONE("Director::drawScene");
+
     // calculate "global" dt
     calculateDeltaTime();
     
+    // the metrics are only collected while a console client streams them
+    bool perfStreaming = _console->isPerfStreaming();
+    double perfFrameStart = 0, perfUpdateEnd = 0;
+    if (perfStreaming)
+    {
+        perfFrameStart = utils::gettime();
+        _renderer->setRenderTimeEnabled(true);
+    }
+
     if (_openGLView)
     {
         _openGLView->pollEvents();
@@ -271,7 +331,10 @@ void Director::drawScene()
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
-    _renderer->clear();
+    if (perfStreaming)
+    {
+        perfUpdateEnd = utils::gettime();
+    }
 
     /* to avoid flickr, nextScene MUST be here: after tick and before draw.
      * FIXME: Which bug is this one. It seems that it can't be reproduced with v0.9
@@ -281,6 +344,16 @@ void Director::drawScene()
         setNextScene();
     }
 
+    if (_renderOnDemand && !isRedrawNeeded())
+    {
+        // nothing changed on screen, the last frame stays displayed.
+        // EVENT_AFTER_VISIT and EVENT_AFTER_DRAW are not dispatched for a skipped frame, see setRenderOnDemand()
+        _skippedFrames++;
+        return;
+    }
+
+    _renderer->clear();
+
     pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     if (_runningScene)
@@ -315,10 +388,27 @@ void Director::drawScene()
 
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
+    if (perfStreaming)
+    {
+        pushPerfSample(perfFrameStart, perfUpdateEnd);
+    }
+    else if (_perfLastFrameTime != 0)
+    {
+        // streaming stopped
+        _renderer->setRenderTimeEnabled(false);
+        _perfLastFrameTime = 0;
+    }
+
     popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
     _totalFrames++;
 
+    // the changes made while visiting are already drawn
+    _redrawRequested = false;
+    _drawnVisualVersion = Node::getVisualVersion();
+    _drawnHierarchyVersion = Node::getHierarchyVersion();
+    _drawnInputEventCount = _eventDispatcher->getInputEventCount();
+
     // swap buffers
     if (_openGLView)
     {
@@ -331,6 +421,57 @@ void Director::drawScene()
     }
 }
 
+void Director::setRenderOnDemand(bool renderOnDemand)
+{
+    _renderOnDemand = renderOnDemand;
+    _redrawRequested = true;
+}
+
+bool Director::isRedrawNeeded() const
+{
+    if (_redrawRequested || (_openGLView && !_openGLView->isFrameSkippingSupported()))
+    {
+        return true;
+    }
+
+    if (Node::getVisualVersion() != _drawnVisualVersion ||
+        Node::getHierarchyVersion() != _drawnHierarchyVersion ||
+        _eventDispatcher->getInputEventCount() != _drawnInputEventCount)
+    {
+        return true;
+    }
+
+#if CC_USE_PHYSICS
+    // the bodies are synchronized with their nodes while visiting
+    if (_runningScene && _runningScene->getPhysicsWorld())
+    {
+        return true;
+    }
+#endif
+
+    return _actionManager->hasRunningActions();
+}
+
+void Director::pushPerfSample(double frameStart, double updateEnd)
+{
+    double renderTime = _renderer->getRenderTime();
+
+    Console::PerfSample sample;
+    sample.frame = _totalFrames;
+    sample.frameTime = _perfLastFrameTime != 0 ? (unsigned int)((frameStart - _perfLastFrameTime) * 1000000) : 0;
+    sample.updateTime = (unsigned int)((updateEnd - frameStart) * 1000000);
+    // what isn't rendering after the update is visiting
+    sample.visitTime = (unsigned int)(MAX(0, utils::gettime() - updateEnd - renderTime) * 1000000);
+    sample.renderTime = (unsigned int)(renderTime * 1000000);
+    sample.drawCalls = (unsigned int)_renderer->getDrawnBatches();
+    sample.vertices = (unsigned int)_renderer->getDrawnVertices();
+    sample.textureMemory = (unsigned int)(_textureCache->getCachedTextureBytes() / 1024);
+    sample.autoreleasedObjects = (unsigned int)PoolManager::getInstance()->getCurrentPool()->getObjectCount();
+    _console->pushPerfSample(sample);
+
+    _perfLastFrameTime = frameStart;
+}
+
 void Director::calculateDeltaTime()
 {
     struct timeval now;
@@ -597,6 +738,8 @@ void Director::setProjection(Projection projection)
 {
     Size size = _winSizeInPoints;
 
+    requestRedraw();
+
     setViewport();
 
     switch (projection)
@@ -1043,6 +1186,8 @@ void Director::restartDirector()
 
 void Director::setNextScene()
 {
+    requestRedraw();
+
     bool runningIsTransition = dynamic_cast<TransitionScene*>(_runningScene) != nullptr;
     bool newIsTransition = dynamic_cast<TransitionScene*>(_nextScene) != nullptr;
 
@@ -1319,6 +1464,9 @@ void DisplayLinkDirector::startAnimation()
 
     _invalid = false;
 
+    // the frame may have been lost while the animation was stopped, e.g. in background
+    requestRedraw();
+
 #ifndef WP8_SHADER_COMPILER
     Application::getInstance()->setAnimationInterval(_animationInterval);
 #endif
@@ -1329,6 +1477,8 @@ void DisplayLinkDirector::startAnimation()
 
 void DisplayLinkDirector::mainLoop()
 {
+    CC_PROFILER_ZONE("Director::mainLoop");
+
     if (_purgeDirectorInNextLoop)
     {
         _purgeDirectorInNextLoop = false;
@@ -1363,5 +1513,120 @@ void DisplayLinkDirector::setAnimationInterval(double interval)
     }    
 }
 
+/***************************************************
+* implementation of HeadlessDirector
+**************************************************/
+
+HeadlessDirector* HeadlessDirector::create(const Size& winSize)
+{
+    HeadlessDirector* director = new (std::nothrow) HeadlessDirector();
+    if (director)
+    {
+        // init() and the nodes it creates have to use this director
+        Director* previous = getCurrentDirector();
+        setCurrentDirector(director);
+        director->init();
+        director->_winSizeInPoints = winSize;
+        setCurrentDirector(previous);
+    }
+    return director;
+}
+
+HeadlessDirector::HeadlessDirector()
+: _stopped(false)
+{
+}
+
+HeadlessDirector::~HeadlessDirector()
+{
+    Director* previous = getCurrentDirector();
+    setCurrentDirector(this);
+
+    // the scenes are released by ~Director(), they must not be running anymore
+    if (_runningScene)
+    {
+        _runningScene->onExit();
+        _runningScene->cleanup();
+    }
+    _scenesStack.clear();
+    _nextScene = nullptr;
+
+    destroyTextureCache();
+
+    setCurrentDirector((previous == this) ? nullptr : previous);
+}
+
+void HeadlessDirector::makeCurrent()
+{
+    setCurrentDirector(this);
+}
+
+void HeadlessDirector::makeMainDirectorCurrent()
+{
+    setCurrentDirector(nullptr);
+}
+
+void HeadlessDirector::step(float dt)
+{
+    CC_PROFILER_ZONE("HeadlessDirector::step");
+
+    Director* previous = getCurrentDirector();
+    setCurrentDirector(this);
+    {
+        // the objects of the main loop, or of another director, must not be released by this step
+        AutoreleasePool pool;
+
+        _deltaTime = MAX(0, dt);
+
+        if (! _paused)
+        {
+            _scheduler->update(_deltaTime);
+            _eventDispatcher->dispatchEvent(_eventAfterUpdate);
+        }
+
+        if (_nextScene)
+        {
+            setNextScene();
+        }
+
+#if CC_USE_PHYSICS
+        if (_runningScene)
+        {
+            auto physicsWorld = _runningScene->getPhysicsWorld();
+            if (physicsWorld && physicsWorld->isAutoStep())
+            {
+                physicsWorld->update(_deltaTime, false);
+            }
+        }
+#endif
+
+        _totalFrames++;
+    }
+    setCurrentDirector(previous);
+}
+
+void HeadlessDirector::mainLoop()
+{
+    if (! _stopped)
+    {
+        step((float)_animationInterval);
+    }
+}
+
+void HeadlessDirector::setAnimationInterval(double interval)
+{
+    _animationInterval = interval;
+}
+
+void HeadlessDirector::startAnimation()
+{
+    _stopped = false;
+}
+
+void HeadlessDirector::stopAnimation()
+{
+    _stopped = true;
+}
+
 NS_CC_END
 
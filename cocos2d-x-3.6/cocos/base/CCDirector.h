@@ -124,6 +124,13 @@ public:
      */
     static Director* getInstance();
 
+    /**
+     * Returns the main director, the one driven by the platform main loop, even while a HeadlessDirector is current.
+     * Worker threads posting to the cocos thread, e.g. with Scheduler::performFunctionInCocosThread(), should use it.
+     * @js NA
+     */
+    static Director* getMainInstance();
+
     /**
      * @deprecated Use getInstance() instead.
      * @js NA
@@ -191,6 +198,30 @@ public:
 
     /** How many frames were called since the director started */
     inline unsigned int getTotalFrames() { return _totalFrames; }
+
+    /** Enables or disables the render on demand mode, in which the frames where nothing changed on screen are neither
+     * visited nor rendered, the last frame drawn stays displayed. The scheduler and the actions still run every frame.
+     *
+     * A frame is drawn when a node was added, removed, moved, resized, shown, hidden, reordered or recolored, when an action
+     * is running, when an input event was dispatched, when a texture was uploaded, when the scene changed or has a physics
+     * world, and when requestRedraw() was called. Particle systems with live particles, playing armatures, DrawNode, Sprite
+     * texture/frame/blend changes and GLProgramState uniform setters request it themselves. Other changes made from a
+     * scheduled update, e.g. writing vertices by hand, must call requestRedraw().
+     * Frames are never skipped if the GLView doesn't keep the last frame displayed, see GLView::isFrameSkippingSupported().
+     *
+     * For a skipped frame the Director::EVENT_AFTER_UPDATE event is still dispatched, but Director::EVENT_AFTER_VISIT and
+     * Director::EVENT_AFTER_DRAW are not, since nothing is visited nor drawn.
+     * @since v3.6
+     */
+    void setRenderOnDemand(bool renderOnDemand);
+    /** Whether the render on demand mode is enabled. */
+    inline bool isRenderOnDemand() const { return _renderOnDemand; }
+
+    /** Makes the next frame drawn in render on demand mode, e.g. from a scheduled update which changed what is displayed. */
+    inline void requestRedraw() { _redrawRequested = true; }
+
+    /** How many frames were skipped by the render on demand mode since the director started. */
+    inline unsigned int getSkippedFrames() const { return _skippedFrames; }
     
     /** Gets an OpenGL projection.
      * @since v0.8.2
@@ -503,6 +534,9 @@ protected:
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
 
+    /* sends the metrics of this frame to the Console */
+    void pushPerfSample(double frameStart, double updateEnd);
+
     //textureCache creation or release
     void initTextureCache();
     void destroyTextureCache();
@@ -559,6 +593,16 @@ protected:
     /* How many frames were called since the director started */
     unsigned int _totalFrames;
     float _secondsPerFrame;
+
+    /* render on demand */
+    bool isRedrawNeeded() const;
+    bool _renderOnDemand;
+    bool _redrawRequested;
+    unsigned int _skippedFrames;
+    /* the versions of the scene graph and the input when the last frame was drawn */
+    unsigned int _drawnVisualVersion;
+    unsigned int _drawnHierarchyVersion;
+    unsigned int _drawnInputEventCount;
     
     /* The running scene */
     Scene *_runningScene;
@@ -597,6 +641,9 @@ protected:
     /* Console for the director */
     Console *_console;
 
+    /* start time of the previous frame, while the Console streams the performance metrics */
+    double _perfLastFrameTime;
+
     bool _isStatusLabelUpdated;
 
     // GLView will recreate stats labels to fit visible rect
@@ -635,6 +682,58 @@ protected:
     bool _invalid;
 };
 
+/**
+ @brief HeadlessDirector runs the scheduler, the actions, the events and the scene graph without any GLView nor rendering.
+
+ Meant for server side simulations, e.g. gameplay validation or bot matches. Several of them can live in the same process:
+ each one has its own scheduler, action manager and event dispatcher, and Director::getInstance() returns it while it steps,
+ so the game code run by the step uses them. Nodes take those of the current director when they are created,
+ so the scenes of a headless director must be created while it is current, see makeCurrent().
+
+ Features and Limitations:
+  - The frames are advanced by step() with a delta time given by the caller, or by mainLoop() with the animation interval.
+  - Nothing is visited nor rendered, textures and other GL resources can't be created.
+  - The current director is per thread: only the thread calling step() or makeCurrent() gets the headless director from
+    Director::getInstance(), the other threads keep getting the main director. Use Director::getMainInstance() to post
+    work back to the cocos thread.
+  - release() it instead of calling end().
+ */
+class CC_DLL HeadlessDirector : public Director
+{
+public:
+    /** Creates a headless director, release() it when it isn't needed anymore.
+     * @param winSize The size returned by getWinSize() and getVisibleSize().
+     */
+    static HeadlessDirector* create(const Size& winSize);
+
+    virtual ~HeadlessDirector();
+
+    /** Makes this director the one returned by Director::getInstance() on the calling thread, until another one is made current. */
+    void makeCurrent();
+
+    /** Makes the main director the one returned by Director::getInstance() on the calling thread again. */
+    static void makeMainDirectorCurrent();
+
+    /** Runs one frame: the scheduled updates and actions, the scene changes and the physics, with this delta time.
+     * The objects autoreleased during the step are released at its end.
+     */
+    void step(float dt);
+
+    //
+    // Overrides
+    //
+    /** Steps with the animation interval as delta time, unless the animation is stopped. */
+    virtual void mainLoop() override;
+    virtual void setAnimationInterval(double value) override;
+    virtual void startAnimation() override;
+    virtual void stopAnimation() override;
+
+protected:
+    HeadlessDirector();
+
+    bool _stopped;
+};
+
 NS_CC_END
 
 #endif // __CCDIRECTOR_H__
@@ -24,14 +24,64 @@
 
 #include "base/CCEventCustom.h"
 #include "base/CCEvent.h"
+#include "base/ccMacros.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
+
+#include <pthread.h>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_OBJECT_POOL(EventCustom, 50)
+
+static std::unordered_map<std::string, EventCustomID*>* s_eventIDs = nullptr;
+static pthread_mutex_t s_eventIDsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+EventCustomID::EventCustomID(const std::string& eventName, size_t index)
+: _eventName(eventName)
+, _index(index)
+{
+}
+
+const EventCustomID* EventCustomID::get(const std::string& eventName)
+{
+    pthread_mutex_lock(&s_eventIDsMutex);
+    
+    if (s_eventIDs == nullptr)
+    {
+        s_eventIDs = new (std::nothrow) std::unordered_map<std::string, EventCustomID*>();
+    }
+    
+    EventCustomID* eventID = nullptr;
+    auto iter = s_eventIDs->find(eventName);
+    if (iter != s_eventIDs->end())
+    {
+        eventID = iter->second;
+    }
+    else
+    {
+        eventID = new (std::nothrow) EventCustomID(eventName, s_eventIDs->size());
+        s_eventIDs->insert(std::make_pair(eventName, eventID));
+    }
+    
+    pthread_mutex_unlock(&s_eventIDsMutex);
+    return eventID;
+}
+
 EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
 , _eventName(eventName)
+, _eventID(nullptr)
+{
+}
+
+EventCustom::EventCustom(const EventCustomID* eventID)
+: Event(Type::CUSTOM)
+, _userData(nullptr)
+, _eventID(eventID)
 {
+    CCASSERT(eventID, "Invalid event ID.");
 }
 
 NS_CC_END
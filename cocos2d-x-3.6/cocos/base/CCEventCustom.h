@@ -27,6 +27,7 @@
 
 #include <string>
 #include "base/CCEvent.h"
+#include "base/allocator/CCAllocatorMacros.h"
 
 /**
  * @addtogroup base
@@ -35,12 +36,46 @@
 
 NS_CC_BEGIN
 
+/** @class EventCustomID
+ * @brief An interned name of custom event.
+ *
+ * The ID of a name is created only once and lives until the program exits.
+ * Dispatching a custom event by its ID doesn't hash or copy the event name.
+ * @js NA
+ */
+class CC_DLL EventCustomID
+{
+public:
+    /** Gets the ID of a custom event name, the ID is created the first time the name is used.
+     *
+     * @param eventName A given name of the custom event.
+     * @return The ID of the event name, it's always the same one for the same name.
+     */
+    static const EventCustomID* get(const std::string& eventName);
+    
+    /** Gets event name.
+     *
+     * @return The name of the event.
+     */
+    inline const std::string& getEventName() const { return _eventName; };
+    
+protected:
+    EventCustomID(const std::string& eventName, size_t index);
+    
+    std::string _eventName;
+    size_t _index;      ///< Sequence number of the ID, used by dispatchers to index their cached listeners
+    
+    friend class EventDispatcher;
+};
+
 /** @class EventCustom
  * @brief Custom event.
  */
 class CC_DLL EventCustom : public Event
 {
 public:
+    CC_DECLARE_ALLOCATOR_OBJECT_POOL(EventCustom)
+
     /** Constructor.
      *
      * @param eventName A given name of the custom event.
@@ -48,6 +83,14 @@ public:
      */
     EventCustom(const std::string& eventName);
     
+    /** Constructor with an interned event name.
+     * The event could be reused for dispatching the same event many times.
+     *
+     * @param eventID A given ID of the custom event, it's got by EventCustomID::get.
+     * @js NA
+     */
+    EventCustom(const EventCustomID* eventID);
+    
     /** Sets user data.
      *
      * @param data The user data pointer, it's a void*.
@@ -64,10 +107,18 @@ public:
      *
      * @return The name of the event.
      */
-    inline const std::string& getEventName() const { return _eventName; };
+    inline const std::string& getEventName() const { return _eventID ? _eventID->getEventName() : _eventName; };
+    
+    /** Gets the interned event name.
+     *
+     * @return The ID of the event, nullptr if the event was created with a name.
+     * @js NA
+     */
+    inline const EventCustomID* getEventID() const { return _eventID; };
 protected:
     void* _userData;       ///< User data
     std::string _eventName;
+    const EventCustomID* _eventID;
 };
 
 NS_CC_END
@@ -31,6 +31,7 @@
 #include "base/CCEventListenerKeyboard.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventListenerFocus.h"
+#include "base/CCTouchSpatialIndex.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
 #include "base/CCEventListenerController.h"
 #endif
@@ -201,9 +202,13 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
+, _inputEventCount(0)
 , _nodePriorityIndex(0)
+, _nodePriorityDirty(true)
+, _listenerMapVersion(1)
 {
     _toAddedListeners.reserve(50);
+    _touchSpatialIndex = new (std::nothrow) TouchSpatialIndex();
     
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
@@ -218,6 +223,7 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchSpatialIndex);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -376,6 +382,7 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
     _nodePriorityMap.erase(target);
     _dirtyNodes.erase(target);
+    _reorderedParents.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
     if (listenerIter != _nodeListenersMap.end())
@@ -439,10 +446,30 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+    
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        auto touchListener = static_cast<EventListenerTouchOneByOne*>(listener);
+        if (touchListener->_spatialIndexEnabled)
+        {
+            _touchSpatialIndex->addListener(node, touchListener);
+            node->_touchBoundsIndexed = true;
+        }
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
 {
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        auto touchListener = static_cast<EventListenerTouchOneByOne*>(listener);
+        if (touchListener->_spatialIndexEnabled)
+        {
+            node->_touchBoundsIndexed = _touchSpatialIndex->removeListener(node, touchListener);
+        }
+    }
+    
+
     std::vector<EventListener*>* listeners = nullptr;
     auto found = _nodeListenersMap.find(node);
     if (found != _nodeListenersMap.end())
@@ -486,6 +513,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
         
         listeners = new (std::nothrow) EventListenerVector();
         _listenerMap.insert(std::make_pair(listenerID, listeners));
+        ++_listenerMapVersion;
     }
     else
     {
@@ -690,6 +718,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
             _priorityDirtyFlagMap.erase(listener->getListenerID());
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
+            ++_listenerMapVersion;
             CC_SAFE_DELETE(list);
         }
         else
@@ -821,21 +850,47 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     DispatchGuard guard(_inDispatch);
     
+    if (event->getType() != Event::Type::CUSTOM)
+    {
+        ++_inputEventCount;
+    }
+    
     if (event->getType() == Event::Type::TOUCH)
     {
         dispatchTouchEvent(static_cast<EventTouch*>(event));
         return;
     }
     
-    auto listenerID = __getListenerID(event);
-    
-    sortEventListeners(listenerID);
+    EventListenerVector* listeners = nullptr;
     
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto eventID = (event->getType() == Event::Type::CUSTOM) ? static_cast<EventCustom*>(event)->getEventID() : nullptr;
+    if (eventID)
     {
-        auto listeners = iter->second;
+        // Events with an interned name are usually reused, so reset them first.
+        event->_isStopped = false;
         
+        const auto& cached = getCachedListeners(eventID);
+        if (cached.dirtyFlag && *cached.dirtyFlag != DirtyFlag::NONE)
+        {
+            sortEventListeners(eventID->getEventName());
+        }
+        listeners = cached.listeners;
+    }
+    else
+    {
+        auto listenerID = __getListenerID(event);
+        
+        sortEventListeners(listenerID);
+        
+        auto iter = _listenerMap.find(listenerID);
+        if (iter != _listenerMap.end())
+        {
+            listeners = iter->second;
+        }
+    }
+    
+    if (listeners)
+    {
         auto onEvent = [&event](EventListener* listener) -> bool{
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
@@ -855,6 +910,37 @@ void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *op
     dispatchEvent(&ev);
 }
 
+void EventDispatcher::dispatchCustomEvent(const EventCustomID* eventID, void *optionalUserData)
+{
+    EventCustom ev(eventID);
+    ev.setUserData(optionalUserData);
+    dispatchEvent(&ev);
+}
+
+const EventDispatcher::CachedListeners& EventDispatcher::getCachedListeners(const EventCustomID* eventID)
+{
+    if (eventID->_index >= _cachedCustomListeners.size())
+    {
+        _cachedCustomListeners.resize(eventID->_index + 1);
+    }
+    
+    auto& cached = _cachedCustomListeners[eventID->_index];
+    
+    // The cached pointers are only valid until an entry is inserted into or erased from the maps.
+    if (cached.version != _listenerMapVersion)
+    {
+        auto listenersIter = _listenerMap.find(eventID->getEventName());
+        cached.listeners = (listenersIter != _listenerMap.end()) ? listenersIter->second : nullptr;
+        
+        auto dirtyIter = _priorityDirtyFlagMap.find(eventID->getEventName());
+        cached.dirtyFlag = (dirtyIter != _priorityDirtyFlagMap.end()) ? &dirtyIter->second : nullptr;
+        
+        cached.version = _listenerMapVersion;
+    }
+    
+    return cached;
+}
+
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
@@ -885,6 +971,13 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
         for (; touchesIter != originalTouches.end(); ++touchesIter)
         {
             bool isSwallowed = false;
+            
+            // Find out the spatially indexed listeners whose node is under the touch
+            unsigned int hitTestStamp = 0;
+            if (event->getEventCode() == EventTouch::EventCode::BEGAN && !_touchSpatialIndex->empty())
+            {
+                hitTestStamp = _touchSpatialIndex->query((*touchesIter)->getLocation());
+            }
 
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
@@ -902,7 +995,14 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 
                 if (eventCode == EventTouch::EventCode::BEGAN)
                 {
-                    if (listener->onTouchBegan)
+                    // Spatially indexed listeners are only offered the touches inside their node.
+                    // Without any of them (hitTestStamp is 0), their flags aren't read at all.
+                    bool isHitCandidate = hitTestStamp == 0
+                        || !listener->_spatialIndexEnabled
+                        || listener->_fixedPriority != 0
+                        || listener->_hitTestStamp == hitTestStamp;
+                    
+                    if (listener->onTouchBegan && isHitCandidate)
                     {
                         isClaimed = listener->onTouchBegan(*touchesIter, event);
                         if (isClaimed && listener->_isRegistered)
@@ -1056,13 +1156,12 @@ void EventDispatcher::updateListeners(Event* event)
     if (_inDispatch > 1)
         return;
 
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    bool hasEmptyListeners = false;
+    
+    auto onUpdateListeners = [&hasEmptyListeners](EventListenerVector* listeners)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
+        if (listeners == nullptr)
             return;
-
-        auto listeners = listenersIter->second;
         
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
@@ -1110,27 +1209,38 @@ void EventDispatcher::updateListeners(Event* event)
         {
             listeners->clearFixedListeners();
         }
+        
+        if (listeners->empty())
+        {
+            hasEmptyListeners = true;
+        }
     };
 
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(getListeners(EventListenerTouchOneByOne::LISTENER_ID));
+        onUpdateListeners(getListeners(EventListenerTouchAllAtOnce::LISTENER_ID));
+    }
+    else if (event->getType() == Event::Type::CUSTOM && static_cast<EventCustom*>(event)->getEventID())
+    {
+        onUpdateListeners(getCachedListeners(static_cast<EventCustom*>(event)->getEventID()).listeners);
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        onUpdateListeners(getListeners(__getListenerID(event)));
     }
     
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // Only the listeners of the dispatched event could become empty while dispatching.
+    for (auto iter = _listenerMap.begin(); hasEmptyListeners && iter != _listenerMap.end();)
     {
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
+            ++_listenerMapVersion;
         }
         else
         {
@@ -1221,16 +1331,38 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    updateNodePriorityMap(rootNode);
     
-    // After sort: priority < 0, > 0
-    std::sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
-    });
+    // Looks up the priority of each listener only once, and skips sorting
+    // if the order is unchanged, e.g. when listeners were only removed.
+    std::vector<std::pair<int, EventListener*>> prioritizedListeners;
+    prioritizedListeners.reserve(sceneGraphListeners->size());
+    
+    bool isSorted = true;
+    auto& list = *sceneGraphListeners;
+    for (auto p_l = list.begin(); p_l != list.end(); ++p_l)
+    {
+        auto priorityIter = _nodePriorityMap.find((*p_l)->getAssociatedNode());
+        int priority = (priorityIter != _nodePriorityMap.end()) ? priorityIter->second : 0;
+        
+        if (!prioritizedListeners.empty() && prioritizedListeners.back().first < priority)
+            isSorted = false;
+        
+        prioritizedListeners.push_back(std::make_pair(priority, *p_l));
+    }
+    
+    if (!isSorted)
+    {
+        // After sort: priority < 0, > 0
+        std::sort(prioritizedListeners.begin(), prioritizedListeners.end(), [](const std::pair<int, EventListener*>& l1, const std::pair<int, EventListener*>& l2) {
+            return l1.first > l2.first;
+        });
+        
+        for (size_t i = 0, size = prioritizedListeners.size(); i < size; ++i)
+        {
+            list[i] = prioritizedListeners[i].second;
+        }
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
@@ -1241,6 +1373,75 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
 #endif
 }
 
+void EventDispatcher::updateNodePriorityMap(Node* rootNode)
+{
+    if (!_nodePriorityDirty)
+    {
+        bool isUpdated = true;
+        for (auto p_node = _reorderedParents.begin(); p_node != _reorderedParents.end(); ++p_node)
+        {
+            if (!updateNodePriorityForSubtree(*p_node))
+            {
+                isUpdated = false;
+                break;
+            }
+        }
+        
+        _reorderedParents.clear();
+        
+        if (isUpdated)
+            return;
+    }
+    
+    // Reset priority index
+    _nodePriorityIndex = 0;
+    _nodePriorityMap.clear();
+    
+    visitTarget(rootNode, true);
+    
+    _nodePriorityDirty = false;
+    _reorderedParents.clear();
+}
+
+bool EventDispatcher::updateNodePriorityForSubtree(Node* subtreeRoot)
+{
+    // Collects the nodes of the subtree in draw order, grouped by global z order.
+    visitTarget(subtreeRoot, false);
+    
+    // Within a global z order, the nodes of a subtree own a contiguous range of priorities.
+    // Reordering the subtree only changes which of its nodes owns which of these priorities.
+    bool isUpdated = true;
+    std::vector<int> priorities;
+    for (auto p_e = _globalZOrderNodeMap.begin(); p_e != _globalZOrderNodeMap.end() && isUpdated; ++p_e)
+    {
+        const auto& nodes = p_e->second;
+        priorities.clear();
+        
+        for (auto p_n = nodes.begin(); p_n != nodes.end(); ++p_n)
+        {
+            auto priorityIter = _nodePriorityMap.find(*p_n);
+            if (priorityIter == _nodePriorityMap.end())
+            {
+                isUpdated = false;
+                break;
+            }
+            priorities.push_back(priorityIter->second);
+        }
+        
+        if (isUpdated)
+        {
+            std::sort(priorities.begin(), priorities.end());
+            for (size_t i = 0, size = nodes.size(); i < size; ++i)
+            {
+                _nodePriorityMap[nodes[i]] = priorities[i];
+            }
+        }
+    }
+    
+    _globalZOrderNodeMap.clear();
+    return isUpdated;
+}
+
 void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
 {
     auto listeners = getListeners(listenerID);
@@ -1333,6 +1534,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
         _priorityDirtyFlagMap.erase(listenerID);
+        ++_listenerMapVersion;
         
         if (!_inDispatch)
         {
@@ -1419,6 +1621,7 @@ void EventDispatcher::removeAllEventListeners()
     if (!_inDispatch && cleanMap)
     {
         _listenerMap.clear();
+        ++_listenerMapVersion;
     }
 }
 
@@ -1434,10 +1637,37 @@ bool EventDispatcher::isEnabled() const
 
 void EventDispatcher::setDirtyForNode(Node* node)
 {
+    if (markDirtyNodes(node))
+    {
+        _nodePriorityDirty = true;
+    }
+}
+
+void EventDispatcher::setDirtyForLocalZOrder(Node* node)
+{
+    auto parent = node->getParent();
+    if (parent == nullptr)
+    {
+        setDirtyForNode(node);
+        return;
+    }
+    
+    // Only the draw order inside the parent's subtree was changed.
+    if (markDirtyNodes(node))
+    {
+        _reorderedParents.insert(parent);
+    }
+}
+
+bool EventDispatcher::markDirtyNodes(Node* node)
+{
+    bool isMarked = false;
+    
     // Mark the node dirty only when there is an eventlistener associated with it. 
     if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
     {
         _dirtyNodes.insert(node);
+        isMarked = true;
     }
 
     // Also set the dirty flag for node's children
@@ -1446,8 +1676,16 @@ void EventDispatcher::setDirtyForNode(Node* node)
     for (auto p_child = children.begin(); p_child != children.end(); ++p_child)
 	{
 		const auto& child = *p_child;
-        setDirtyForNode(child);
+        if (markDirtyNodes(child))
+            isMarked = true;
     }
+    
+    return isMarked;
+}
+
+void EventDispatcher::setDirtyForNodeBounds(Node* node)
+{
+    _touchSpatialIndex->setDirtyForNode(node);
 }
 
 void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
@@ -1456,6 +1694,7 @@ void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, Dirt
     if (iter == _priorityDirtyFlagMap.end())
     {
         _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
+        ++_listenerMapVersion;
     }
     else
     {
@@ -47,7 +47,9 @@ class Event;
 class EventTouch;
 class Node;
 class EventCustom;
+class EventCustomID;
 class EventListenerCustom;
+class TouchSpatialIndex;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -160,6 +162,11 @@ public:
      */
     bool isEnabled() const;
 
+    /** Gets the number of events dispatched so far which aren't custom events, e.g. touches, keys or mouse moves.
+     * Used by the render on demand mode of the Director.
+     */
+    unsigned int getInputEventCount() const { return _inputEventCount; }
+
     /////////////////////////////////////////////
     
     /** Dispatches the event.
@@ -177,6 +184,15 @@ public:
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with an interned event name and an optional user data.
+     *  Neither the event name is hashed nor memory is allocated, as long as no listener is added or removed.
+     *
+     * @param eventID The ID of the event which needs to be dispatched, it's got by EventCustomID::get.
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     * @js NA
+     */
+    void dispatchCustomEvent(const EventCustomID* eventID, void *optionalUserData = nullptr);
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher.
@@ -202,6 +218,14 @@ protected:
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
     
+    /** Sets the dirty flag for a node whose local z order was changed.
+     *  Only the subtree of its parent will be re-prioritized instead of the whole scene.
+     */
+    void setDirtyForLocalZOrder(Node* node);
+    
+    /** Sets the bounds of a node dirty, it's called when the transform of a spatially indexed node was changed. */
+    void setDirtyForNodeBounds(Node* node);
+    
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
      */
@@ -255,6 +279,14 @@ protected:
     /** Sorts the listeners of specified type by scene graph priority */
     void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
     
+    /** Updates the scene graph priority of the nodes, either by walking through the whole scene or only the reordered subtrees */
+    void updateNodePriorityMap(Node* rootNode);
+    
+    /** Reassigns the priorities owned by the nodes of a subtree according to the new draw order of the subtree.
+     *  @return False if a node of the subtree has no priority yet, the whole scene should be visited then.
+     */
+    bool updateNodePriorityForSubtree(Node* subtreeRoot);
+    
     /** Sorts the listeners of specified type by fixed priority */
     void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
     
@@ -288,6 +320,24 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
+    /** The listeners and the dirty flag of an interned custom event name */
+    struct CachedListeners
+    {
+        CachedListeners() : listeners(nullptr), dirtyFlag(nullptr), version(0) {}
+        
+        EventListenerVector* listeners;
+        DirtyFlag* dirtyFlag;
+        unsigned int version;   ///< The version of the maps when the pointers were cached
+    };
+    
+    /** Gets the listeners of an interned custom event name without looking up the maps if they didn't change */
+    const CachedListeners& getCachedListeners(const EventCustomID* eventID);
+    
+    /** Marks the nodes associated with event listeners in the subtree as dirty.
+     *  @return True if any node of the subtree is associated with event listeners.
+     */
+    bool markDirtyNodes(Node* node);
+    
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
     
@@ -317,9 +367,27 @@ protected:
     
     /** Whether to enable dispatching event */
     bool _isEnabled;
+
+    /** The number of events dispatched which aren't custom events */
+    unsigned int _inputEventCount;
     
     int _nodePriorityIndex;
     
+    /** The nodes whose children were reordered since the last time node priorities were updated */
+    std::set<Node*> _reorderedParents;
+    
+    /** Whether the whole scene needs to be visited to update the node priorities */
+    bool _nodePriorityDirty;
+    
+    /** Increased whenever an entry is inserted into or erased from _listenerMap or _priorityDirtyFlagMap */
+    unsigned int _listenerMapVersion;
+    
+    /** The cached listeners of interned custom event names, indexed by the sequence number of EventCustomID */
+    std::vector<CachedListeners> _cachedCustomListeners;
+    
+    /** The spatial index of the touch listeners which enabled it */
+    TouchSpatialIndex* _touchSpatialIndex;
+    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
@@ -39,6 +39,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _spatialIndexEnabled(false)
+, _hitTestStamp(0)
 {
 }
 
@@ -67,6 +69,17 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setSpatialIndexEnabled(bool enabled)
+{
+    CCASSERT(!_isRegistered, "Spatial index should be enabled before adding the listener.");
+    _spatialIndexEnabled = enabled;
+}
+
+bool EventListenerTouchOneByOne::isSpatialIndexEnabled() const
+{
+    return _spatialIndexEnabled;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -108,6 +121,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_spatialIndexEnabled = _spatialIndexEnabled;
     }
     else
     {
@@ -68,6 +68,20 @@ public:
      */
     bool isSwallowTouches();
     
+    /** Whether or not to put the listener into the spatial index of the event dispatcher.
+     * When enabled, 'onTouchBegan' is only invoked for touches inside the world space bounding box
+     * of the associated node, so the listener should not claim touches outside of it.
+     * It only takes effect for listeners added with scene graph priority, and should be set before adding the listener.
+     *
+     * @param enabled True if the listener should be spatially indexed.
+     */
+    void setSpatialIndexEnabled(bool enabled);
+    /** Is the listener spatially indexed or not.
+     *
+     * @return True if the listener is spatially indexed.
+     */
+    bool isSpatialIndexEnabled() const;
+    
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -90,8 +104,11 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _spatialIndexEnabled;
+    unsigned int _hitTestStamp;
     
     friend class EventDispatcher;
+    friend class TouchSpatialIndex;
 };
 
 /** @class EventListenerTouchAllAtOnce
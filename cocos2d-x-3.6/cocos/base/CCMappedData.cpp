@@ -0,0 +1,143 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCMappedData.h"
+
+#include "base/ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#define CC_MAX_PATH  512
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#define CC_MAPPED_DATA_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+MappedData::MappedData()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+{
+}
+
+MappedData::~MappedData()
+{
+    if (_releaser)
+    {
+        _releaser();
+    }
+}
+
+bool MappedData::initWithFile(const std::string& fullPath)
+{
+    CCASSERT(_bytes == nullptr, "MappedData already initialized");
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    WCHAR wszBuf[CC_MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf)/sizeof(wszBuf[0]));
+
+    HANDLE fileHandle = ::CreateFileW(wszBuf, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    HANDLE mappingHandle = nullptr;
+    // an empty file can't be mapped
+    if (::GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0 && fileSize.HighPart == 0)
+    {
+        mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    // the mapping keeps the file open
+    ::CloseHandle(fileHandle);
+    if (mappingHandle == nullptr)
+        return false;
+
+    void* view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        ::CloseHandle(mappingHandle);
+        return false;
+    }
+
+    initWithBytes(static_cast<const unsigned char*>(view), (ssize_t)fileSize.LowPart, [view, mappingHandle]() {
+        ::UnmapViewOfFile(view);
+        ::CloseHandle(mappingHandle);
+    });
+    return true;
+#elif CC_MAPPED_DATA_POSIX
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    void* address = MAP_FAILED;
+    // an empty file can't be mapped
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // the mapping keeps the file open
+    close(fd);
+    if (address == MAP_FAILED)
+        return false;
+
+    size_t length = (size_t)fileStat.st_size;
+    initWithBytes(static_cast<const unsigned char*>(address), (ssize_t)length, [address, length]() {
+        munmap(address, length);
+    });
+    return true;
+#else
+    CC_UNUSED_PARAM(fullPath);
+    return false;
+#endif
+}
+
+void MappedData::initWithBytes(const unsigned char* bytes, ssize_t size, const std::function<void()>& releaser)
+{
+    CCASSERT(_bytes == nullptr, "MappedData already initialized");
+
+    _bytes = bytes;
+    _size = size;
+    _mapped = true;
+    _releaser = releaser;
+}
+
+bool MappedData::initWithData(Data& data)
+{
+    CCASSERT(_bytes == nullptr, "MappedData already initialized");
+
+    if (data.isNull())
+        return false;
+
+    _data = std::move(data);
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+    return true;
+}
+
+NS_CC_END
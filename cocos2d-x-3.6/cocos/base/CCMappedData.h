@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_MAPPED_DATA_H__
+#define __CC_MAPPED_DATA_H__
+
+#include <functional>
+#include <string>
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class MappedData
+ * @brief A read only view of the content of a file, memory mapped when the platform allows it.
+ *
+ * The bytes of a mapped file aren't copied: the pages are read from the disk, or from the system file cache,
+ * as the parsers access them. MappedData is reference counted, so the parsers which keep pointers to the content
+ * (e.g. Bundle3D) can share it by retaining it. It isn't autoreleased, so it can be used by the loading threads:
+ * the owner of the reference releases it.
+ * When a file can't be mapped (e.g. inside a zip archive), its content is read into memory instead.
+ * @see FileUtils::getMappedDataFromFile()
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL MappedData : public Ref
+{
+public:
+    MappedData();
+    virtual ~MappedData();
+
+    /** Maps a file, given by its full path.
+     * @return False if the file can't be mapped.
+     */
+    bool initWithFile(const std::string& fullPath);
+
+    /** Wraps bytes owned by somebody else, e.g. the buffer of an Android asset.
+     * @param releaser Called when the MappedData is deleted, to release the bytes.
+     */
+    void initWithBytes(const unsigned char* bytes, ssize_t size, const std::function<void()>& releaser);
+
+    /** Takes the ownership of the buffer of data, which isn't copied.
+     * @return False if data is null.
+     */
+    bool initWithData(Data& data);
+
+    /** Gets the content, which must not be modified. */
+    const unsigned char* getBytes() const { return _bytes; }
+
+    /** Gets the size of the content. */
+    ssize_t getSize() const { return _size; }
+
+    /** Whether the content is memory mapped, rather than read into memory. */
+    bool isMapped() const { return _mapped; }
+
+protected:
+    const unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+
+    /** Owns the content when it was read into memory */
+    Data _data;
+    std::function<void()> _releaser;
+};
+
+NS_CC_END
+
+/**
+ end of base group
+ @}
+ */
+#endif // __CC_MAPPED_DATA_H__
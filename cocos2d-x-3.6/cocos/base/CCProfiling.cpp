@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCProfiling.h"
+#include <stdio.h>
 
 #ifdef _MSC_VER
 //https://github.com/LarryIII/Larry_Vcpkg/blob/fa94febc7cc9c68f2743ba87acfbea2e86785d69/ports/gettimeofday/gettimeofday.c
@@ -70,6 +71,24 @@ static void my_StartTicks(struct timeval& start)
 #endif
 }
 
+// microseconds, with a better resolution than gettimeofday__ on win32
+static long long my_GetMicroseconds()
+{
+#ifdef _MSC_VER
+	static LARGE_INTEGER s_frequency = { 0 };
+	if (s_frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&s_frequency);
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (long long)(counter.QuadPart / s_frequency.QuadPart) * 1000000LL
+		+ (long long)(counter.QuadPart % s_frequency.QuadPart) * 1000000LL / s_frequency.QuadPart;
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (long long)now.tv_sec * 1000000LL + now.tv_usec;
+#endif
+}
+
 static uint32_t my_GetTicks(struct timeval& start, struct timeval &now)
 {
 	uint32_t ticks;
@@ -88,6 +107,8 @@ NS_CC_BEGIN
 bool kProfilerCategorySprite = false;
 bool kProfilerCategoryBatchSprite = false;
 bool kProfilerCategoryParticles = false;
+// one zone per visited node, a lot of events
+bool kProfilerCategoryNode = false;
 
 
 static Profiler* g_sSharedProfiler = nullptr;
@@ -235,5 +256,237 @@ void ProfilingResetTimingBlock(const char *timerName)
     timer->reset();
 }
 
+// implementation of ZoneProfiler
+
+struct ZoneProfiler::ThreadBuffer
+{
+    struct Event
+    {
+        const ProfilingZone* zone;
+        long long time;
+        bool isBegin;
+    };
+
+    int tid;
+    std::string name;
+    /** guards events and name, only contended while exporting */
+    pthread_mutex_t mutex;
+    std::vector<Event> events;
+    /** number of begun zones whose end isn't recorded yet */
+    unsigned int depth;
+};
+
+std::atomic<bool> ZoneProfiler::s_capturing(false);
+
+static ZoneProfiler* s_sharedZoneProfiler = nullptr;
+static pthread_mutex_t s_sharedZoneProfilerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+ZoneProfiler* ZoneProfiler::getInstance()
+{
+    // zones may be entered by any thread first
+    pthread_mutex_lock(&s_sharedZoneProfilerMutex);
+    if (! s_sharedZoneProfiler)
+    {
+        s_sharedZoneProfiler = new (std::nothrow) ZoneProfiler();
+    }
+    pthread_mutex_unlock(&s_sharedZoneProfilerMutex);
+
+    return s_sharedZoneProfiler;
+}
+
+ZoneProfiler::ZoneProfiler()
+: _maxEventsPerThread(0)
+, _captureStartTime(0)
+{
+    pthread_mutex_init(&_buffersMutex, NULL);
+    pthread_key_create(&_bufferKey, NULL);
+}
+
+ZoneProfiler::ThreadBuffer* ZoneProfiler::getThreadBuffer()
+{
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(pthread_getspecific(_bufferKey));
+    if (buffer)
+        return buffer;
+
+    // The buffers are kept after their thread exits, so its zones can still be exported
+    buffer = new (std::nothrow) ThreadBuffer();
+    pthread_mutex_init(&buffer->mutex, NULL);
+    buffer->depth = 0;
+
+    pthread_mutex_lock(&_buffersMutex);
+    buffer->tid = (int)_buffers.size() + 1;
+    _buffers.push_back(buffer);
+    pthread_mutex_unlock(&_buffersMutex);
+
+    pthread_setspecific(_bufferKey, buffer);
+    return buffer;
+}
+
+bool ZoneProfiler::recordEvent(const ProfilingZone* zone, bool isBegin)
+{
+    bool recorded = false;
+    ThreadBuffer::Event event;
+    event.zone = zone;
+    event.time = my_GetMicroseconds();
+    event.isBegin = isBegin;
+
+    ThreadBuffer* buffer = getThreadBuffer();
+    pthread_mutex_lock(&buffer->mutex);
+    if (isBegin)
+    {
+        if (buffer->events.size() < _maxEventsPerThread)
+        {
+            buffer->events.push_back(event);
+            ++buffer->depth;
+            recorded = true;
+        }
+    }
+    else if (buffer->depth > 0)
+    {
+        // the end of a recorded beginning is never dropped, so the exported zones stay balanced
+        buffer->events.push_back(event);
+        --buffer->depth;
+        recorded = true;
+    }
+    pthread_mutex_unlock(&buffer->mutex);
+
+    return recorded;
+}
+
+void ZoneProfiler::startCapture(unsigned int maxEventsPerThread)
+{
+    stopCapture();
+
+    pthread_mutex_lock(&_buffersMutex);
+    for (auto iter = _buffers.begin(); iter != _buffers.end(); ++iter)
+    {
+        ThreadBuffer* buffer = *iter;
+        pthread_mutex_lock(&buffer->mutex);
+        buffer->events.clear();
+        buffer->depth = 0;
+        pthread_mutex_unlock(&buffer->mutex);
+    }
+    _maxEventsPerThread = maxEventsPerThread;
+    _captureStartTime = my_GetMicroseconds();
+    pthread_mutex_unlock(&_buffersMutex);
+
+    s_capturing = true;
+}
+
+void ZoneProfiler::stopCapture()
+{
+    s_capturing = false;
+}
+
+void ZoneProfiler::setCurrentThreadName(const char* name)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    pthread_mutex_lock(&buffer->mutex);
+    buffer->name = name;
+    pthread_mutex_unlock(&buffer->mutex);
+}
+
+static void appendJsonString(std::string& out, const char* str)
+{
+    out += '"';
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            out += '\\';
+        if ((unsigned char)*c >= 0x20)
+            out += *c;
+    }
+    out += '"';
+}
+
+std::string ZoneProfiler::getChromeTrace()
+{
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    char buf[128];
+
+    pthread_mutex_lock(&_buffersMutex);
+    for (auto iter = _buffers.begin(); iter != _buffers.end(); ++iter)
+    {
+        ThreadBuffer* buffer = *iter;
+        pthread_mutex_lock(&buffer->mutex);
+
+        if (!buffer->name.empty())
+        {
+            out += first ? "\n" : ",\n";
+            first = false;
+            sprintf(buf, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buffer->tid);
+            out += buf;
+            appendJsonString(out, buffer->name.c_str());
+            out += "}}";
+        }
+
+        // zones still open when the capture stopped are closed at the time of their last event
+        long long lastTime = _captureStartTime;
+        for (auto e = buffer->events.begin(); e != buffer->events.end(); ++e)
+        {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += "{\"name\":";
+            appendJsonString(out, e->zone->name);
+            out += ",\"cat\":";
+            appendJsonString(out, e->zone->category);
+            sprintf(buf, ",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1,\"tid\":%d}", e->isBegin ? 'B' : 'E', e->time - _captureStartTime, buffer->tid);
+            out += buf;
+            lastTime = e->time;
+        }
+        for (unsigned int i = 0; i < buffer->depth; ++i)
+        {
+            sprintf(buf, ",\n{\"ph\":\"E\",\"ts\":%lld,\"pid\":1,\"tid\":%d}", lastTime - _captureStartTime, buffer->tid);
+            out += buf;
+        }
+
+        pthread_mutex_unlock(&buffer->mutex);
+    }
+    pthread_mutex_unlock(&_buffersMutex);
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool ZoneProfiler::exportChromeTrace(const std::string& fullPath)
+{
+    std::string trace = getChromeTrace();
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        log("ZoneProfiler: can't open %s", fullPath.c_str());
+        return false;
+    }
+    size_t written = fwrite(trace.c_str(), 1, trace.size(), fp);
+    fclose(fp);
+
+    return written == trace.size();
+}
+
+// implementation of ProfilingZoneScope
+
+ProfilingZoneScope::ProfilingZoneScope(const ProfilingZone* zone, bool enabled)
+: _zone(nullptr)
+{
+    if (!enabled || !ZoneProfiler::s_capturing)
+        return;
+
+    // capturing implies the singleton exists, no need to lock
+    if (s_sharedZoneProfiler->recordEvent(zone, true))
+    {
+        _zone = zone;
+    }
+}
+
+ProfilingZoneScope::~ProfilingZoneScope()
+{
+    if (_zone)
+    {
+        s_sharedZoneProfiler->recordEvent(_zone, false);
+    }
+}
+
 NS_CC_END
 
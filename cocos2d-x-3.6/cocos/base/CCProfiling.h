@@ -29,6 +29,9 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include <string>
+#include <vector>
+#include <atomic>
+#include <pthread.h>
 //#include <boost/chrono.hpp>
 #ifdef _MSC_VER
 #include <winsock2.h>
@@ -163,6 +166,89 @@ extern void CC_DLL ProfilingResetTimingBlock(const char *timerName);
 extern bool kProfilerCategorySprite;
 extern bool kProfilerCategoryBatchSprite;
 extern bool kProfilerCategoryParticles;
+extern bool kProfilerCategoryNode;
+
+/** @struct ProfilingZone
+ * Static description of a profiled block of code.
+ * CC_PROFILER_ZONE defines one per call site, so entering a zone doesn't look anything up by name.
+ */
+struct ProfilingZone
+{
+    const char* name;
+    const char* category;
+};
+
+/** @class ProfilingZoneScope
+ * Records the beginning of a zone when it is constructed and its end when it is destroyed,
+ * on the calling thread. Nothing is recorded if ZoneProfiler isn't capturing.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ProfilingZoneScope
+{
+public:
+    explicit ProfilingZoneScope(const ProfilingZone* zone, bool enabled = true);
+    ~ProfilingZoneScope();
+
+private:
+    /** nullptr if the beginning of the zone wasn't recorded */
+    const ProfilingZone* _zone;
+};
+
+/** @class ZoneProfiler
+ * Hierarchical and thread aware profiler.
+
+ Zones are recorded into a buffer per thread while capturing, nested zones give the hierarchy.
+ A capture can be exported to the Chrome trace event format and opened in chrome://tracing.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ZoneProfiler
+{
+public:
+    /** returns the singleton */
+    static ZoneProfiler* getInstance();
+
+    /** Discards the previous capture and starts recording zones.
+     @param maxEventsPerThread Events beyond this number are dropped, to bound the memory used by a long capture.
+     */
+    void startCapture(unsigned int maxEventsPerThread = 1000000);
+    /** Stops recording zones, the capture is kept until the next startCapture. */
+    void stopCapture();
+    /** Whether zones are being recorded. */
+    bool isCapturing() const { return s_capturing; }
+
+    /** Names the calling thread in the exported traces. */
+    void setCurrentThreadName(const char* name);
+
+    /** Returns the capture in the Chrome trace event JSON format. */
+    std::string getChromeTrace();
+    /** Writes the capture in the Chrome trace event JSON format to a file.
+     @return True if the file was written.
+     */
+    bool exportChromeTrace(const std::string& fullPath);
+
+protected:
+    friend class ProfilingZoneScope;
+
+    struct ThreadBuffer;
+
+    ZoneProfiler();
+
+    ThreadBuffer* getThreadBuffer();
+    /** @return False if the event was dropped */
+    bool recordEvent(const ProfilingZone* zone, bool isBegin);
+
+    /** read by every zone on every thread, set on the thread which starts or stops the capture */
+    static std::atomic<bool> s_capturing;
+
+    /** all the thread buffers ever created, guarded by _buffersMutex */
+    std::vector<ThreadBuffer*> _buffers;
+    pthread_mutex_t _buffersMutex;
+    pthread_key_t _bufferKey;
+    unsigned int _maxEventsPerThread;
+    long long _captureStartTime;
+};
 
 // end of global group
 /// @}
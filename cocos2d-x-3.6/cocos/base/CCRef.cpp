@@ -77,6 +77,11 @@ Ref::~Ref()
     if (_referenceCount != 0)
         untrackRef(this);
 #endif
+
+    if (PoolManager::isDiagnosticsEnabled())
+    {
+        PoolManager::getInstance()->objectDeleted(this);
+    }
 }
 
 void Ref::retain()
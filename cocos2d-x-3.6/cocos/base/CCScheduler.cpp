@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include "base/CCProfiling.h"
 
 NS_CC_BEGIN
 
@@ -834,6 +835,8 @@ void Scheduler::performFunctionInCocosThread(const std::function<void ()> &funct
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_PROFILER_ZONE("Scheduler::update");
+
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -0,0 +1,236 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCTouchSpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+#include "base/CCEventListenerTouch.h"
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+// Size of a grid cell in points
+static const float CELL_SIZE = 128.0f;
+// Entries covering more cells are not put into the grid
+static const int MAX_CELLS_PER_ENTRY = 64;
+
+TouchSpatialIndex::TouchSpatialIndex()
+: _stamp(0)
+{
+}
+
+TouchSpatialIndex::~TouchSpatialIndex()
+{
+}
+
+long long TouchSpatialIndex::getCellKey(int x, int y)
+{
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
+void TouchSpatialIndex::addListener(Node* node, EventListenerTouchOneByOne* listener)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+    {
+        Entry entry;
+        entry.node = node;
+        entry.minCellX = entry.minCellY = entry.maxCellX = entry.maxCellY = 0;
+        entry.isDirty = true;
+        entry.isInCells = false;
+        entry.isOversized = false;
+        iter = _entries.insert(std::make_pair(node, entry)).first;
+
+        _dirtyNodes.push_back(node);
+    }
+
+    iter->second.listeners.push_back(listener);
+}
+
+bool TouchSpatialIndex::removeListener(Node* node, EventListenerTouchOneByOne* listener)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+        return false;
+
+    auto& listeners = iter->second.listeners;
+    auto found = std::find(listeners.begin(), listeners.end(), listener);
+    if (found != listeners.end())
+    {
+        listeners.erase(found);
+    }
+
+    if (!listeners.empty())
+        return true;
+
+    removeFromCells(&iter->second);
+    _entries.erase(iter);
+    return false;
+}
+
+void TouchSpatialIndex::setDirtyForNode(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter != _entries.end() && !iter->second.isDirty)
+    {
+        iter->second.isDirty = true;
+        _dirtyNodes.push_back(node);
+    }
+}
+
+void TouchSpatialIndex::update()
+{
+    //for (auto& node : _dirtyNodes)
+    for (auto p_node = _dirtyNodes.begin(); p_node != _dirtyNodes.end(); ++p_node)
+    {
+        // The node may have been removed from the index since it was marked dirty.
+        auto iter = _entries.find(*p_node);
+        if (iter == _entries.end() || !iter->second.isDirty)
+            continue;
+
+        auto entry = &iter->second;
+        removeFromCells(entry);
+
+        const Node* node = entry->node;
+        Rect rect(0, 0, node->getContentSize().width, node->getContentSize().height);
+        entry->bounds = RectApplyTransform(rect, node->getNodeToWorldTransform());
+        entry->isDirty = false;
+
+        insertIntoCells(entry);
+    }
+
+    _dirtyNodes.clear();
+}
+
+void TouchSpatialIndex::insertIntoCells(Entry* entry)
+{
+    const Rect& bounds = entry->bounds;
+    entry->minCellX = (int)std::floor(bounds.getMinX() / CELL_SIZE);
+    entry->minCellY = (int)std::floor(bounds.getMinY() / CELL_SIZE);
+    entry->maxCellX = (int)std::floor(bounds.getMaxX() / CELL_SIZE);
+    entry->maxCellY = (int)std::floor(bounds.getMaxY() / CELL_SIZE);
+
+    long long cellCount = (long long)(entry->maxCellX - entry->minCellX + 1) * (entry->maxCellY - entry->minCellY + 1);
+    if (cellCount > MAX_CELLS_PER_ENTRY)
+    {
+        entry->isOversized = true;
+        _oversizedEntries.push_back(entry);
+    }
+    else
+    {
+        entry->isOversized = false;
+        for (int x = entry->minCellX; x <= entry->maxCellX; ++x)
+        {
+            for (int y = entry->minCellY; y <= entry->maxCellY; ++y)
+            {
+                _cells[getCellKey(x, y)].push_back(entry);
+            }
+        }
+    }
+
+    entry->isInCells = true;
+}
+
+void TouchSpatialIndex::removeFromCells(Entry* entry)
+{
+    if (!entry->isInCells)
+        return;
+
+    if (entry->isOversized)
+    {
+        auto found = std::find(_oversizedEntries.begin(), _oversizedEntries.end(), entry);
+        if (found != _oversizedEntries.end())
+        {
+            _oversizedEntries.erase(found);
+        }
+    }
+    else
+    {
+        for (int x = entry->minCellX; x <= entry->maxCellX; ++x)
+        {
+            for (int y = entry->minCellY; y <= entry->maxCellY; ++y)
+            {
+                auto cellIter = _cells.find(getCellKey(x, y));
+                if (cellIter == _cells.end())
+                    continue;
+
+                auto& cell = cellIter->second;
+                auto found = std::find(cell.begin(), cell.end(), entry);
+                if (found != cell.end())
+                {
+                    // The order inside a cell doesn't matter
+                    *found = cell.back();
+                    cell.pop_back();
+                }
+
+                if (cell.empty())
+                {
+                    _cells.erase(cellIter);
+                }
+            }
+        }
+    }
+
+    entry->isInCells = false;
+}
+
+void TouchSpatialIndex::stampEntry(Entry* entry, const Vec2& point)
+{
+    if (!entry->bounds.containsPoint(point))
+        return;
+
+    //for (auto& listener : entry->listeners)
+    for (auto p_listener = entry->listeners.begin(); p_listener != entry->listeners.end(); ++p_listener)
+    {
+        (*p_listener)->_hitTestStamp = _stamp;
+    }
+}
+
+unsigned int TouchSpatialIndex::query(const Vec2& point)
+{
+    update();
+
+    // 0 is the stamp of the listeners which were never hit
+    if (++_stamp == 0)
+        ++_stamp;
+
+    auto cellIter = _cells.find(getCellKey((int)std::floor(point.x / CELL_SIZE), (int)std::floor(point.y / CELL_SIZE)));
+    if (cellIter != _cells.end())
+    {
+        auto& cell = cellIter->second;
+        for (auto p_entry = cell.begin(); p_entry != cell.end(); ++p_entry)
+        {
+            stampEntry(*p_entry, point);
+        }
+    }
+
+    for (auto p_entry = _oversizedEntries.begin(); p_entry != _oversizedEntries.end(); ++p_entry)
+    {
+        stampEntry(*p_entry, point);
+    }
+
+    return _stamp;
+}
+
+NS_CC_END
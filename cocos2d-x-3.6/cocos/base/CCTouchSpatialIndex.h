@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TOUCH_SPATIAL_INDEX_H__
+#define __CC_TOUCH_SPATIAL_INDEX_H__
+
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+class EventListenerTouchOneByOne;
+
+/** @class TouchSpatialIndex
+ * @brief A uniform grid over the world space bounding boxes of the nodes associated with
+ * spatially indexed one by one touch listeners.
+ *
+ * It is used by EventDispatcher to find the listeners which could be hit by a touch,
+ * so listeners of nodes far from the touch location don't need to be offered the touch.
+ * @js NA
+ */
+class CC_DLL TouchSpatialIndex
+{
+public:
+    /** Constructor of TouchSpatialIndex. */
+    TouchSpatialIndex();
+    /** Destructor of TouchSpatialIndex. */
+    ~TouchSpatialIndex();
+
+    /** Adds a listener associated with a node to the index. */
+    void addListener(Node* node, EventListenerTouchOneByOne* listener);
+
+    /** Removes a listener associated with a node from the index.
+     * @return True if the node is still indexed by other listeners.
+     */
+    bool removeListener(Node* node, EventListenerTouchOneByOne* listener);
+
+    /** Marks the bounds of a node dirty, they will be recomputed by the next query. */
+    void setDirtyForNode(Node* node);
+
+    /** Stamps all the listeners whose node bounds contain the point.
+     * @param point The touch location in world space.
+     * @return The stamp of this query, a listener is a candidate if its hit test stamp equals it.
+     */
+    unsigned int query(const Vec2& point);
+
+    /** Whether there is no listener in the index. */
+    bool empty() const { return _entries.empty(); }
+
+protected:
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        int minCellX, minCellY, maxCellX, maxCellY;
+        bool isDirty;
+        bool isInCells;
+        bool isOversized;
+        std::vector<EventListenerTouchOneByOne*> listeners;
+    };
+
+    /** Recomputes the bounds of the dirty nodes and moves them to their new cells. */
+    void update();
+    void insertIntoCells(Entry* entry);
+    void removeFromCells(Entry* entry);
+    void stampEntry(Entry* entry, const Vec2& point);
+
+    static long long getCellKey(int x, int y);
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<long long, std::vector<Entry*>> _cells;
+    /** Entries covering too many cells, they are tested against every query */
+    std::vector<Entry*> _oversizedEntries;
+    std::vector<Node*> _dirtyNodes;
+    unsigned int _stamp;
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_TOUCH_SPATIAL_INDEX_H__
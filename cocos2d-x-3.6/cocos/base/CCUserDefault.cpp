@@ -25,116 +25,364 @@ THE SOFTWARE.
 #include "base/CCUserDefault.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCStdC.h"
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
+#include <errno.h>
+#include <pthread.h>
+#include <unordered_map>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 // root name of xml
 #define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+// changes made within this delay are written to the file at once
+#define FLUSH_DELAY_MS 500
+
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * define the store here because we don't want to
+ * export tinyxml2 and pthread types in "CCUserDefault.h"
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+// Writes the data to path.tmp, then renames it over path, so the file holds either the previous or the new content
+static bool writeFileAtomically(const std::string& path, const char* data, size_t size)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    std::string tempPath = path + ".tmp";
 
-    // check the key value
-    if (! pKey)
+    FILE* fp = fopen(tempPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: UserDefault: can not open %s", tempPath.c_str());
+        return false;
+    }
+
+    bool written = fwrite(data, 1, size, fp) == size && fflush(fp) == 0;
+    // the data has to reach the disk before the rename does
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    written = written && _commit(_fileno(fp)) == 0;
+#else
+    written = written && fsync(fileno(fp)) == 0;
+#endif
+    written = fclose(fp) == 0 && written;
+
+    if (!written)
     {
-        return nullptr;
+        CCLOG("cocos2d: UserDefault: can not write %s", tempPath.c_str());
+        remove(tempPath.c_str());
+        return false;
     }
 
-    do 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    // rename() doesn't replace an existing file on Windows
+    wchar_t wideTempPath[MAX_PATH];
+    wchar_t widePath[MAX_PATH];
+    bool renamed = MultiByteToWideChar(CP_UTF8, 0, tempPath.c_str(), -1, wideTempPath, MAX_PATH) > 0
+        && MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath, MAX_PATH) > 0
+        && MoveFileExW(wideTempPath, widePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    bool renamed = rename(tempPath.c_str(), path.c_str()) == 0;
+    if (renamed)
     {
- 		tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-		*doc = xmlDoc;
-
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
-
-		if (xmlBuffer.empty())
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
-		xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-		// get root node
-		*rootNode = xmlDoc->RootElement();
-		if (nullptr == *rootNode)
-		{
-			CCLOG("read root node error");
-			break;
-		}
-		// find the node
-		curNode = (*rootNode)->FirstChildElement();
-		while (nullptr != curNode)
-		{
-			const char* nodeName = curNode->Value();
-			if (!strcmp(nodeName, pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->NextSiblingElement();
-		}
-	} while (0);
-
-	return curNode;
+        // the rename itself is only durable once the directory entry reaches the disk
+        size_t slash = path.find_last_of('/');
+        std::string dirPath = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+        int dir = open(dirPath.c_str(), O_RDONLY);
+        if (dir < 0 || fsync(dir) != 0)
+        {
+            CCLOG("cocos2d: UserDefault: can not sync %s", dirPath.c_str());
+        }
+        if (dir >= 0)
+        {
+            close(dir);
+        }
+    }
+#endif
+    if (!renamed)
+    {
+        CCLOG("cocos2d: UserDefault: can not replace %s", path.c_str());
+        remove(tempPath.c_str());
+    }
+    return renamed;
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+/**
+ * The values of UserDefault.xml, loaded once.
+ * The changes are written by a thread started with the first one.
+ */
+class UserDefaultStore
 {
- 	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	// check the params
-	if (! pKey || ! pValue)
-	{
-		return;
-	}
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
-	// if node exist, change the content
-	if (node)
-	{
-        if (node->FirstChild())
+public:
+    explicit UserDefaultStore(const std::string& filePath);
+    // writes the pending changes
+    ~UserDefaultStore();
+
+    bool getValue(const char* key, std::string* value);
+    void setValue(const char* key, const char* value);
+    void flush();
+
+private:
+    static void* threadEntry(void* arg);
+    void threadLoop();
+    void load();
+    void write();
+
+    std::string _filePath;
+
+    // guards the values and the versions
+    pthread_mutex_t _mutex;
+    // serializes the writes of the thread and of flush()
+    pthread_mutex_t _fileMutex;
+    pthread_cond_t _condition;
+    pthread_t _thread;
+    bool _threadStarted;
+    bool _quit;
+
+    std::unordered_map<std::string, std::string> _values;
+    // incremented by each change
+    unsigned int _version;
+    // version of the values in the file
+    unsigned int _writtenVersion;
+    // last version the thread wrote or tried to write
+    unsigned int _handledVersion;
+};
+
+UserDefaultStore::UserDefaultStore(const std::string& filePath)
+: _filePath(filePath)
+, _threadStarted(false)
+, _quit(false)
+, _version(0)
+, _writtenVersion(0)
+, _handledVersion(0)
+{
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_mutex_init(&_fileMutex, NULL);
+    pthread_cond_init(&_condition, NULL);
+
+    load();
+}
+
+UserDefaultStore::~UserDefaultStore()
+{
+    if (_threadStarted)
+    {
+        pthread_mutex_lock(&_mutex);
+        _quit = true;
+        pthread_mutex_unlock(&_mutex);
+        pthread_cond_signal(&_condition);
+        pthread_join(_thread, NULL);
+    }
+
+    write();
+
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_fileMutex);
+    pthread_mutex_destroy(&_mutex);
+}
+
+void UserDefaultStore::load()
+{
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(_filePath);
+    if (xmlBuffer.empty())
+    {
+        CCLOG("can not read xml file");
+        return;
+    }
+
+    tinyxml2::XMLDocument doc;
+    doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+
+    tinyxml2::XMLElement* rootNode = doc.RootElement();
+    if (nullptr == rootNode)
+    {
+        CCLOG("read root node error");
+        return;
+    }
+
+    for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+    {
+        // a node without content is a value set to an empty string, and the first node of a key wins
+        const char* text = node->FirstChild() ? node->FirstChild()->Value() : "";
+        _values.insert(std::make_pair(std::string(node->Value()), std::string(text)));
+    }
+}
+
+bool UserDefaultStore::getValue(const char* key, std::string* value)
+{
+    if (! key)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&_mutex);
+    auto iter = _values.find(key);
+    bool found = iter != _values.end();
+    if (found)
+    {
+        *value = iter->second;
+    }
+    pthread_mutex_unlock(&_mutex);
+
+    return found;
+}
+
+void UserDefaultStore::setValue(const char* key, const char* value)
+{
+    pthread_mutex_lock(&_mutex);
+
+    auto iter = _values.find(key);
+    if (iter != _values.end() && iter->second == value)
+    {
+        pthread_mutex_unlock(&_mutex);
+        return;
+    }
+
+    if (iter != _values.end())
+        iter->second = value;
+    else
+        _values.insert(std::make_pair(std::string(key), std::string(value)));
+    ++_version;
+
+    if (! _threadStarted)
+    {
+        _threadStarted = pthread_create(&_thread, NULL, &UserDefaultStore::threadEntry, this) == 0;
+        if (! _threadStarted)
         {
-            node->FirstChild()->SetValue(pValue);
+            CCLOG("cocos2d: UserDefault: can not start the writing thread, the changes are written on flush()");
         }
-        else
+    }
+
+    pthread_mutex_unlock(&_mutex);
+    pthread_cond_signal(&_condition);
+}
+
+void UserDefaultStore::flush()
+{
+    write();
+}
+
+void UserDefaultStore::write()
+{
+    pthread_mutex_lock(&_fileMutex);
+
+    pthread_mutex_lock(&_mutex);
+    if (_version == _writtenVersion)
+    {
+        pthread_mutex_unlock(&_mutex);
+        pthread_mutex_unlock(&_fileMutex);
+        return;
+    }
+
+    unsigned int version = _version;
+    tinyxml2::XMLPrinter printer;
+    printer.PushHeader(false, true);
+    printer.OpenElement(USERDEFAULT_ROOT_NAME);
+    //for (const auto& value : _values)
+    for (auto p_value = _values.begin(); p_value != _values.end(); ++p_value)
+    {
+        printer.OpenElement(p_value->first.c_str());
+        printer.PushText(p_value->second.c_str());
+        printer.CloseElement();
+    }
+    printer.CloseElement();
+    pthread_mutex_unlock(&_mutex);
+
+    // CStrSize() counts the terminating null character
+    if (writeFileAtomically(_filePath, printer.CStr(), printer.CStrSize() - 1))
+    {
+        pthread_mutex_lock(&_mutex);
+        _writtenVersion = version;
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    pthread_mutex_unlock(&_fileMutex);
+}
+
+void* UserDefaultStore::threadEntry(void* arg)
+{
+    static_cast<UserDefaultStore*>(arg)->threadLoop();
+    return NULL;
+}
+
+void UserDefaultStore::threadLoop()
+{
+    pthread_mutex_lock(&_mutex);
+    while (true)
+    {
+        while (_version == _handledVersion && !_quit)
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            pthread_cond_wait(&_condition, &_mutex);
         }
-	}
-	else
-	{
-		if (rootNode)
-		{
-			tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-			rootNode->LinkEndChild(tmpNode);
-			tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-			tmpNode->LinkEndChild(content);
-		}	
-	}
+        if (_quit)
+            break;
+
+        // let the following changes gather, then write them at once
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        long long deadlineUs = (long long)now.tv_sec * 1000000 + now.tv_usec + FLUSH_DELAY_MS * 1000;
+        struct timespec deadline;
+        deadline.tv_sec = (time_t)(deadlineUs / 1000000);
+        deadline.tv_nsec = (long)(deadlineUs % 1000000) * 1000;
+        while (!_quit && pthread_cond_timedwait(&_condition, &_mutex, &deadline) != ETIMEDOUT)
+        {
+        }
+        if (_quit)
+            break;
+
+        // a failed write is tried again with the next change
+        _handledVersion = _version;
+        pthread_mutex_unlock(&_mutex);
+        write();
+        pthread_mutex_lock(&_mutex);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+static UserDefaultStore* s_store = nullptr;
+
+static UserDefaultStore* getStore()
+{
+    if (! s_store)
+    {
+        s_store = new (std::nothrow) UserDefaultStore(UserDefault::getXMLFilePath());
+    }
+    return s_store;
+}
+
+static bool getValueForKey(const char* pKey, std::string* pValue)
+{
+    UserDefaultStore* store = getStore();
+    return store && store->getValue(pKey, pValue);
+}
 
-    // save file and free doc
-	if (doc)
+static void setValueForKey(const char* pKey, const char* pValue)
+{
+	// check the params
+	if (! pKey || ! pValue)
 	{
-		doc->SaveFile(UserDefault::getInstance()->getXMLFilePath().c_str());
-		delete doc;
+		return;
 	}
+
+    UserDefaultStore* store = getStore();
+    if (store)
+    {
+        store->setValue(pKey, pValue);
+    }
 }
 
 /**
@@ -160,26 +408,14 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	bool ret = defaultValue;
 
-	if (value)
+	if (getValueForKey(pKey, &value))
 	{
-		ret = (! strcmp(value, "true"));
+		ret = (value == "true");
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -190,30 +426,14 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	int ret = defaultValue;
 
-	if (value)
-	{
-		ret = atoi(value);
-	}
-
-	if(doc)
+	if (getValueForKey(pKey, &value))
 	{
-		delete doc;
+		ret = atoi(value.c_str());
 	}
 
-
 	return ret;
 }
 
@@ -236,26 +456,14 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	double ret = defaultValue;
 
-	if (value)
+	if (getValueForKey(pKey, &value))
 	{
-		ret = utils::atof(value);
+		ret = utils::atof(value.c_str());
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -266,27 +474,14 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    std::string value;
 
-	string ret = defaultValue;
-
-	if (value)
+	if (getValueForKey(pKey, &value))
 	{
-		ret = string(value);
+		return value;
 	}
 
-    if (doc) delete doc;
-
-	return ret;
+	return defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -296,35 +491,22 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        encodedData = (const char*)(node->FirstChild()->Value());
-	}
-    
+    std::string encodedData;
 	Data ret = defaultValue;
     
-	if (encodedData)
+	if (getValueForKey(pKey, &encodedData))
 	{
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.length(), &decodedData);
         
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
         }
 	}
     
-    if (doc) delete doc;
-    
 	return ret;    
 }
 
-
 void UserDefault::setBoolForKey(const char* pKey, bool value)
 {
     // save bool value as string
@@ -404,6 +586,7 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
         free(encodedData);
 }
 
+
 UserDefault* UserDefault::getInstance()
 {
     if (!_userDefault)
@@ -426,6 +609,8 @@ UserDefault* UserDefault::getInstance()
 void UserDefault::destroyInstance()
 {
     CC_SAFE_DELETE(_userDefault);
+    // writes the pending changes
+    CC_SAFE_DELETE(s_store);
 }
 
 void UserDefault::setDelegate(UserDefault *delegate)
@@ -501,6 +686,10 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    if (s_store)
+    {
+        s_store->flush();
+    }
 }
 
 NS_CC_END
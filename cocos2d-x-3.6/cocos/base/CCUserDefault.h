@@ -43,6 +43,10 @@ NS_CC_BEGIN
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * Except on iOS, Mac and Android, the values are loaded from UserDefault.xml once and kept in memory.
+ * The changes are written back to the file on a background thread, gathered for a short delay,
+ * by writing a temporary file and renaming it over the previous one.
  */
 class CC_DLL UserDefault
 {
@@ -198,6 +202,7 @@ public:
     virtual void setDataForKey(const char* key, const Data& value);
     /**
      * You should invoke this function to save values set by setXXXForKey().
+     * Writes the pending changes before returning, e.g. when the application enters background.
      * @js NA
      */
     virtual void flush();
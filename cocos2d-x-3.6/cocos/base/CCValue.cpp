@@ -72,20 +72,21 @@ Value::Value(bool v)
 }
 
 Value::Value(const char* v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new std::string();
-    if (v)
-    {
-        *_field.strVal = v;
-    }
+    setString(v ? v : "", v ? strlen(v) : 0);
 }
 
 Value::Value(const std::string& v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new std::string();
-    *_field.strVal = v;
+    setString(v.c_str(), v.length());
+}
+
+Value::Value(std::string&& v)
+: _type(Type::NONE)
+{
+    setString(std::move(v));
 }
 
 Value::Value(const ValueVector& v)
@@ -169,11 +170,7 @@ Value& Value::operator= (const Value& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                if (_field.strVal == nullptr)
-                {
-                    _field.strVal = new std::string();
-                }
-                *_field.strVal = *other._field.strVal;
+                setString(other.getStringData(), other.getStringLength());
                 break;
             case Type::VECTOR:
                 if (_field.vectorVal == nullptr)
@@ -226,7 +223,8 @@ Value& Value::operator= (Value&& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                _field.strVal = other._field.strVal;
+                memcpy(&_field, &other._field, sizeof(_field));
+                _shortStrLength = other._shortStrLength;
                 break;
             case Type::VECTOR:
                 _field.vectorVal = other._field.vectorVal;
@@ -286,15 +284,19 @@ Value& Value::operator= (bool v)
 
 Value& Value::operator= (const char* v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v ? v : "";
+    setString(v ? v : "", v ? strlen(v) : 0);
     return *this;
 }
 
 Value& Value::operator= (const std::string& v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v;
+    setString(v.c_str(), v.length());
+    return *this;
+}
+
+Value& Value::operator= (std::string&& v)
+{
+    setString(std::move(v));
     return *this;
 }
 
@@ -364,7 +366,7 @@ bool Value::operator== (const Value& v) const
     case Type::BYTE:    return v._field.byteVal   == this->_field.byteVal;
     case Type::INTEGER: return v._field.intVal    == this->_field.intVal;
     case Type::BOOLEAN: return v._field.boolVal   == this->_field.boolVal;
-    case Type::STRING:  return *v._field.strVal   == *this->_field.strVal;
+    case Type::STRING:  return v.getStringLength() == this->getStringLength() && memcmp(v.getStringData(), this->getStringData(), this->getStringLength()) == 0;
     case Type::FLOAT:   return fabs(v._field.floatVal  - this->_field.floatVal)  <= FLT_EPSILON;
     case Type::DOUBLE:  return fabs(v._field.doubleVal - this->_field.doubleVal) <= FLT_EPSILON;
     case Type::VECTOR:
@@ -437,7 +439,7 @@ unsigned char Value::asByte() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<unsigned char>(atoi(_field.strVal->c_str()));
+        return static_cast<unsigned char>(atoi(getStringData()));
     }
 
     if (_type == Type::FLOAT)
@@ -473,7 +475,7 @@ int Value::asInt() const
 
     if (_type == Type::STRING)
     {
-        return atoi(_field.strVal->c_str());
+        return atoi(getStringData());
     }
 
     if (_type == Type::FLOAT)
@@ -509,7 +511,7 @@ float Value::asFloat() const
 
     if (_type == Type::STRING)
     {
-        return utils::atof(_field.strVal->c_str());
+        return utils::atof(getStringData());
     }
 
     if (_type == Type::INTEGER)
@@ -545,7 +547,7 @@ double Value::asDouble() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<double>(utils::atof(_field.strVal->c_str()));
+        return static_cast<double>(utils::atof(getStringData()));
     }
 
     if (_type == Type::INTEGER)
@@ -581,7 +583,7 @@ bool Value::asBool() const
 
     if (_type == Type::STRING)
     {
-        return (*_field.strVal == "0" || *_field.strVal == "false") ? false : true;
+        return (strcmp(getStringData(), "0") == 0 || strcmp(getStringData(), "false") == 0) ? false : true;
     }
 
     if (_type == Type::INTEGER)
@@ -608,7 +610,7 @@ std::string Value::asString() const
 
     if (_type == Type::STRING)
     {
-        return *_field.strVal;
+        return _shortStrLength == LONG_STRING ? *_field.strVal : std::string(_field.shortStrVal, _shortStrLength);
     }
 
     std::stringstream ret;
@@ -790,7 +792,11 @@ void Value::clear()
             _field.boolVal = false;
             break;
         case Type::STRING:
-            CC_SAFE_DELETE(_field.strVal);
+            if (_shortStrLength == LONG_STRING)
+            {
+                CC_SAFE_DELETE(_field.strVal);
+            }
+            _shortStrLength = 0;
             break;
         case Type::VECTOR:
             CC_SAFE_DELETE(_field.vectorVal);
@@ -819,7 +825,9 @@ void Value::reset(Type type)
     switch (type)
     {
         case Type::STRING:
-            _field.strVal = new std::string();
+            // an empty short string
+            _field.shortStrVal[0] = '\0';
+            _shortStrLength = 0;
             break;
         case Type::VECTOR:
             _field.vectorVal = new (std::nothrow) ValueVector();
@@ -837,4 +845,60 @@ void Value::reset(Type type)
     _type = type;
 }
 
+void Value::setString(const char* v, size_t length)
+{
+    if (length <= SHORT_STRING_CAPACITY)
+    {
+        if (_type != Type::STRING || _shortStrLength == LONG_STRING)
+        {
+            clear();
+        }
+        // v may be this string
+        memmove(_field.shortStrVal, v, length);
+        _field.shortStrVal[length] = '\0';
+        _shortStrLength = static_cast<unsigned char>(length);
+    }
+    else if (_type == Type::STRING && _shortStrLength == LONG_STRING)
+    {
+        _field.strVal->assign(v, length);
+    }
+    else
+    {
+        clear();
+        _field.strVal = new std::string(v, length);
+        _shortStrLength = LONG_STRING;
+    }
+    _type = Type::STRING;
+}
+
+void Value::setString(std::string&& v)
+{
+    if (v.length() <= SHORT_STRING_CAPACITY)
+    {
+        // copied, v keeps its buffer so that a parser can reuse it
+        setString(v.c_str(), v.length());
+    }
+    else if (_type == Type::STRING && _shortStrLength == LONG_STRING)
+    {
+        *_field.strVal = std::move(v);
+    }
+    else
+    {
+        clear();
+        _field.strVal = new std::string(std::move(v));
+        _shortStrLength = LONG_STRING;
+        _type = Type::STRING;
+    }
+}
+
+const char* Value::getStringData() const
+{
+    return _shortStrLength == LONG_STRING ? _field.strVal->c_str() : _field.shortStrVal;
+}
+
+size_t Value::getStringLength() const
+{
+    return _shortStrLength == LONG_STRING ? _field.strVal->length() : _shortStrLength;
+}
+
 NS_CC_END
@@ -50,6 +50,7 @@ CC_DLL extern const ValueMapIntKey ValueMapIntKeyNull;
 
 /*
  * This class is provide as a wrapper of basic types, such as int and bool.
+ * Strings of up to 15 chars are stored inside the Value, the longer ones are allocated.
  */
 class CC_DLL Value
 {
@@ -80,6 +81,8 @@ public:
     
     /** Create a Value by a string. */
     explicit Value(const std::string& v);
+    /** Create a Value by a string. It will use std::move internally. */
+    explicit Value(std::string&& v);
     
     /** Create a Value by a ValueVector object. */
     explicit Value(const ValueVector& v);
@@ -123,6 +126,8 @@ public:
     Value& operator= (const char* v);
     /** Assignment operator, assign from string to Value. */
     Value& operator= (const std::string& v);
+    /** Assignment operator, assign from string to Value. It will use std::move internally. */
+    Value& operator= (std::string&& v);
 
     /** Assignment operator, assign from ValueVector to Value. */
     Value& operator= (const ValueVector& v);
@@ -217,6 +222,16 @@ private:
     void clear();
     void reset(Type type);
 
+    void setString(const char* v, size_t length);
+    void setString(std::string&& v);
+    const char* getStringData() const;
+    size_t getStringLength() const;
+
+    /** Max length of the strings stored in _field.shortStrVal, without the null character. */
+    static const unsigned char SHORT_STRING_CAPACITY = 15;
+    /** _shortStrLength of the strings allocated in _field.strVal. */
+    static const unsigned char LONG_STRING = 0xff;
+
     union
     {
         unsigned char byteVal;
@@ -229,9 +244,13 @@ private:
         ValueVector* vectorVal;
         ValueMap* mapVal;
         ValueMapIntKey* intKeyMapVal;
+
+        char shortStrVal[SHORT_STRING_CAPACITY + 1];
     }_field;
 
     Type _type;
+    /** Length of the string if it is stored in _field.shortStrVal, else LONG_STRING. */
+    unsigned char _shortStrLength;
 };
 
 /** @} */
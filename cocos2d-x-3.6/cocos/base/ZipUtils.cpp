@@ -35,6 +35,8 @@
 #include <zlib.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
@@ -143,13 +145,64 @@ inline unsigned int ZipUtils::checksumPvr(const unsigned int *data, ssize_t len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
+// max threads used by inflateMemoryParallel(), with the calling one
+#define INFLATE_THREAD_COUNT (4)
+// below this inflated size, threads cost more than they save
+#define INFLATE_PARALLEL_MIN_LENGTH (256 * 1024)
+
+// Inflates the input of stream into its output, going on with the next member of concatenated gzip data.
+// Returns Z_STREAM_END when the input is inflated, Z_BUF_ERROR when the output is full before, or the zlib error.
+static int inflateMembers(z_stream& stream)
+{
+    for (;;)
+    {
+        int err = inflate(&stream, Z_NO_FLUSH);
+
+        if (err == Z_STREAM_END)
+        {
+            if (stream.avail_in >= 2 && stream.next_in[0] == 0x1F && stream.next_in[1] == 0x8B)
+            {
+                inflateReset(&stream);
+                continue;
+            }
+            return Z_STREAM_END;
+        }
+
+        switch (err)
+        {
+            case Z_NEED_DICT:
+                return Z_DATA_ERROR;
+            case Z_DATA_ERROR:
+            case Z_MEM_ERROR:
+            case Z_STREAM_ERROR:
+                return err;
+        }
+
+        if (stream.avail_out == 0)
+        {
+            return Z_BUF_ERROR;
+        }
+        if (stream.avail_in == 0)
+        {
+            // truncated data
+            return Z_DATA_ERROR;
+        }
+    }
+}
+
 int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLenghtHint)
 {
     /* ret value */
     int err = Z_OK;
     
-    ssize_t bufferSize = outLenghtHint;
+    // the gzip trailer tells the exact size of a single member, so the buffer doesn't need to grow
+    ssize_t gzipLength = getGZipBufferInflatedLengthHint(in, inLength);
+    ssize_t bufferSize = gzipLength > 0 ? gzipLength : outLenghtHint;
     *out = (unsigned char*)malloc(bufferSize);
+    if (! *out)
+    {
+        return Z_MEM_ERROR;
+    }
     
     z_stream d_stream; /* decompression stream */
     d_stream.zalloc = (alloc_func)0;
@@ -167,40 +220,34 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
     
     for (;;)
     {
-        err = inflate(&d_stream, Z_NO_FLUSH);
+        err = inflateMembers(d_stream);
         
-        if (err == Z_STREAM_END)
+        if (err != Z_BUF_ERROR)
         {
             break;
         }
         
-        switch (err)
-        {
-            case Z_NEED_DICT:
-                err = Z_DATA_ERROR;
-            case Z_DATA_ERROR:
-            case Z_MEM_ERROR:
-                inflateEnd(&d_stream);
-                return err;
-        }
+        // not enough memory
+        unsigned char *tmp = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
         
-        // not enough memory ?
-        if (err != Z_STREAM_END)
+        /* not enough memory, ouch */
+        if (! tmp)
         {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
-            
-            /* not enough memory, ouch */
-            if (! *out )
-            {
-                CCLOG("cocos2d: ZipUtils: realloc failed");
-                inflateEnd(&d_stream);
-                return Z_MEM_ERROR;
-            }
-            
-            d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = static_cast<unsigned int>(bufferSize);
-            bufferSize *= BUFFER_INC_FACTOR;
+            CCLOG("cocos2d: ZipUtils: realloc failed");
+            inflateEnd(&d_stream);
+            return Z_MEM_ERROR;
         }
+        
+        *out = tmp;
+        d_stream.next_out = *out + bufferSize;
+        d_stream.avail_out = static_cast<unsigned int>(bufferSize * (BUFFER_INC_FACTOR - 1));
+        bufferSize *= BUFFER_INC_FACTOR;
+    }
+    
+    if (err != Z_STREAM_END)
+    {
+        inflateEnd(&d_stream);
+        return err;
     }
     
     *outLength = bufferSize - d_stream.avail_out;
@@ -247,88 +294,161 @@ ssize_t ZipUtils::inflateMemory(unsigned char *in, ssize_t inLength, unsigned ch
     return inflateMemoryWithHint(in, inLength, out, 256 * 1024);
 }
 
-int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
+ssize_t ZipUtils::inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength)
 {
-    int len;
-    unsigned int offset = 0;
-    
-    CCASSERT(out, "");
-    CCASSERT(&*out, "");
-    
-    gzFile inFile = gzopen(path, "rb");
-    if( inFile == nullptr ) {
-        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
+
+    d_stream.next_in  = const_cast<unsigned char*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+    d_stream.next_out = out;
+    d_stream.avail_out = static_cast<unsigned int>(outLength);
+
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+    {
         return -1;
     }
-    
-    /* 512k initial decompress buffer */
-    unsigned int bufferSize = 512 * 1024;
-    unsigned int totalBufferSize = bufferSize;
-    
-    *out = (unsigned char*)malloc( bufferSize );
-    if( ! out )
+
+    int err = inflateMembers(d_stream);
+    inflateEnd(&d_stream);
+
+    if (err != Z_STREAM_END)
     {
-        CCLOG("cocos2d: ZipUtils: out of memory");
+        CCLOG("cocos2d: ZipUtils: %s", err == Z_BUF_ERROR ? "inflated data larger than the buffer" : "incorrect zlib compressed data");
         return -1;
     }
-    
-    for (;;) {
-        len = gzread(inFile, *out + offset, bufferSize);
-        if (len < 0)
+
+    return outLength - d_stream.avail_out;
+}
+
+struct InflateWork
+{
+    ZipUtils::InflateJob *jobs;
+    size_t count;
+    // next job to take, guarded by mutex
+    size_t next;
+    pthread_mutex_t mutex;
+};
+
+static void runInflateJobs(InflateWork *work)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&work->mutex);
+        size_t index = work->next++;
+        pthread_mutex_unlock(&work->mutex);
+
+        if (index >= work->count)
         {
-            CCLOG("cocos2d: ZipUtils: error in gzread");
-            free( *out );
-            *out = nullptr;
-            return -1;
+            return;
         }
-        if (len == 0)
+
+        ZipUtils::InflateJob &job = work->jobs[index];
+        job.result = ZipUtils::inflateMemoryToBuffer(job.in, job.inLength, job.out, job.outLength);
+    }
+}
+
+static void* inflateThreadEntry(void *arg)
+{
+    runInflateJobs(static_cast<InflateWork*>(arg));
+    return NULL;
+}
+
+bool ZipUtils::inflateMemoryParallel(InflateJob *jobs, size_t count)
+{
+    ssize_t totalLength = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        totalLength += jobs[i].outLength;
+    }
+
+    InflateWork work;
+    work.jobs = jobs;
+    work.count = count;
+    work.next = 0;
+    pthread_mutex_init(&work.mutex, NULL);
+
+    pthread_t threads[INFLATE_THREAD_COUNT - 1];
+    size_t threadCount = 0;
+    if (totalLength >= INFLATE_PARALLEL_MIN_LENGTH)
+    {
+        size_t wanted = std::min(count, (size_t)INFLATE_THREAD_COUNT) - 1;
+        while (threadCount < wanted && pthread_create(&threads[threadCount], NULL, &inflateThreadEntry, &work) == 0)
         {
-            break;
+            ++threadCount;
         }
-        
-        offset += len;
-        
-        // finish reading the file
-        if( (unsigned int)len < bufferSize )
+    }
+
+    // the calling thread takes jobs too, and does all of them if no thread could start
+    runInflateJobs(&work);
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&work.mutex);
+
+    bool ret = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ret = ret && jobs[i].result >= 0;
+    }
+    return ret;
+}
+
+int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
+{
+    CCASSERT(out, "");
+    
+    // map the file, it is only read, and it also works for the files in the apk
+    MappedData* compressedData = FileUtils::getInstance()->getMappedDataFromFile(path);
+    if (compressedData == nullptr)
+    {
+        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+        return -1;
+    }
+    
+    if (!isGZipBuffer(compressedData->getBytes(), compressedData->getSize()))
+    {
+        // gzread() passes the files which aren't compressed through, so do the callers expect
+        ssize_t size = compressedData->getSize();
+        *out = (unsigned char*)malloc(size > 0 ? size : 1);
+        if (*out && size > 0)
         {
-            break;
+            memcpy(*out, compressedData->getBytes(), size);
         }
-        
-        bufferSize *= BUFFER_INC_FACTOR;
-        totalBufferSize += bufferSize;
-        unsigned char *tmp = (unsigned char*)realloc(*out, totalBufferSize );
-        
-        if( ! tmp )
+        compressedData->release();
+        if (!*out)
         {
             CCLOG("cocos2d: ZipUtils: out of memory");
-            free( *out );
-            *out = nullptr;
             return -1;
         }
-        
-        *out = tmp;
+        return (int)size;
     }
     
-    if (gzclose(inFile) != Z_OK)
-    {
-        CCLOG("cocos2d: ZipUtils: gzclose failed");
-    }
+    // sized from the gzip trailer, grows only for concatenated members
+    ssize_t len = inflateMemoryWithHint(const_cast<unsigned char*>(compressedData->getBytes()), compressedData->getSize(), out, 512 * 1024);
+    compressedData->release();
     
-    return offset;
+    return *out ? (int)len : -1;
 }
 
 bool ZipUtils::isCCZFile(const char *path)
 {
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map the file, only the header is read
+    MappedData* compressedData = FileUtils::getInstance()->getMappedDataFromFile(path);
 
-    if (compressedData.isNull())
+    if (compressedData == nullptr)
     {
         CCLOG("cocos2d: ZipUtils: loading file failed");
         return false;
     }
 
-    return isCCZBuffer(compressedData.getBytes(), compressedData.getSize());
+    bool ret = isCCZBuffer(compressedData->getBytes(), compressedData->getSize());
+    compressedData->release();
+    return ret;
 }
 
 bool ZipUtils::isCCZBuffer(const unsigned char *buffer, ssize_t len)
@@ -345,16 +465,18 @@ bool ZipUtils::isCCZBuffer(const unsigned char *buffer, ssize_t len)
 
 bool ZipUtils::isGZipFile(const char *path)
 {
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map the file, only the header is read
+    MappedData* compressedData = FileUtils::getInstance()->getMappedDataFromFile(path);
 
-    if (compressedData.isNull())
+    if (compressedData == nullptr)
     {
         CCLOG("cocos2d: ZipUtils: loading file failed");
         return false;
     }
 
-    return isGZipBuffer(compressedData.getBytes(), compressedData.getSize());
+    bool ret = isGZipBuffer(compressedData->getBytes(), compressedData->getSize());
+    compressedData->release();
+    return ret;
 }
 
 bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
@@ -367,9 +489,36 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
     return buffer[0] == 0x1F && buffer[1] == 0x8B;
 }
 
+ssize_t ZipUtils::getGZipBufferInflatedLengthHint(const unsigned char *buffer, ssize_t len)
+{
+    // 10 bytes header, 8 bytes trailer
+    if (len < 18 || !isGZipBuffer(buffer, len))
+    {
+        return -1;
+    }
 
-int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+    // ISIZE, little endian
+    const unsigned char *trailer = buffer + len - 4;
+    unsigned int size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((unsigned int)trailer[3] << 24);
+
+    // deflate can't compress more than 1032:1, a larger size is a corrupted trailer
+    if ((double)size > (double)len * 1032)
+    {
+        return -1;
+    }
+    return (ssize_t)size;
+}
+
+const unsigned char* ZipUtils::openCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **decrypted)
 {
+    *decrypted = nullptr;
+
+    if (static_cast<size_t>(bufferLen) < sizeof(struct CCZHeader))
+    {
+        CCLOG("cocos2d: Invalid CCZ file");
+        return nullptr;
+    }
+
     struct CCZHeader *header = (struct CCZHeader*) buffer;
 
     // verify header
@@ -380,38 +529,46 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
         if( version > 2 )
         {
             CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
+            return nullptr;
         }
 
         // verify compression format
         if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
+            return nullptr;
         }
     }
     else if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p' )
     {
         // encrypted ccz file
-        header = (struct CCZHeader*) buffer;
 
         // verify header version
         unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
         if( version > 0 )
         {
             CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
+            return nullptr;
         }
 
         // verify compression format
         if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
+            return nullptr;
+        }
+
+        // decrypt a copy, the buffer may be read only (e.g. a mapped file)
+        *decrypted = (unsigned char*)malloc(bufferLen);
+        if (! *decrypted)
+        {
+            CCLOG("cocos2d: CCZ: Failed to allocate memory for decryption");
+            return nullptr;
         }
+        memcpy(*decrypted, buffer, bufferLen);
+        header = (struct CCZHeader*) *decrypted;
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
+        unsigned int* ints = (unsigned int*)(*decrypted+12);
         ssize_t enclen = (bufferLen-12)/4;
 
         decodeEncodedPvr(ints, enclen);
@@ -424,54 +581,110 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
         if(calculated != required)
         {
             CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
-            return -1;
+            free(*decrypted);
+            *decrypted = nullptr;
+            return nullptr;
         }
 #endif
     }
     else
     {
         CCLOG("cocos2d: Invalid CCZ file");
+        return nullptr;
+    }
+
+    return (const unsigned char*)header;
+}
+
+ssize_t ZipUtils::getCCZBufferInflatedLength(const unsigned char *buffer, ssize_t len)
+{
+    if (!isCCZBuffer(buffer, len))
+    {
         return -1;
     }
 
-    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+    struct CCZHeader *header = (struct CCZHeader*) buffer;
+    unsigned int inflatedLen = header->len;
+    if (header->sig[3] == 'p')
+    {
+        // the length is the first encrypted int
+        decodeEncodedPvr(&inflatedLen, 1);
+    }
+    return CC_SWAP_INT32_BIG_TO_HOST( inflatedLen );
+}
 
-    *out = (unsigned char*)malloc( len );
-    if(! *out )
+ssize_t ZipUtils::inflateCCZBufferToBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char *out, ssize_t outLength)
+{
+    unsigned char* decrypted = nullptr;
+    const unsigned char* source = openCCZBuffer(buffer, bufferLen, &decrypted);
+    if (! source)
     {
-        CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        return -1;
+    }
+
+    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( ((struct CCZHeader*)source)->len );
+    if (outLength < (ssize_t)len)
+    {
+        CCLOG("cocos2d: CCZ: The buffer is too small");
+        free(decrypted);
         return -1;
     }
 
     unsigned long destlen = len;
-    size_t source = (size_t) buffer + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
+    int ret = uncompress(out, &destlen, (Bytef*)source + sizeof(struct CCZHeader), bufferLen - sizeof(struct CCZHeader));
+    free(decrypted);
 
     if( ret != Z_OK )
     {
         CCLOG("cocos2d: CCZ: Failed to uncompress data");
+        return -1;
+    }
+
+    return (ssize_t)destlen;
+}
+
+int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+{
+    ssize_t len = getCCZBufferInflatedLength(buffer, bufferLen);
+    if (len < 0)
+    {
+        CCLOG("cocos2d: Invalid CCZ file");
+        return -1;
+    }
+
+    *out = (unsigned char*)malloc( len );
+    if(! *out )
+    {
+        CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        return -1;
+    }
+
+    if (inflateCCZBufferToBuffer(buffer, bufferLen, *out, len) < 0)
+    {
         free( *out );
         *out = nullptr;
         return -1;
     }
 
-    return len;
+    return (int)len;
 }
 
 int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
 {
     CCASSERT(out, "Invalid pointer for buffer!");
     
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map the file, it is only read
+    MappedData* compressedData = FileUtils::getInstance()->getMappedDataFromFile(path);
     
-    if (compressedData.isNull())
+    if (compressedData == nullptr)
     {
         CCLOG("cocos2d: Error loading CCZ compressed file");
         return -1;
     }
     
-    return inflateCCZBuffer(compressedData.getBytes(), compressedData.getSize(), out);
+    int ret = inflateCCZBuffer(compressedData->getBytes(), compressedData->getSize(), out);
+    compressedData->release();
+    return ret;
 }
 
 void ZipUtils::setPvrEncryptionKeyPart(int index, unsigned int value)
@@ -92,8 +92,37 @@ typedef struct unz_file_info_s unz_file_info;
         CC_DEPRECATED_ATTRIBUTE static ssize_t ccInflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint) { return inflateMemoryWithHint(in, inLength, out, outLengthHint); }
         static ssize_t inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint);
 
+        /**
+         * Inflates either zlib or gzip deflated memory into a buffer of known size, without allocating.
+         * The size may come from a CCZ header or from a TMX layer size. Concatenated gzip members are inflated one after the other.
+         *
+         * @param out       The buffer to inflate into.
+         * @param outLength The size of out.
+         * @return The length of the inflated data, or -1 if the data is invalid or doesn't fit in out.
+         */
+        static ssize_t inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength);
+
+        /** Deflated data inflated by inflateMemoryParallel(). */
+        struct InflateJob
+        {
+            const unsigned char *in;
+            ssize_t inLength;
+            unsigned char *out;
+            ssize_t outLength;
+            /** Set to the result of inflateMemoryToBuffer(). */
+            ssize_t result;
+        };
+
+        /**
+         * Inflates independent chunks of deflated data with inflateMemoryToBuffer() on several threads, e.g. the layers of a tile map.
+         * Small payloads are inflated on the calling thread. Returns when all the jobs are done.
+         *
+         * @return True if every job succeeded.
+         */
+        static bool inflateMemoryParallel(InflateJob *jobs, size_t count);
+
         /** 
-         * Inflates a GZip file into memory.
+         * Inflates a GZip file into memory. A file which isn't compressed is copied as it is, as gzread() does.
          *
          * @return The length of the deflated buffer.
          * @since v0.99.5
@@ -119,6 +148,14 @@ typedef struct unz_file_info_s unz_file_info;
         CC_DEPRECATED_ATTRIBUTE static bool ccIsGZipBuffer(const unsigned char *buffer, ssize_t len) { return isGZipBuffer(buffer, len); }
         static bool isGZipBuffer(const unsigned char *buffer, ssize_t len);
 
+        /**
+         * Gets the inflated length written at the end of a gzip buffer. It is only exact for a single member smaller than 4GB,
+         * so it should be used as a hint.
+         *
+         * @return The inflated length, or -1 if the buffer isn't in gzip format.
+         */
+        static ssize_t getGZipBufferInflatedLengthHint(const unsigned char *buffer, ssize_t len);
+
         /** 
          * Inflates a CCZ file into memory.
          *
@@ -136,6 +173,20 @@ typedef struct unz_file_info_s unz_file_info;
          */
         CC_DEPRECATED_ATTRIBUTE static int ccInflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out) { return inflateCCZBuffer(buffer, len, out); }
         static int inflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out);
+
+        /**
+         * Gets the inflated length written in the header of a CCZ buffer.
+         *
+         * @return The inflated length, or -1 if the buffer isn't in CCZ format.
+         */
+        static ssize_t getCCZBufferInflatedLength(const unsigned char *buffer, ssize_t len);
+
+        /**
+         * Inflates a buffer with CCZ format into a buffer of at least getCCZBufferInflatedLength() bytes, without allocating it.
+         *
+         * @return The length of the inflated data, or -1.
+         */
+        static ssize_t inflateCCZBufferToBuffer(const unsigned char *buffer, ssize_t len, unsigned char *out, ssize_t outLength);
         
         /** 
          * Test a file is a CCZ format file or not.
@@ -209,6 +260,7 @@ typedef struct unz_file_info_s unz_file_info;
 
     private:
         static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLenghtHint);
+        static const unsigned char* openCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **decrypted);
         static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
         static inline unsigned int checksumPvr(const unsigned int *data, ssize_t len);
 
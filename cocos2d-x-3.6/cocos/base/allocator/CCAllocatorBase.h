@@ -28,6 +28,7 @@
 /// @cond DO_NOT_SHOW
 
 #include <string>
+#include <string.h>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/allocator/CCAllocatorMacros.h"
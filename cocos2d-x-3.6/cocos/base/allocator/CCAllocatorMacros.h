@@ -27,6 +27,8 @@
 #define CC_ALLOCATOR_MACROS_H
 /// @cond DO_NOT_SHOW
 
+#include <new>
+
 #include "base/ccConfig.h"
 #include "platform/CCPlatformMacros.h"
 
@@ -87,6 +89,24 @@
             A.deallocate((T*)object, size); \
         }
 
+    #if CC_ENABLE_ALLOCATOR_OBJECT_POOLS
+
+    // @brief declares class level new/delete backed by a pool for the class T.
+    // They are defined with CC_DEFINE_ALLOCATOR_OBJECT_POOL in the source file of the class,
+    // so the objects are always allocated and released by the same pool, across modules too.
+    #define CC_DECLARE_ALLOCATOR_OBJECT_POOL(T) \
+        static void* operator new (size_t size); \
+        static void* operator new (size_t size, const std::nothrow_t&); \
+        static void operator delete (void* object, size_t size); \
+        static void operator delete (void* object, const std::nothrow_t&);
+
+    #else
+
+    #define CC_DECLARE_ALLOCATOR_OBJECT_POOL(...)
+    #define CC_DEFINE_ALLOCATOR_OBJECT_POOL(...)
+
+    #endif
+
 #else
 
     // macros for new/delete
@@ -105,6 +125,8 @@
     // throw these away if not enabled
     #define CC_USE_ALLOCATOR_POOL(...)
     #define CC_OVERRIDE_GLOBAL_NEWDELETE_WITH_ALLOCATOR(...)
+    #define CC_DECLARE_ALLOCATOR_OBJECT_POOL(...)
+    #define CC_DEFINE_ALLOCATOR_OBJECT_POOL(...)
 
 #endif
 
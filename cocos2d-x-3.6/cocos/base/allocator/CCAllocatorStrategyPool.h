@@ -30,6 +30,7 @@
 #include <vector>
 #include <typeinfo>
 #include <sstream>
+#include <pthread.h>
 
 #include "base/allocator/CCAllocatorMacros.h"
 #include "base/allocator/CCAllocatorGlobal.h"
@@ -81,6 +82,28 @@ public:
     }
 };
 
+/**
+ * ObjectTraits which neither construct nor destroy the objects.
+ *
+ * Used by the class level new/delete of CC_DEFINE_ALLOCATOR_OBJECT_POOL,
+ * where the constructor and the destructor are called by the new and delete expressions.
+ *
+ * @param T Type of object.
+ * @param _alignment Alignment of object T.
+ */
+template <typename T, size_t _alignment = AllocatorBase::kDefaultAlignment>
+class StorageObjectTraits
+    : public ObjectTraits<T, _alignment>
+{
+public:
+    
+    void construct(T* address)
+    {}
+    
+    void destroy(T* address)
+    {}
+};
+
 /**
  * Fixed sized pool allocator strategy for objects of type T.
  *
@@ -168,5 +191,48 @@ public:
 NS_CC_ALLOCATOR_END
 NS_CC_END
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ALLOCATOR_OBJECT_POOLS
+
+// @brief defines the class level new/delete declared by CC_DECLARE_ALLOCATOR_OBJECT_POOL.
+// The pool is created by the first allocation, so its page size can be set by the
+// "cocos2d.x.allocator.pool.<T>" key of the Configuration.
+// Subclasses of T have a different size, the pool forwards them to the global allocator.
+#define CC_DEFINE_ALLOCATOR_OBJECT_POOL(T, pageSize) \
+    typedef NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::StorageObjectTraits<T>, CC_ALLOCATOR_OBJECT_POOL_LOCKING> T##AllocatorPool; \
+    static T##AllocatorPool* s_##T##AllocatorPool = nullptr; \
+    static pthread_once_t s_##T##AllocatorPoolOnce = PTHREAD_ONCE_INIT; \
+    static void create##T##AllocatorPool() \
+    { \
+        s_##T##AllocatorPool = new T##AllocatorPool("cocos2d.x.allocator.pool." #T, pageSize); \
+    } \
+    static T##AllocatorPool* get##T##AllocatorPool() \
+    { \
+        pthread_once(&s_##T##AllocatorPoolOnce, &create##T##AllocatorPool); \
+        return s_##T##AllocatorPool; \
+    } \
+    void* T::operator new (size_t size) \
+    { \
+        return get##T##AllocatorPool()->allocate(size); \
+    } \
+    void* T::operator new (size_t size, const std::nothrow_t&) \
+    { \
+        return get##T##AllocatorPool()->allocate(size); \
+    } \
+    void T::operator delete (void* object, size_t size) \
+    { \
+        get##T##AllocatorPool()->deallocate(object, size); \
+    } \
+    void T::operator delete (void* object, const std::nothrow_t&) \
+    { \
+        /* only called if a constructor throws, the size isn't known */ \
+        auto pool = get##T##AllocatorPool(); \
+        if (pool->owns(object)) \
+            pool->deallocate(object, sizeof(T)); \
+        else \
+            NS_CC_ALLOCATOR::ccAllocatorGlobal.deallocate(object); \
+    }
+
+#endif
+
 /// @endcond
 #endif//CC_ALLOCATOR_STRATEGY_POOL_H
@@ -235,6 +235,7 @@ THE SOFTWARE.
 /** @def CC_ENABLE_PROFILERS
  * If enabled, will activate various profilers within cocos2d. This statistical data will be output to the console
  * once per second showing average time (in milliseconds) required to execute the specific routine(s).
+ * It also activates the zones recorded by ZoneProfiler, which can be exported to the Chrome trace format.
  * Useful for debugging purposes only. It is recommended to leave it disabled.
  * To enable set it to a value different than 0. Disabled by default.
  */
@@ -324,6 +325,23 @@ THE SOFTWARE.
 # define CC_ENABLE_ALLOCATOR_DIAGNOSTICS CC_ENABLE_ALLOCATOR
 #endif
 
+/** @def CC_ENABLE_ALLOCATOR_OBJECT_POOLS
+ * Turn on class level new and delete backed by a pool allocator per type
+ * for the most frequently created classes: Node, Sprite, the common actions and EventCustom.
+ * Requires CC_ENABLE_ALLOCATOR.
+ */
+#ifndef CC_ENABLE_ALLOCATOR_OBJECT_POOLS
+# define CC_ENABLE_ALLOCATOR_OBJECT_POOLS 0
+#endif
+
+/** @def CC_ALLOCATOR_OBJECT_POOL_LOCKING
+ * Specify the locking semantics of the object pools.
+ * cocos2d::allocator::lockless_semantics is faster, but only if the pooled classes are created and released on the cocos thread only.
+ */
+#ifndef CC_ALLOCATOR_OBJECT_POOL_LOCKING
+# define CC_ALLOCATOR_OBJECT_POOL_LOCKING cocos2d::allocator::locking_semantics
+#endif
+
 /** @def CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
  * Turn on override of global new and delete
  * as specified by CC_ALLOCATOR_GLOBAL_NEW_DELETE below.
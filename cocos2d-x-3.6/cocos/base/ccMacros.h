@@ -221,6 +221,18 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 #define CC_PROFILER_STOP_INSTANCE(__id__, __name__) do{ NS_CC::ProfilingEndTimingBlock(    NS_CC::String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
 #define CC_PROFILER_RESET_INSTANCE(__id__, __name__) do{ NS_CC::ProfilingResetTimingBlock( NS_CC::String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
 
+#define CC_PROFILER_CONCAT_(__a__, __b__) __a__##__b__
+#define CC_PROFILER_CONCAT(__a__, __b__) CC_PROFILER_CONCAT_(__a__, __b__)
+
+// Records a zone from this line to the end of the enclosing scope, the zone descriptor is static so there is no lookup
+#define CC_PROFILER_ZONE_WITH(__enabled__, __category__, __name__) \
+    static const NS_CC::ProfilingZone CC_PROFILER_CONCAT(__ccProfilingZone, __LINE__) = { __name__, __category__ }; \
+    NS_CC::ProfilingZoneScope CC_PROFILER_CONCAT(__ccProfilingZoneScope, __LINE__)(&CC_PROFILER_CONCAT(__ccProfilingZone, __LINE__), __enabled__)
+// The zone is recorded when the category flag is set, and is traced under the name of the flag, e.g. "kProfilerCategoryNode"
+#define CC_PROFILER_ZONE_CATEGORY(__cat__, __name__) CC_PROFILER_ZONE_WITH(__cat__, #__cat__, __name__)
+#define CC_PROFILER_ZONE(__name__) CC_PROFILER_ZONE_WITH(true, "cocos2d", __name__)
+#define CC_PROFILER_THREAD_NAME(__name__) NS_CC::ZoneProfiler::getInstance()->setCurrentThreadName(__name__)
+
 
 #else
 
@@ -239,6 +251,11 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 #define CC_PROFILER_STOP_INSTANCE(__id__, __name__) do {} while(0)
 #define CC_PROFILER_RESET_INSTANCE(__id__, __name__) do {} while(0)
 
+#define CC_PROFILER_ZONE_WITH(__enabled__, __category__, __name__) do {} while(0)
+#define CC_PROFILER_ZONE_CATEGORY(__cat__, __name__) do {} while(0)
+#define CC_PROFILER_ZONE(__name__) do {} while(0)
+#define CC_PROFILER_THREAD_NAME(__name__) do {} while(0)
+
 #endif
 
 #if !defined(COCOS2D_DEBUG) || COCOS2D_DEBUG == 0
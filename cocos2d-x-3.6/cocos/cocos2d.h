@@ -45,6 +45,8 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCNS.h"
 #include "base/CCData.h"
+#include "base/CCMappedData.h"
+#include "base/CCAssetPack.h"
 #include "base/CCValue.h"
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
@@ -107,6 +109,8 @@ THE SOFTWARE.
 
 // 2d nodes
 #include "2d/CCNode.h"
+#include "2d/CCNodePathQuery.h"
+#include "2d/CCNodePool.h"
 #include "2d/CCProtectedNode.h"
 #include "2d/CCAtlasNode.h"
 #include "2d/CCDrawingPrimitives.h"
@@ -177,6 +181,7 @@ THE SOFTWARE.
 #include "platform/CCDevice.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCAsyncFileReader.h"
 #include "platform/CCImage.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCThread.h"
@@ -426,9 +426,11 @@ ActionTimeline* ActionTimelineCache::loadAnimationActionWithFlatBuffersFile(cons
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
-    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    MappedData* buf = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
+    if (buf == nullptr)
+        return nullptr;
     
-    auto csparsebinary = GetCSParseBinary(buf.getBytes());
+    auto csparsebinary = GetCSParseBinary(buf->getBytes());
     
     auto nodeAction = csparsebinary->action();    
     action = ActionTimeline::create();
@@ -462,6 +464,7 @@ ActionTimeline* ActionTimelineCache::loadAnimationActionWithFlatBuffersFile(cons
     }
     
     _animationActions.insert(fileName, action);
+    buf->release();
     
     return action;
 }
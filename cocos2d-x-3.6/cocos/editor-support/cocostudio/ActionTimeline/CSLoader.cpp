@@ -834,9 +834,12 @@ Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName, const ccNod
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
-    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    // the flatbuffers are read in place from the mapped file
+    MappedData* buf = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
+    if (buf == nullptr)
+        return nullptr;
     
-    auto csparsebinary = GetCSParseBinary(buf.getBytes());
+    auto csparsebinary = GetCSParseBinary(buf->getBytes());
     
     
     auto csBuildId = csparsebinary->version();
@@ -866,6 +869,7 @@ Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName, const ccNod
     }
     
     Node* node = nodeWithFlatBuffers(csparsebinary->nodeTree(), callback);
+    buf->release();
     
     return node;
 }
@@ -124,11 +124,11 @@ bool Armature::init(const std::string& name)
 
         _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 
-        _name = name;
+        setName(name);
 
         ArmatureDataManager *armatureDataManager = ArmatureDataManager::getInstance();
 
-        if(!_name.empty())
+        if(!name.empty())
         {
             AnimationData *animationData = armatureDataManager->getAnimationData(name);
             CCASSERT(animationData, "AnimationData not exist! ");
@@ -171,15 +171,15 @@ bool Armature::init(const std::string& name)
         }
         else
         {
-            _name = "new_armature";
+            setName("new_armature");
             _armatureData = ArmatureData::create();
-            _armatureData->name = _name;
+            _armatureData->name = getName();
 
             AnimationData *animationData = AnimationData::create();
-            animationData->name = _name;
+            animationData->name = getName();
 
-            armatureDataManager->addArmatureData(_name.c_str(), _armatureData);
-            armatureDataManager->addAnimationData(_name.c_str(), animationData);
+            armatureDataManager->addArmatureData(_armatureData->name.c_str(), _armatureData);
+            armatureDataManager->addAnimationData(_armatureData->name.c_str(), animationData);
 
             _animation->setAnimationData(animationData);
 
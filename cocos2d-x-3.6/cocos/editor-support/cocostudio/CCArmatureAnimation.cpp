@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "cocostudio/CCUtilMath.h"
 #include "cocostudio/CCDatas.h"
 
+#include "base/CCDirector.h"
+
 using namespace cocos2d;
 
 
@@ -350,6 +352,12 @@ ssize_t ArmatureAnimation::getMovementCount() const
 void ArmatureAnimation::update(float dt)
 {
     ProcessBase::update(dt);
+
+    // bones are posed every tick while playing, keep render on demand drawing
+    if (_isPlaying && !_isPause)
+    {
+        Director::getInstance()->requestRedraw();
+    }
     
     //for (const auto &tween : _tweenList)
     for (auto p_tween = _tweenList.begin(); p_tween != _tweenList.end(); ++p_tween)
@@ -107,7 +107,7 @@ bool Bone::init(const std::string& name)
     do
     {
 
-        _name = name;
+        setName(name);
 
         CC_SAFE_DELETE(_tweenData);
         _tweenData = new (std::nothrow) FrameData();
@@ -144,7 +144,7 @@ void Bone::setBoneData(BoneData *boneData)
         _boneData = boneData;
     }
 
-    _name = _boneData->name;
+    setName(_boneData->name);
     _localZOrder = _boneData->zOrder;
 
     _displayManager->initDisplayList(boneData);
@@ -0,0 +1,326 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/CCAsyncFileReader.h"
+
+#include <algorithm>
+
+#include "base/ccMacros.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCProfiling.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+// Reads are mostly waiting on the storage, a couple of threads keep it busy
+static const int THREAD_COUNT = 2;
+
+AsyncFileReader* AsyncFileReader::s_sharedReader = nullptr;
+
+AsyncFileReader* AsyncFileReader::getInstance()
+{
+    if (s_sharedReader == nullptr)
+    {
+        s_sharedReader = new (std::nothrow) AsyncFileReader();
+    }
+    return s_sharedReader;
+}
+
+void AsyncFileReader::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedReader);
+}
+
+AsyncFileReader::AsyncFileReader()
+: _quit(false)
+, _nextRequestId(1)
+, _nextSequence(0)
+{
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_condition, NULL);
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    pthread_mutex_lock(&_mutex);
+    _quit = true;
+    pthread_mutex_unlock(&_mutex);
+    pthread_cond_broadcast(&_condition);
+
+    //for (auto& thread : _threads)
+    for (auto p_thread = _threads.begin(); p_thread != _threads.end(); ++p_thread)
+    {
+        pthread_join(*p_thread, NULL);
+    }
+
+    // every job, pending, read or finished, is still listed by path until its callbacks are called
+    //for (auto& job : _jobs)
+    for (auto p_job = _jobs.begin(); p_job != _jobs.end(); ++p_job)
+    {
+        delete p_job->second;
+    }
+
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_mutex);
+}
+
+void AsyncFileReader::startThreads()
+{
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &AsyncFileReader::threadEntry, this) == 0)
+        {
+            _threads.push_back(thread);
+        }
+    }
+    CCASSERT(!_threads.empty(), "Failed to start the I/O threads");
+}
+
+unsigned int AsyncFileReader::readData(const std::string& filename, const DataCallback& callback, int priority)
+{
+    Request request;
+    request.dataCallback = callback;
+    return enqueue(filename, request, priority);
+}
+
+unsigned int AsyncFileReader::readString(const std::string& filename, const StringCallback& callback, int priority)
+{
+    Request request;
+    request.stringCallback = callback;
+    return enqueue(filename, request, priority);
+}
+
+unsigned int AsyncFileReader::enqueue(const std::string& filename, const Request& request, int priority)
+{
+    CCASSERT(!filename.empty(), "Invalid filename");
+
+    if (_threads.empty())
+    {
+        startThreads();
+    }
+
+    // resolved here, the search paths and the path cache belong to the cocos thread
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        // still read, so the callback is called as for any other failure
+        fullPath = filename;
+    }
+
+    Request added = request;
+    added.id = _nextRequestId++;
+    // 0 is never used, so it can stand for no request
+    if (_nextRequestId == 0)
+        _nextRequestId = 1;
+
+    Job* job = nullptr;
+    auto iter = _jobs.find(fullPath);
+    if (iter != _jobs.end())
+    {
+        // coalesced with the read in flight
+        job = iter->second;
+        pthread_mutex_lock(&_mutex);
+        job->priority = std::max(job->priority, priority);
+        pthread_mutex_unlock(&_mutex);
+    }
+    else
+    {
+        job = new (std::nothrow) Job();
+        job->fullPath = fullPath;
+        job->priority = priority;
+        job->sequence = _nextSequence++;
+        job->started = false;
+        _jobs[fullPath] = job;
+
+        pthread_mutex_lock(&_mutex);
+        _pendingJobs.push_back(job);
+        pthread_mutex_unlock(&_mutex);
+        pthread_cond_signal(&_condition);
+    }
+
+    job->requests.push_back(added);
+    _requests[added.id] = job;
+    return added.id;
+}
+
+bool AsyncFileReader::cancel(unsigned int requestId)
+{
+    auto iter = _requests.find(requestId);
+    if (iter == _requests.end())
+        return false;
+
+    Job* job = iter->second;
+    _requests.erase(iter);
+
+    for (auto request = job->requests.begin(); request != job->requests.end(); ++request)
+    {
+        if (request->id == requestId)
+        {
+            job->requests.erase(request);
+            break;
+        }
+    }
+
+    if (job->requests.empty())
+    {
+        // nobody waits for the job anymore, drop it unless a thread is reading it
+        pthread_mutex_lock(&_mutex);
+        bool dropped = !job->started;
+        if (dropped)
+        {
+            _pendingJobs.erase(std::find(_pendingJobs.begin(), _pendingJobs.end(), job));
+        }
+        pthread_mutex_unlock(&_mutex);
+
+        if (dropped)
+        {
+            _jobs.erase(job->fullPath);
+            delete job;
+        }
+    }
+    return true;
+}
+
+void AsyncFileReader::cancelAll()
+{
+    while (!_requests.empty())
+    {
+        cancel(_requests.begin()->first);
+    }
+}
+
+AsyncFileReader::Job* AsyncFileReader::takeNextJob()
+{
+    // the highest priority, then the oldest request
+    auto next = _pendingJobs.begin();
+    for (auto iter = next + 1; iter < _pendingJobs.end(); ++iter)
+    {
+        if ((*iter)->priority > (*next)->priority
+            || ((*iter)->priority == (*next)->priority && (int)((*iter)->sequence - (*next)->sequence) < 0))
+        {
+            next = iter;
+        }
+    }
+
+    Job* job = *next;
+    _pendingJobs.erase(next);
+    job->started = true;
+    return job;
+}
+
+void* AsyncFileReader::threadEntry(void* arg)
+{
+    static_cast<AsyncFileReader*>(arg)->threadLoop();
+    return NULL;
+}
+
+void AsyncFileReader::threadLoop()
+{
+    CC_PROFILER_THREAD_NAME("AsyncFileReader");
+
+    pthread_mutex_lock(&_mutex);
+    while (true)
+    {
+        while (_pendingJobs.empty() && !_quit)
+        {
+            pthread_cond_wait(&_condition, &_mutex);
+        }
+        if (_quit)
+            break;
+
+        Job* job = takeNextJob();
+        pthread_mutex_unlock(&_mutex);
+
+        Data data;
+        {
+            CC_PROFILER_ZONE("AsyncFileReader::read");
+            data = FileUtils::getInstance()->getDataFromFile(job->fullPath);
+        }
+
+        pthread_mutex_lock(&_mutex);
+        job->result = std::move(data);
+        bool first = _finishedJobs.empty();
+        _finishedJobs.push_back(job);
+
+        if (first)
+        {
+            // one call for all the jobs finished until the cocos thread runs it
+            pthread_mutex_unlock(&_mutex);
+            Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([]() {
+                if (s_sharedReader)
+                    s_sharedReader->dispatchFinished();
+            });
+            pthread_mutex_lock(&_mutex);
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+void AsyncFileReader::dispatchFinished()
+{
+    std::vector<Job*> finished;
+    pthread_mutex_lock(&_mutex);
+    finished.swap(_finishedJobs);
+    pthread_mutex_unlock(&_mutex);
+
+    //for (auto& job : finished)
+    for (auto p_job = finished.begin(); p_job != finished.end(); ++p_job)
+    {
+        Job* job = *p_job;
+        // requests made from the callbacks start a new read
+        _jobs.erase(job->fullPath);
+
+        std::string content;
+        bool contentMade = false;
+
+        // copied, the callbacks may cancel the requests which weren't called yet
+        std::vector<Request> requests = job->requests;
+        //for (auto& request : requests)
+        for (auto p_request = requests.begin(); p_request != requests.end(); ++p_request)
+        {
+            auto iter = _requests.find(p_request->id);
+            if (iter == _requests.end() || iter->second != job)
+                continue;
+            _requests.erase(iter);
+
+            if (p_request->dataCallback)
+            {
+                p_request->dataCallback(job->result);
+            }
+            else if (p_request->stringCallback)
+            {
+                if (!contentMade && !job->result.isNull())
+                {
+                    content.assign((const char*)job->result.getBytes(), job->result.getSize());
+                }
+                contentMade = true;
+                p_request->stringCallback(content);
+            }
+        }
+        delete job;
+    }
+}
+
+NS_CC_END
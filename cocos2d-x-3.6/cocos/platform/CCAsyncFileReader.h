@@ -0,0 +1,147 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_ASYNC_FILE_READER_H__
+#define __CC_ASYNC_FILE_READER_H__
+
+#include <pthread.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup support
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class AsyncFileReader
+ * @brief Reads files on a pool of I/O threads, for FileUtils::getDataFromFileAsync() and FileUtils::getStringFromFileAsync().
+ *
+ * The pending reads are served by priority, then in the order they were requested. Requests for a file
+ * which is already being read are merged with the read in flight, which gets the highest of their priorities.
+ * The callbacks are called on the cocos thread, once per request, unless the request was canceled.
+ * Requests are made and canceled on the cocos thread.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AsyncFileReader
+{
+public:
+    typedef std::function<void(const Data&)> DataCallback;
+    typedef std::function<void(const std::string&)> StringCallback;
+
+    /** Gets the shared reader, the threads are started with the first request. */
+    static AsyncFileReader* getInstance();
+
+    /** Destroys the shared reader. The pending requests are dropped without calling their callbacks. */
+    static void destroyInstance();
+
+    /**
+     * Requests a file to be read as data.
+     * @param filename The file, searched like FileUtils::getDataFromFile() does, on the calling thread.
+     * @param callback Called on the cocos thread with the content, Data::Null if the file can't be read.
+     * @param priority The requests with the highest priority are served first.
+     * @return The id of the request, to cancel it.
+     */
+    unsigned int readData(const std::string& filename, const DataCallback& callback, int priority);
+
+    /** Same as readData(), with the content given as a string. */
+    unsigned int readString(const std::string& filename, const StringCallback& callback, int priority);
+
+    /**
+     * Cancels a request. Its callback won't be called. The file is still read if it was already being read.
+     * @return False if the request already completed or was canceled.
+     */
+    bool cancel(unsigned int requestId);
+
+    /** Cancels all the requests. */
+    void cancelAll();
+
+    /** Gets the number of requests waiting for their callback. */
+    size_t getPendingCount() const { return _requests.size(); }
+
+protected:
+    struct Request
+    {
+        unsigned int id;
+        DataCallback dataCallback;
+        StringCallback stringCallback;
+    };
+
+    struct Job
+    {
+        std::string fullPath;
+        int priority;
+        unsigned int sequence;
+        bool started;
+        /** Only touched on the cocos thread */
+        std::vector<Request> requests;
+        /** Written by the I/O thread */
+        Data result;
+    };
+
+    AsyncFileReader();
+    ~AsyncFileReader();
+
+    unsigned int enqueue(const std::string& filename, const Request& request, int priority);
+    void startThreads();
+    Job* takeNextJob();
+    void dispatchFinished();
+
+    static void* threadEntry(void* arg);
+    void threadLoop();
+
+    std::vector<pthread_t> _threads;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _condition;
+    bool _quit;
+
+    /** Jobs not started yet, guarded by _mutex */
+    std::vector<Job*> _pendingJobs;
+    /** Jobs read, waiting for their callbacks, guarded by _mutex */
+    std::vector<Job*> _finishedJobs;
+    /** Jobs pending or being read, by full path, only touched on the cocos thread */
+    std::unordered_map<std::string, Job*> _jobs;
+    /** Job of each request, only touched on the cocos thread */
+    std::unordered_map<unsigned int, Job*> _requests;
+
+    unsigned int _nextRequestId;
+    unsigned int _nextSequence;
+
+    static AsyncFileReader* s_sharedReader;
+};
+
+NS_CC_END
+
+// end of support group
+/// @}
+
+#endif // __CC_ASYNC_FILE_READER_H__
@@ -25,13 +25,15 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 
-#include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "platform/CCSAXParser.h"
 #include "base/ccUtils.h"
+#include "base/CCAssetPack.h"
+#include "platform/CCAsyncFileReader.h"
+#include "platform/CCValueFormats.h"
 
 #include "tinyxml2.h"
 #ifdef MINIZIP_FROM_SYSTEM
@@ -61,303 +63,479 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
-typedef enum 
-{
-    SAX_NONE = 0,
-    SAX_KEY,
-    SAX_DICT,
-    SAX_INT,
-    SAX_REAL,
-    SAX_STRING,
-    SAX_ARRAY
-}SAXState;
-
-typedef enum
-{
-    SAX_RESULT_NONE = 0,
-    SAX_RESULT_DICT,
-    SAX_RESULT_ARRAY
-}SAXResult;
-
-class DictMaker : public SAXDelegator
+// Single pass parser of the XML plists: the values are built as the tags are read, without an XML document.
+// The text is appended to the strings from the input buffer, only the entities are decoded on the way.
+class PlistParser
 {
 public:
-    SAXResult _resultType;
-	ValueMap _rootDict;
-	ValueVector _rootArray;
-
-    std::string _curKey;   ///< parsed key
-    std::string _curValue; // parsed value
-    SAXState _state;
-
-	ValueMap*  _curDict;
-    ValueVector* _curArray;
-
-	std::stack<ValueMap*> _dictStack;
-    std::stack<ValueVector*> _arrayStack;
-    std::stack<SAXState>  _stateStack;
-
-public:
-    DictMaker()        
-        : _resultType(SAX_RESULT_NONE)
-    {
-    }
-
-    ~DictMaker()
+    PlistParser(const char* data, size_t size)
+    : _begin(data)
+    , _cur(data)
+    , _end(data + size)
+    , _depth(0)
     {
     }
 
-    ValueMap dictionaryWithContentsOfFile(const std::string& fileName)
+    // Parses the value in <plist>, or the root value if there is no <plist> tag
+    bool parseRoot(Value& root)
     {
-        _resultType = SAX_RESULT_DICT;
-        SAXParser parser;
+        // UTF-8 BOM
+        if (_end - _cur >= 3 && (unsigned char)_cur[0] == 0xEF && (unsigned char)_cur[1] == 0xBB && (unsigned char)_cur[2] == 0xBF)
+            _cur += 3;
 
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
+        Tag tag;
+        if (!readTag(tag) || tag.closing)
+            return false;
 
-        parser.parse(fileName);
-		return _rootDict;
+        if (tag.is("plist"))
+        {
+            if (tag.selfClosing || !readTag(tag) || tag.closing)
+                return false;
+        }
+        return parseValue(tag, root);
     }
 
-	ValueMap dictionaryWithDataOfFile(const char* filedata, int filesize)
-	{
-		_resultType = SAX_RESULT_DICT;
-		SAXParser parser;
+    // Offset where the parsing stopped, for the error messages
+    int getOffset() const { return (int)(_cur - _begin); }
 
-		CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-		parser.setDelegator(this);
+private:
+    // Nesting limit of the dictionaries and arrays, so a broken file can't exhaust the stack
+    static const int MAX_DEPTH = 256;
 
-		parser.parse(filedata, filesize);
-		return _rootDict;
-	}
-
-    ValueVector arrayWithContentsOfFile(const std::string& fileName)
+    struct Tag
     {
-        _resultType = SAX_RESULT_ARRAY;
-        SAXParser parser;
+        const char* name;
+        size_t length;
+        bool closing;
+        bool selfClosing;
 
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
+        bool is(const char* other) const
+        {
+            return strncmp(name, other, length) == 0 && other[length] == '\0';
+        }
+    };
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
 
-        parser.parse(fileName);
-		return _rootArray;
+    bool startsWith(const char* prefix) const
+    {
+        size_t length = strlen(prefix);
+        return (size_t)(_end - _cur) >= length && memcmp(_cur, prefix, length) == 0;
     }
 
-    void startElement(void *ctx, const char *name, const char **atts)
+    // Moves past the next occurrence of marker
+    bool skipPast(const char* marker)
     {
-        CC_UNUSED_PARAM(ctx);
-        CC_UNUSED_PARAM(atts);
-        const std::string sName(name);
-        if( sName == "dict" )
+        size_t length = strlen(marker);
+        for (; (size_t)(_end - _cur) >= length; ++_cur)
         {
-			if(_resultType == SAX_RESULT_DICT && _rootDict.empty())
+            if (memcmp(_cur, marker, length) == 0)
             {
-                _curDict = &_rootDict;
+                _cur += length;
+                return true;
             }
+        }
+        _cur = _end;
+        return false;
+    }
 
-            _state = SAX_DICT;
+    // Reads the next element tag, skipping the white spaces, the comments, the XML declaration and the DOCTYPE
+    bool readTag(Tag& tag)
+    {
+        while (true)
+        {
+            while (_cur < _end && isSpace(*_cur))
+                ++_cur;
+            if (_cur >= _end || *_cur != '<')
+                return false;
 
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
+            if (startsWith("<?"))
             {
-                preState = _stateStack.top();
+                if (!skipPast("?>"))
+                    return false;
             }
-
-            if (SAX_ARRAY == preState)
+            else if (startsWith("<!--"))
             {
-                // add a new dictionary into the array
-                _curArray->push_back(Value(ValueMap()));
-				_curDict = &(_curArray->rbegin())->asValueMap();
+                if (!skipPast("-->"))
+                    return false;
             }
-            else if (SAX_DICT == preState)
+            else if (startsWith("<!"))
             {
-                // add a new dictionary into the pre dictionary
-                CCASSERT(! _dictStack.empty(), "The state is wrong!");
-                ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-				_curDict = &(*preDict)[_curKey].asValueMap();
+                if (!skipPast(">"))
+                    return false;
             }
-
-            // record the dict state
-            _stateStack.push(_state);
-            _dictStack.push(_curDict);
-        }
-        else if(sName == "key")
-        {
-            _state = SAX_KEY;
-        }
-        else if(sName == "integer")
-        {
-            _state = SAX_INT;
-        }
-        else if(sName == "real")
-        {
-            _state = SAX_REAL;
-        }
-        else if(sName == "string")
-        {
-            _state = SAX_STRING;
-        }
-        else if (sName == "array")
-        {
-            _state = SAX_ARRAY;
-
-			if (_resultType == SAX_RESULT_ARRAY && _rootArray.empty())
+            else
             {
-				_curArray = &_rootArray;
+                break;
             }
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
+        }
+
+        ++_cur;
+        tag.closing = _cur < _end && *_cur == '/';
+        if (tag.closing)
+            ++_cur;
+
+        tag.name = _cur;
+        while (_cur < _end && !isSpace(*_cur) && *_cur != '/' && *_cur != '>')
+            ++_cur;
+        tag.length = _cur - tag.name;
+
+        // the attributes aren't used, but their values may contain '>'
+        char quote = 0;
+        for (; _cur < _end; ++_cur)
+        {
+            if (quote)
             {
-                preState = _stateStack.top();
+                if (*_cur == quote)
+                    quote = 0;
             }
-
-            if (preState == SAX_DICT)
+            else if (*_cur == '"' || *_cur == '\'')
             {
-                (*_curDict)[_curKey] = Value(ValueVector());
-				_curArray = &(*_curDict)[_curKey].asValueVector();
+                quote = *_cur;
             }
-            else if (preState == SAX_ARRAY)
+            else if (*_cur == '>')
             {
-                CCASSERT(! _arrayStack.empty(), "The state is wrong!");
-                ValueVector* preArray = _arrayStack.top();
-                preArray->push_back(Value(ValueVector()));
-				_curArray = &(_curArray->rbegin())->asValueVector();
+                break;
             }
-            // record the array state
-            _stateStack.push(_state);
-            _arrayStack.push(_curArray);
+        }
+        if (_cur >= _end)
+            return false;
+
+        tag.selfClosing = _cur[-1] == '/' && !tag.closing;
+        ++_cur;
+        return tag.length > 0;
+    }
+
+    bool readClosingTag(const Tag& opening)
+    {
+        Tag tag;
+        return readTag(tag) && tag.closing && tag.length == opening.length && memcmp(tag.name, opening.name, tag.length) == 0;
+    }
+
+    static void appendUTF8(std::string& text, unsigned long code)
+    {
+        if (code < 0x80)
+        {
+            text += (char)code;
+        }
+        else if (code < 0x800)
+        {
+            text += (char)(0xC0 | (code >> 6));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            text += (char)(0xE0 | (code >> 12));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
         }
         else
         {
-            _state = SAX_NONE;
+            text += (char)(0xF0 | (code >> 18));
+            text += (char)(0x80 | ((code >> 12) & 0x3F));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
         }
     }
 
-    void endElement(void *ctx, const char *name)
+    static void appendDecoded(std::string& text, const char* start, const char* end)
     {
-        CC_UNUSED_PARAM(ctx);
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string sName((char*)name);
-        if( sName == "dict" )
+        static const struct { const char* name; size_t length; char value; } entities[] = {
+            { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&amp;", 5, '&' }, { "&quot;", 6, '"' }, { "&apos;", 6, '\'' }
+        };
+
+        while (start < end)
         {
-            _stateStack.pop();
-            _dictStack.pop();
-            if ( !_dictStack.empty())
+            const char* amp = (const char*)memchr(start, '&', end - start);
+            if (!amp)
             {
-                _curDict = _dictStack.top();
+                text.append(start, end);
+                return;
             }
-        }
-        else if (sName == "array")
-        {
-            _stateStack.pop();
-            _arrayStack.pop();
-            if (! _arrayStack.empty())
+            text.append(start, amp);
+            start = amp;
+
+            bool decoded = false;
+            if (amp + 2 < end && amp[1] == '#')
             {
-                _curArray = _arrayStack.top();
+                char* last = nullptr;
+                bool hex = amp[2] == 'x' || amp[2] == 'X';
+                unsigned long code = strtoul(amp + (hex ? 3 : 2), &last, hex ? 16 : 10);
+                if (last < end && *last == ';' && code > 0 && code <= 0x10FFFF)
+                {
+                    appendUTF8(text, code);
+                    start = last + 1;
+                    decoded = true;
+                }
             }
-        }
-        else if (sName == "true")
-        {
-            if (SAX_ARRAY == curState)
+            else
             {
-                _curArray->push_back(Value(true));
+                for (size_t i = 0; i < sizeof(entities) / sizeof(entities[0]); ++i)
+                {
+                    if ((size_t)(end - amp) >= entities[i].length && memcmp(amp, entities[i].name, entities[i].length) == 0)
+                    {
+                        text += entities[i].value;
+                        start += entities[i].length;
+                        decoded = true;
+                        break;
+                    }
+                }
             }
-            else if (SAX_DICT == curState)
+
+            if (!decoded)
             {
-                (*_curDict)[_curKey] = Value(true);
+                // not an entity, kept as is
+                text += '&';
+                ++start;
             }
         }
-        else if (sName == "false")
+    }
+
+    // Reads the text of an element up to its closing tag
+    bool readText(const Tag& tag, std::string& text)
+    {
+        if (tag.selfClosing)
+            return true;
+
+        while (true)
         {
-            if (SAX_ARRAY == curState)
+            const char* start = _cur;
+            const char* lt = (const char*)memchr(_cur, '<', _end - _cur);
+            if (!lt)
+                return false;
+            appendDecoded(text, start, lt);
+            _cur = lt;
+
+            if (startsWith("<![CDATA["))
             {
-                _curArray->push_back(Value(false));
+                const char* data = _cur + 9;
+                if (!skipPast("]]>"))
+                    return false;
+                text.append(data, _cur - 3);
             }
-            else if (SAX_DICT == curState)
+            else if (startsWith("<!--"))
             {
-                (*_curDict)[_curKey] = Value(false);
+                if (!skipPast("-->"))
+                    return false;
             }
-        }
-        else if (sName == "string" || sName == "integer" || sName == "real")
-        {
-            if (SAX_ARRAY == curState)
+            else
             {
-                if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
-                else if (sName == "integer")
-                    _curArray->push_back(Value(atoi(_curValue.c_str())));
-                else
-                    _curArray->push_back(Value(utils::atof(_curValue.c_str())));
+                return readClosingTag(tag);
             }
-            else if (SAX_DICT == curState)
+        }
+    }
+
+    // Reads the text of a number into buffer, null terminated
+    bool readNumber(const Tag& tag, char* buffer, size_t size)
+    {
+        std::string& text = _scratch;
+        text.clear();
+        if (!readText(tag, text))
+            return false;
+
+        size_t length = std::min(text.length(), size - 1);
+        memcpy(buffer, text.c_str(), length);
+        buffer[length] = '\0';
+        return true;
+    }
+
+    // Skips an element which isn't a plist value, e.g. <data> or <date>
+    bool skipElement(const Tag& tag)
+    {
+        if (tag.selfClosing)
+            return true;
+
+        int depth = 1;
+        while (depth > 0)
+        {
+            const char* lt = (const char*)memchr(_cur, '<', _end - _cur);
+            if (!lt)
+                return false;
+            _cur = lt;
+
+            if (startsWith("<![CDATA["))
             {
-                if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
-                else if (sName == "integer")
-                    (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
-                else
-                    (*_curDict)[_curKey] = Value(utils::atof(_curValue.c_str()));
+                if (!skipPast("]]>"))
+                    return false;
+                continue;
             }
 
-            _curValue.clear();
+            Tag inner;
+            if (!readTag(inner))
+                return false;
+            if (inner.closing)
+                --depth;
+            else if (!inner.selfClosing)
+                ++depth;
         }
-        
-        _state = SAX_NONE;
+        return true;
     }
 
-    void textHandler(void *ctx, const char *ch, int len)
+    // Parses the value starting with tag, value is left null for the elements which aren't values
+    bool parseValue(const Tag& tag, Value& value)
     {
-        CC_UNUSED_PARAM(ctx);
-        if (_state == SAX_NONE)
+        if (tag.is("dict"))
         {
-            return;
-        }
-
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,len);
+            ValueMap dict;
+            if (!tag.selfClosing)
+            {
+                if (++_depth > MAX_DEPTH)
+                    return false;
 
-        switch(_state)
+                Tag keyTag;
+                while (readTag(keyTag))
+                {
+                    if (keyTag.closing)
+                    {
+                        --_depth;
+                        value = std::move(dict);
+                        return keyTag.is("dict");
+                    }
+
+                    std::string key;
+                    Tag valueTag;
+                    if (!keyTag.is("key") || !readText(keyTag, key) || !readTag(valueTag) || valueTag.closing)
+                        return false;
+
+                    Value entry;
+                    if (!parseValue(valueTag, entry))
+                        return false;
+                    if (!entry.isNull())
+                        dict[std::move(key)] = std::move(entry);
+                }
+                return false;
+            }
+            value = std::move(dict);
+        }
+        else if (tag.is("array"))
         {
-        case SAX_KEY:
-            _curKey = text;
-            break;
-        case SAX_INT:
-        case SAX_REAL:
-        case SAX_STRING:
+            ValueVector array;
+            if (!tag.selfClosing)
             {
-                if (curState == SAX_DICT)
+                if (++_depth > MAX_DEPTH)
+                    return false;
+
+                Tag itemTag;
+                while (readTag(itemTag))
                 {
-                    CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
+                    if (itemTag.closing)
+                    {
+                        --_depth;
+                        value = std::move(array);
+                        return itemTag.is("array");
+                    }
+
+                    Value item;
+                    if (!parseValue(itemTag, item))
+                        return false;
+                    if (!item.isNull())
+                        array.push_back(std::move(item));
                 }
-                
-                _curValue.append(text);
+                return false;
             }
-            break;
-        default:
-            break;
+            value = std::move(array);
+        }
+        else if (tag.is("string"))
+        {
+            std::string& text = _scratch;
+            text.clear();
+            if (!readText(tag, text))
+                return false;
+            // a short string is copied inside the value and the scratch buffer is reused
+            value = std::move(text);
+        }
+        else if (tag.is("integer"))
+        {
+            char buffer[64];
+            if (!readNumber(tag, buffer, sizeof(buffer)))
+                return false;
+            value = atoi(buffer);
+        }
+        else if (tag.is("real"))
+        {
+            char buffer[64];
+            if (!readNumber(tag, buffer, sizeof(buffer)))
+                return false;
+            value = utils::atof(buffer);
+        }
+        else if (tag.is("true") || tag.is("false"))
+        {
+            value = tag.is("true");
+            return tag.selfClosing || readClosingTag(tag);
         }
+        else
+        {
+            return skipElement(tag);
+        }
+        return true;
     }
+
+    const char* _begin;
+    const char* _cur;
+    const char* _end;
+    int _depth;
+    // reused for the numbers and the strings
+    std::string _scratch;
 };
 
+static bool parsePlist(const char* data, size_t size, const std::string& name, Value& root)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    if (BinaryPlist::isBinaryPlist(bytes, size) || CompiledValue::isCompiledValue(bytes, size))
+    {
+        bool binary = BinaryPlist::isBinaryPlist(bytes, size);
+        if (binary ? BinaryPlist::read(bytes, size, root) : CompiledValue::read(bytes, size, root))
+            return true;
+
+        CCLOG("cocos2d: %s is a corrupted %s.", name.c_str(), binary ? "binary plist" : "compiled value");
+        return false;
+    }
+
+    PlistParser parser(data, size);
+    if (!parser.parseRoot(root))
+    {
+        CCLOG("cocos2d: %s isn't a valid plist, error at offset %d.", name.c_str(), parser.getOffset());
+        return false;
+    }
+    return true;
+}
+
 ValueMap FileUtils::getValueMapFromFile(const std::string& filename)
 {
-    const std::string fullPath = fullPathForFilename(filename.c_str());
-    DictMaker tMaker;
-    return tMaker.dictionaryWithContentsOfFile(fullPath.c_str());
+    ValueMap ret;
+    Data data = getDataFromFile(filename);
+    Value root;
+    if (!data.isNull() && parsePlist((const char*)data.getBytes(), data.getSize(), filename, root) && root.getType() == Value::Type::MAP)
+    {
+        ret.swap(root.asValueMap());
+    }
+    return ret;
 }
 
 ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize)
 {
-    DictMaker tMaker;
-    return tMaker.dictionaryWithDataOfFile(filedata, filesize);
+    ValueMap ret;
+    Value root;
+    if (filedata && filesize > 0 && parsePlist(filedata, filesize, "plist data", root) && root.getType() == Value::Type::MAP)
+    {
+        ret.swap(root.asValueMap());
+    }
+    return ret;
 }
 
 ValueVector FileUtils::getValueVectorFromFile(const std::string& filename)
 {
-    const std::string fullPath = fullPathForFilename(filename.c_str());
-    DictMaker tMaker;
-    return tMaker.arrayWithContentsOfFile(fullPath.c_str());
+    ValueVector ret;
+    Data data = getDataFromFile(filename);
+    Value root;
+    if (!data.isNull() && parsePlist((const char*)data.getBytes(), data.getSize(), filename, root) && root.getType() == Value::Type::VECTOR)
+    {
+        ret.swap(root.asValueVector());
+    }
+    return ret;
 }
 
 
@@ -513,10 +691,51 @@ bool FileUtils::writeToFile(ValueMap& dict, const std::string &fullPath) {return
 
 #endif /* (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) */
 
+static bool writeCompiledValue(const Value& root, const std::string& fullPath)
+{
+    std::string content;
+    CompiledValue::write(root, content);
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    bool ret = fwrite(content.c_str(), 1, content.length(), fp) == content.length();
+    ret = fclose(fp) == 0 && ret;
+    return ret;
+}
+
+bool FileUtils::writeValueMapToCompiledFile(const ValueMap& dict, const std::string& fullPath)
+{
+    return writeCompiledValue(Value(dict), fullPath);
+}
+
+bool FileUtils::writeValueVectorToCompiledFile(const ValueVector& array, const std::string& fullPath)
+{
+    return writeCompiledValue(Value(array), fullPath);
+}
+
+bool FileUtils::compilePlistFile(const std::string& filename, const std::string& fullPath)
+{
+    // the root of a plist is usually a dictionary, sometimes an array
+    ValueMap dict = getValueMapFromFile(filename);
+    if (!dict.empty())
+        return writeValueMapToCompiledFile(dict, fullPath);
+
+    ValueVector array = getValueVectorFromFile(filename);
+    if (!array.empty())
+        return writeValueVectorToCompiledFile(array, fullPath);
+
+    CCLOG("cocos2d: compilePlistFile: %s is empty or isn't a plist.", filename.c_str());
+    return false;
+}
+
 FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
 void FileUtils::destroyInstance()
 {
+    // its threads read through the instance
+    AsyncFileReader::destroyInstance();
     CC_SAFE_DELETE(s_sharedFileUtils);
 }
 
@@ -531,10 +750,13 @@ void FileUtils::setDelegate(FileUtils *delegate)
 FileUtils::FileUtils()
     : _writablePath("")
 {
+    pthread_rwlock_init(&_assetPacksLock, NULL);
 }
 
 FileUtils::~FileUtils()
 {
+    unmountAllAssetPacks();
+    pthread_rwlock_destroy(&_assetPacksLock);
 }
 
 
@@ -603,6 +825,8 @@ static Data getData(const std::string& filename, bool forString)
         std::string msg = "Get data from file(";
         msg.append(filename).append(") failed!");
         CCLOG("%s", msg.c_str());
+        // the buffer of an empty file
+        free(buffer);
     }
     else
     {
@@ -614,6 +838,10 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
 {
+    std::string packString;
+    if (getStringFromAssetPack(filename, &packString))
+        return packString;
+
     Data data = getData(filename, true);
     if (data.isNull())
     	return "";
@@ -624,14 +852,59 @@ std::string FileUtils::getStringFromFile(const std::string& filename)
 
 Data FileUtils::getDataFromFile(const std::string& filename)
 {
+    Data packData;
+    if (getDataFromAssetPack(filename, &packData))
+        return packData;
+
     return getData(filename, false);
 }
 
+unsigned int FileUtils::getDataFromFileAsync(const std::string& filename, const std::function<void(const Data&)>& callback, int priority)
+{
+    return AsyncFileReader::getInstance()->readData(filename, callback, priority);
+}
+
+unsigned int FileUtils::getStringFromFileAsync(const std::string& filename, const std::function<void(const std::string&)>& callback, int priority)
+{
+    return AsyncFileReader::getInstance()->readString(filename, callback, priority);
+}
+
+bool FileUtils::cancelAsyncRead(unsigned int requestId)
+{
+    return AsyncFileReader::getInstance()->cancel(requestId);
+}
+
+MappedData* FileUtils::getMappedDataFromFile(const std::string& filename)
+{
+    if (filename.empty())
+        return nullptr;
+
+    MappedData* packData = nullptr;
+    if (getMappedDataFromAssetPack(filename, &packData))
+        return packData;
+
+    MappedData* ret = new (std::nothrow) MappedData();
+    if (ret && !ret->initWithFile(fullPathForFilename(filename)))
+    {
+        // not a regular file, or mapping isn't supported
+        Data data = getDataFromFile(filename);
+        if (!ret->initWithData(data))
+        {
+            CC_SAFE_RELEASE_NULL(ret);
+        }
+    }
+    return ret;
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
     CCASSERT(!filename.empty() && size != nullptr && mode != nullptr, "Invalid parameters.");
     *size = 0;
+
+    if (getFileDataFromAssetPack(filename, &buffer, size))
+        return buffer;
+
     do
     {
         // read the file from hardware
@@ -834,6 +1107,8 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
         resOrder.append("/");
     
+    // the cached paths may be shadowed by the new resolution directory
+    _fullPathCache.clear();
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
@@ -908,6 +1183,8 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     {
         path += "/";
     }
+    // the cached paths may be shadowed by the new search path
+    _fullPathCache.clear();
     if (front) {
         _searchPathArray.insert(_searchPathArray.begin(), path);
     } else {
@@ -951,7 +1228,7 @@ std::string FileUtils::getFullPathForDirectoryAndFilename(const std::string& dir
     ret += filename;
     
     // if the file doesn't exist, return an empty string
-    if (!isFileExistInternal(ret)) {
+    if (!isFileExistIndexed(ret)) {
         ret = "";
     }
     return ret;
@@ -978,7 +1255,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return isFileExistIndexed(filename);
     }
     else
     {
@@ -990,6 +1267,451 @@ bool FileUtils::isFileExist(const std::string& filename) const
     }
 }
 
+static std::string normalizeAssetIndexRoot(const std::string& rootPath)
+{
+    std::string root = rootPath;
+    if (!root.empty() && root[root.length() - 1] != '/')
+    {
+        root += '/';
+    }
+    return root;
+}
+
+bool FileUtils::buildAssetIndex(const std::string& rootPath)
+{
+    CCASSERT(!rootPath.empty(), "Invalid path");
+
+    std::string root = normalizeAssetIndexRoot(rootPath);
+    if (!indexDirectory(root, ""))
+    {
+        CCLOG("cocos2d: buildAssetIndex: Can't list %s, use a prebuilt manifest instead.", root.c_str());
+        return false;
+    }
+
+    if (std::find(_assetIndexRoots.begin(), _assetIndexRoots.end(), root) == _assetIndexRoots.end())
+    {
+        _assetIndexRoots.push_back(root);
+    }
+    _assetIndexDirectories.insert(root.substr(0, root.length() - 1));
+    return true;
+}
+
+bool FileUtils::loadAssetIndexFromFile(const std::string& filename, const std::string& rootPath)
+{
+    std::string content = getStringFromFile(filename);
+    if (content.empty())
+    {
+        CCLOG("cocos2d: loadAssetIndexFromFile: Can't load the manifest %s.", filename.c_str());
+        return false;
+    }
+
+    std::string root = normalizeAssetIndexRoot(rootPath.empty() ? _defaultResRootPath : rootPath);
+
+    size_t start = 0;
+    while (start < content.length())
+    {
+        size_t end = content.find('\n', start);
+        if (end == std::string::npos)
+            end = content.length();
+
+        size_t last = end;
+        if (last > start && content[last - 1] == '\r')
+            --last;
+
+        if (last > start && content[start] != '#')
+        {
+            addToAssetIndex(root, content.substr(start, last - start));
+        }
+        start = end + 1;
+    }
+
+    if (std::find(_assetIndexRoots.begin(), _assetIndexRoots.end(), root) == _assetIndexRoots.end())
+    {
+        _assetIndexRoots.push_back(root);
+    }
+    _assetIndexDirectories.insert(root.substr(0, root.length() - 1));
+    return true;
+}
+
+std::vector<std::string> FileUtils::getAssetIndexFiles(const std::string& rootPath) const
+{
+    std::string root = normalizeAssetIndexRoot(rootPath);
+
+    std::vector<std::string> paths;
+    //for (const auto& file : _assetIndexFiles)
+    for (auto p_file = _assetIndexFiles.begin(); p_file != _assetIndexFiles.end(); ++p_file)
+    {
+        const std::string& file = *p_file;
+        if (file.compare(0, root.length(), root) == 0)
+        {
+            paths.push_back(file.substr(root.length()));
+        }
+    }
+    // sorted, so the manifest doesn't change from one build to the next
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+bool FileUtils::writeAssetIndexToFile(const std::string& rootPath, const std::string& fullPath) const
+{
+    std::vector<std::string> paths = getAssetIndexFiles(rootPath);
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: writeAssetIndexToFile: Can't open %s.", fullPath.c_str());
+        return false;
+    }
+    //for (const auto& path : paths)
+    for (auto p_path = paths.begin(); p_path != paths.end(); ++p_path)
+    {
+        fwrite(p_path->c_str(), 1, p_path->length(), fp);
+        fputc('\n', fp);
+    }
+    fclose(fp);
+    return true;
+}
+
+void FileUtils::clearAssetIndex()
+{
+    _assetIndexRoots.clear();
+    _assetIndexFiles.clear();
+    _assetIndexDirectories.clear();
+    _fullPathCache.clear();
+}
+
+bool FileUtils::mountAssetPack(const std::string& filename, const std::string& mountPath)
+{
+    AssetPack* pack = new (std::nothrow) AssetPack();
+    if (!pack || !pack->initWithFile(filename))
+    {
+        CC_SAFE_RELEASE(pack);
+        return false;
+    }
+
+    MountedAssetPack mounted;
+    mounted.filename = filename;
+    mounted.root = normalizeAssetIndexRoot(mountPath.empty() ? _defaultResRootPath : mountPath);
+    mounted.pack = pack;
+
+    pthread_rwlock_wrlock(&_assetPacksLock);
+    removeAssetPack(filename);
+    _assetPacks.push_back(mounted);
+    pthread_rwlock_unlock(&_assetPacksLock);
+
+    // the cached paths may be shadowed by the files of the pack
+    _fullPathCache.clear();
+    return true;
+}
+
+void FileUtils::unmountAssetPack(const std::string& filename)
+{
+    pthread_rwlock_wrlock(&_assetPacksLock);
+    removeAssetPack(filename);
+    pthread_rwlock_unlock(&_assetPacksLock);
+}
+
+void FileUtils::removeAssetPack(const std::string& filename)
+{
+    for (auto iter = _assetPacks.begin(); iter != _assetPacks.end(); ++iter)
+    {
+        if (iter->filename == filename)
+        {
+            iter->pack->release();
+            _assetPacks.erase(iter);
+            _fullPathCache.clear();
+            return;
+        }
+    }
+}
+
+void FileUtils::unmountAllAssetPacks()
+{
+    pthread_rwlock_wrlock(&_assetPacksLock);
+    //for (auto& mounted : _assetPacks)
+    for (auto p_mounted = _assetPacks.begin(); p_mounted != _assetPacks.end(); ++p_mounted)
+    {
+        p_mounted->pack->release();
+    }
+    _assetPacks.clear();
+    pthread_rwlock_unlock(&_assetPacksLock);
+    _fullPathCache.clear();
+}
+
+AssetPack* FileUtils::findAssetPack(const std::string& fullPath, std::string* path) const
+{
+    // the last mounted pack comes first
+    for (auto iter = _assetPacks.rbegin(); iter != _assetPacks.rend(); ++iter)
+    {
+        const std::string& root = iter->root;
+        if (fullPath.length() > root.length() && fullPath.compare(0, root.length(), root) == 0)
+        {
+            std::string packPath = fullPath.substr(root.length());
+            if (iter->pack->hasFile(packPath))
+            {
+                if (path)
+                    *path = packPath;
+                return iter->pack;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::isFileInAssetPack(const std::string& fullPath) const
+{
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    bool ret = findAssetPack(fullPath, nullptr) != nullptr;
+    pthread_rwlock_unlock(&_assetPacksLock);
+    return ret;
+}
+
+bool FileUtils::getDataFromAssetPack(const std::string& filename, Data* data) const
+{
+    if (filename.empty())
+        return false;
+
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    bool mounted = !_assetPacks.empty();
+    pthread_rwlock_unlock(&_assetPacksLock);
+    if (!mounted)
+        return false;
+
+    // resolved unlocked, the search may look for the file in the packs
+    std::string fullPath = fullPathForFilename(filename);
+
+    // the pack stays mounted until the read is done
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    std::string packPath;
+    AssetPack* pack = findAssetPack(fullPath, &packPath);
+    if (pack)
+    {
+        *data = pack->getData(packPath);
+    }
+    pthread_rwlock_unlock(&_assetPacksLock);
+    return pack != nullptr;
+}
+
+bool FileUtils::getStringFromAssetPack(const std::string& filename, std::string* str) const
+{
+    Data data;
+    if (!getDataFromAssetPack(filename, &data))
+        return false;
+
+    if (data.isNull())
+        str->clear();
+    else
+        str->assign((const char*)data.getBytes(), data.getSize());
+    return true;
+}
+
+bool FileUtils::getFileDataFromAssetPack(const std::string& filename, unsigned char** buffer, ssize_t* size) const
+{
+    Data data;
+    if (!getDataFromAssetPack(filename, &data))
+        return false;
+
+    if (size)
+        *size = 0;
+    *buffer = nullptr;
+    if (data.isNull())
+        return true;
+
+    *buffer = (unsigned char*)malloc(data.getSize());
+    if (*buffer)
+    {
+        memcpy(*buffer, data.getBytes(), data.getSize());
+        if (size)
+            *size = data.getSize();
+    }
+    return true;
+}
+
+bool FileUtils::getMappedDataFromAssetPack(const std::string& filename, MappedData** data) const
+{
+    if (filename.empty())
+        return false;
+
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    bool mounted = !_assetPacks.empty();
+    pthread_rwlock_unlock(&_assetPacksLock);
+    if (!mounted)
+        return false;
+
+    std::string fullPath = fullPathForFilename(filename);
+
+    // the view keeps the mapping of the pack alive, not the pack, which may be unmounted once it is created
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    std::string packPath;
+    AssetPack* pack = findAssetPack(fullPath, &packPath);
+    if (pack)
+    {
+        *data = pack->getMappedData(packPath);
+    }
+    pthread_rwlock_unlock(&_assetPacksLock);
+    return pack != nullptr;
+}
+
+bool FileUtils::isCoveredByAssetIndex(const std::string& path) const
+{
+    //for (const auto& root : _assetIndexRoots)
+    for (auto p_root = _assetIndexRoots.begin(); p_root != _assetIndexRoots.end(); ++p_root)
+    {
+        const std::string& root = *p_root;
+        if (path.compare(0, root.length(), root) == 0)
+        {
+            // "./", "../" and "//" aren't in the index, let the file system resolve them
+            return path.find("./", root.length()) == std::string::npos && path.find("//", root.length()) == std::string::npos;
+        }
+    }
+    return false;
+}
+
+bool FileUtils::isFileExistIndexed(const std::string& filename) const
+{
+    if (isFileInAssetPack(filename))
+    {
+        return true;
+    }
+    if (isCoveredByAssetIndex(filename))
+    {
+        return _assetIndexFiles.find(filename) != _assetIndexFiles.end();
+    }
+    return isFileExistInternal(filename);
+}
+
+bool FileUtils::isDirectoryExistIndexed(const std::string& dirPath) const
+{
+    std::string path = dirPath;
+    while (path.length() > 1 && path[path.length() - 1] == '/')
+    {
+        path.erase(path.length() - 1);
+    }
+
+    std::string directory = path + '/';
+    bool inPack = false;
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    //for (const auto& mounted : _assetPacks)
+    for (auto p_mounted = _assetPacks.begin(); p_mounted != _assetPacks.end() && !inPack; ++p_mounted)
+    {
+        const std::string& root = p_mounted->root;
+        if (directory.compare(0, root.length(), root) == 0)
+        {
+            // the path in the pack, without the trailing '/'
+            std::string packPath = directory.substr(root.length());
+            if (!packPath.empty())
+                packPath.erase(packPath.length() - 1);
+            inPack = p_mounted->pack->hasDirectory(packPath);
+        }
+    }
+    pthread_rwlock_unlock(&_assetPacksLock);
+    if (inPack)
+        return true;
+
+    if (isCoveredByAssetIndex(directory))
+    {
+        return _assetIndexDirectories.find(path) != _assetIndexDirectories.end();
+    }
+    return isDirectoryExistInternal(dirPath);
+}
+
+void FileUtils::addToAssetIndex(const std::string& rootPath, const std::string& relativePath)
+{
+    _assetIndexFiles.insert(rootPath + relativePath);
+
+    size_t pos = relativePath.find('/');
+    while (pos != std::string::npos)
+    {
+        _assetIndexDirectories.insert(rootPath + relativePath.substr(0, pos));
+        pos = relativePath.find('/', pos + 1);
+    }
+}
+
+bool FileUtils::indexDirectory(const std::string& rootPath, const std::string& relativePath)
+{
+    if (!relativePath.empty())
+    {
+        _assetIndexDirectories.insert(rootPath + relativePath.substr(0, relativePath.length() - 1));
+    }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    std::string dirPath = rootPath + relativePath;
+    std::wstring files = std::wstring(dirPath.begin(), dirPath.end()) + L"*.*";
+    WIN32_FIND_DATA wfd;
+    HANDLE search = FindFirstFileEx(files.c_str(), FindExInfoStandard, &wfd, FindExSearchNameMatch, NULL, 0);
+    if (search == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        std::wstring name = wfd.cFileName;
+        if (name == L"." || name == L"..")
+            continue;
+
+        std::string path = relativePath + std::string(name.begin(), name.end());
+        if (wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            indexDirectory(rootPath, path + '/');
+        else
+            addToAssetIndex(rootPath, path);
+    } while (FindNextFile(search, &wfd));
+    FindClose(search);
+    return true;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    // the paths are UTF-8, as in FileUtilsWin32, the ANSI functions would mangle names outside the code page
+    std::string files = rootPath + relativePath + "*.*";
+    WCHAR utf16Files[MAX_PATH] = {0};
+    if (MultiByteToWideChar(CP_UTF8, 0, files.c_str(), -1, utf16Files, sizeof(utf16Files)/sizeof(utf16Files[0])) == 0)
+        return false;
+
+    WIN32_FIND_DATAW fd;
+    HANDLE search = FindFirstFileW(utf16Files, &fd);
+    if (search == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0)
+            continue;
+
+        char utf8Name[MAX_PATH * 3] = {0};
+        if (WideCharToMultiByte(CP_UTF8, 0, fd.cFileName, -1, utf8Name, sizeof(utf8Name), nullptr, nullptr) == 0)
+            continue;
+
+        std::string path = relativePath + utf8Name;
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            indexDirectory(rootPath, path + '/');
+        else
+            addToAssetIndex(rootPath, path);
+    } while (FindNextFileW(search, &fd));
+    FindClose(search);
+    return true;
+#else
+    std::string dirPath = rootPath + relativePath;
+    DIR* dir = opendir(dirPath.c_str());
+    if (!dir)
+        return false;
+
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        std::string path = relativePath + entry->d_name;
+        struct stat st;
+        if (stat((rootPath + path).c_str(), &st) != 0)
+            continue;
+
+        if (S_ISDIR(st.st_mode))
+            indexDirectory(rootPath, path + '/');
+        else
+            addToAssetIndex(rootPath, path);
+    }
+    closedir(dir);
+    return true;
+#endif
+}
+
 bool FileUtils::isAbsolutePath(const std::string& path) const
 {
     return (path[0] == '/');
@@ -1031,14 +1753,14 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
     
     if (isAbsolutePath(dirPath))
     {
-        return isDirectoryExistInternal(dirPath);
+        return isDirectoryExistIndexed(dirPath);
     }
     
     // Already Cached ?
     auto cacheIter = _fullPathCache.find(dirPath);
     if( cacheIter != _fullPathCache.end() )
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryExistIndexed(cacheIter->second);
     }
     
 	std::string fullpath;
@@ -1052,7 +1774,7 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
 			const auto& resolutionIt = *p_resolutionIt;
             // searchPath + file_path + resourceDirectory
             fullpath = searchIt + dirPath + resolutionIt;
-            if (isDirectoryExistInternal(fullpath))
+            if (isDirectoryExistIndexed(fullpath))
             {
                 _fullPathCache.insert(std::make_pair(dirPath, fullpath));
                 return true;
@@ -1362,6 +2084,14 @@ long FileUtils::getFileSize(const std::string &filepath)
         if (fullpath.empty())
             return 0;
     }
+
+    pthread_rwlock_rdlock(&_assetPacksLock);
+    std::string packPath;
+    AssetPack* pack = findAssetPack(fullpath, &packPath);
+    long packSize = pack ? (long)pack->getFileSize(packPath) : 0;
+    pthread_rwlock_unlock(&_assetPacksLock);
+    if (pack)
+        return packSize;
     
     struct stat info;
     // Get data associated with "crt_stat.c":
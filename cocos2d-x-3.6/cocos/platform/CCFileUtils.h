@@ -25,17 +25,23 @@ THE SOFTWARE.
 #ifndef __CC_FILEUTILS_H__
 #define __CC_FILEUTILS_H__
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <pthread.h>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "base/CCMappedData.h"
 
 NS_CC_BEGIN
 
+class AssetPack;
+
 /**
  * @addtogroup support
  * @{
@@ -98,6 +104,36 @@ public:
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename);
+
+    /**
+     *  Reads a file as binary data on an I/O thread, see AsyncFileReader.
+     *  Requests for a file already being read share the same read.
+     *
+     *  @param filename The file, searched on the calling thread like getDataFromFile() does.
+     *  @param callback Called on the cocos thread with the content, Data::Null if the file can't be read.
+     *  @param priority The requests with the highest priority are served first.
+     *  @return The id of the request, to cancel it with cancelAsyncRead().
+     */
+    unsigned int getDataFromFileAsync(const std::string& filename, const std::function<void(const Data&)>& callback, int priority = 0);
+
+    /**
+     *  Same as getDataFromFileAsync(), with the content given as a string, empty if the file can't be read.
+     */
+    unsigned int getStringFromFileAsync(const std::string& filename, const std::function<void(const std::string&)>& callback, int priority = 0);
+
+    /**
+     *  Cancels a read requested with getDataFromFileAsync() or getStringFromFileAsync(), its callback won't be called.
+     *  @return False if the request already completed or was canceled.
+     */
+    bool cancelAsyncRead(unsigned int requestId);
+
+    /**
+     *  Gets a read only view of the content of a file, memory mapped when the platform allows it,
+     *  so the content isn't copied into a new buffer. Meant for the large binary files, e.g. images,
+     *  c3b models or flatbuffers. Thread safe, like getDataFromFile().
+     *  @return The content, nullptr if the file can't be read. It isn't autoreleased, release() it when done.
+     */
+    virtual MappedData* getMappedDataFromFile(const std::string& filename);
     
     /**
      *  Gets resource file data
@@ -315,6 +351,7 @@ public:
 
     /**
      *  Converts the contents of a file to a ValueMap.
+     *  The file may be a XML plist, an Apple binary plist or a compiled value, see CompiledValue.
      *  @param filename The filename of the file to gets content.
      *  @return ValueMap of the file contents.
      *  @note This method is used internally.
@@ -333,6 +370,31 @@ public:
     // Converts the contents of a file to a ValueVector.
     // This method is used internally.
     virtual ValueVector getValueVectorFromFile(const std::string& filename);
+
+    /**
+     *  Writes a ValueMap in the compact binary format of CompiledValue, which getValueMapFromFile() reads
+     *  much faster than a XML plist.
+     *
+     *  @param dict The ValueMap to write.
+     *  @param fullPath The full path of the file to write.
+     *  @return True if the file was written, false if not.
+     */
+    bool writeValueMapToCompiledFile(const ValueMap& dict, const std::string& fullPath);
+
+    /**
+     *  Writes a ValueVector in the compact binary format of CompiledValue, read by getValueVectorFromFile().
+     */
+    bool writeValueVectorToCompiledFile(const ValueVector& array, const std::string& fullPath);
+
+    /**
+     *  Converts a plist, XML or binary, to the compact binary format of CompiledValue. Meant to be run at build time,
+     *  the converted file can replace the plist as is, since the loaders recognize the format by themselves.
+     *
+     *  @param filename The plist to convert.
+     *  @param fullPath The full path of the file to write.
+     *  @return True if the file was written, false if not.
+     */
+    bool compilePlistFile(const std::string& filename, const std::string& fullPath);
     
     /**
      *  Checks whether a file exists.
@@ -408,6 +470,77 @@ public:
     /** Returns the full path cache. */
     const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
 
+    /**
+     *  Indexes all the files and directories under a resource root, by listing them once.
+     *  Afterwards, looking up a file or a directory under this root is a hash lookup instead of
+     *  a query to the file system, for every search path and resolution directory tried.
+     *
+     *  @note The index isn't updated when files are added or removed, so only index read-only roots,
+     *        not the writable path. The names are case sensitive on every platform.
+     *        Files packed in the APK can't be listed on Android, use loadAssetIndexFromFile() there.
+     *  @param rootPath The directory to index, e.g. the default resource root path.
+     *  @return True if the directory could be listed, false if not.
+     */
+    virtual bool buildAssetIndex(const std::string& rootPath);
+
+    /**
+     *  Indexes a resource root from a manifest prepared at build time, see writeAssetIndexToFile().
+     *  The manifest is a text file listing one file path per line, relative to the root.
+     *  Empty lines and lines starting with '#' are skipped.
+     *
+     *  @param filename The manifest, it is searched like any other file.
+     *  @param rootPath The directory the manifest lists, the default resource root path if empty.
+     *  @return True if the manifest was loaded, false if not.
+     */
+    virtual bool loadAssetIndexFromFile(const std::string& filename, const std::string& rootPath = "");
+
+    /**
+     *  Gets the paths of the files indexed under a root, relative to the root and sorted.
+     *  This is the list of files to give to AssetPack::build() to pack a directory.
+     */
+    std::vector<std::string> getAssetIndexFiles(const std::string& rootPath) const;
+
+    /**
+     *  Writes the files indexed under a root to a manifest, which can be shipped and loaded with loadAssetIndexFromFile().
+     *
+     *  @param rootPath The indexed directory to write.
+     *  @param fullPath The full path of the manifest.
+     *  @return True if the manifest was written, false if not.
+     */
+    virtual bool writeAssetIndexToFile(const std::string& rootPath, const std::string& fullPath) const;
+
+    /**
+     *  Drops the asset index, the files are looked up in the file system again.
+     */
+    void clearAssetIndex();
+
+    /** Returns the number of files in the asset index. */
+    size_t getAssetIndexSize() const { return _assetIndexFiles.size(); }
+
+    /**
+     *  Mounts an asset pack, see AssetPack. Its files are found as if they were in the mount directory,
+     *  before the files really there and the files of the packs mounted earlier.
+     *  Reading them with getDataFromFile(), getStringFromFile(), getFileData() or getMappedDataFromFile()
+     *  reads them from the pack.
+     *
+     *  @param filename The pack, it is searched like any other file.
+     *  @param mountPath The directory the pack is mounted in, the default resource root path if empty.
+     *         Mounting it in a search path makes its files available through the search paths and resolution directories.
+     *  @return True if the pack was mounted, false if it can't be loaded.
+     */
+    virtual bool mountAssetPack(const std::string& filename, const std::string& mountPath = "");
+
+    /**
+     *  Unmounts an asset pack, given by the name it was mounted with.
+     *  The reads of its files already running on other threads complete before it is unmounted.
+     */
+    void unmountAssetPack(const std::string& filename);
+
+    /**
+     *  Unmounts all the asset packs.
+     */
+    void unmountAllAssetPacks();
+
 protected:
     /**
      *  The default constructor.
@@ -477,6 +610,58 @@ protected:
      *  @return The full path for the file, if not found, the return value will be an empty string
      */
     virtual std::string searchFullPathForFilename(const std::string& filename) const;
+
+    /**
+     *  Checks whether a file exists in the asset index, or in the file system if it isn't under an indexed root.
+     *  @param filename The file (with absolute path) to look up for
+     */
+    bool isFileExistIndexed(const std::string& filename) const;
+
+    /**
+     *  Checks whether a directory exists in the asset index, or in the file system if it isn't under an indexed root.
+     *  @param dirPath The directory (with absolute path) to look up for
+     */
+    bool isDirectoryExistIndexed(const std::string& dirPath) const;
+
+    /** Returns true if the path is under an indexed root and can be looked up in the index as is. */
+    bool isCoveredByAssetIndex(const std::string& path) const;
+
+    /** Adds a file path relative to an indexed root to the index, along with its directories. */
+    void addToAssetIndex(const std::string& rootPath, const std::string& relativePath);
+
+    /** Lists a directory recursively into the asset index. */
+    bool indexDirectory(const std::string& rootPath, const std::string& relativePath);
+
+    /**
+     *  Finds the mounted asset pack which has a file.
+     *  _assetPacksLock must be held by the caller, the pack can be unmounted as soon as it is unlocked.
+     *  @param fullPath The full path of the file.
+     *  @param path Set to the path of the file in the pack, if not null.
+     *  @return The pack, nullptr if the file isn't in a mounted pack.
+     */
+    AssetPack* findAssetPack(const std::string& fullPath, std::string* path) const;
+
+    /** Locks the asset packs and tells whether a file is in one of them. */
+    bool isFileInAssetPack(const std::string& fullPath) const;
+
+    /**
+     *  Reads a file, which may be relative to the search paths, from the mounted asset packs.
+     *  Returns false at once if no pack is mounted.
+     *  @return True if a pack has the file, then data is set to its content, null if it can't be read.
+     */
+    bool getDataFromAssetPack(const std::string& filename, Data* data) const;
+
+    /** Same as getDataFromAssetPack(), for a string. */
+    bool getStringFromAssetPack(const std::string& filename, std::string* str) const;
+
+    /** Same as getDataFromAssetPack(), into a buffer allocated with malloc, as getFileData() does. */
+    bool getFileDataFromAssetPack(const std::string& filename, unsigned char** buffer, ssize_t* size) const;
+
+    /** Same as getDataFromAssetPack(), for a view as getMappedDataFromFile() returns. */
+    bool getMappedDataFromAssetPack(const std::string& filename, MappedData** data) const;
+
+    /** Removes a pack from _assetPacks, _assetPacksLock must be write locked. */
+    void removeAssetPack(const std::string& filename);
     
     
     /** Dictionary used to lookup filenames based on a key.
@@ -514,6 +699,32 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCache;
+
+    /** The indexed roots, ending with '/'. */
+    std::vector<std::string> _assetIndexRoots;
+
+    /** Full paths of the indexed files. */
+    std::unordered_set<std::string> _assetIndexFiles;
+
+    /** Full paths of the indexed directories, without the trailing '/'. */
+    std::unordered_set<std::string> _assetIndexDirectories;
+
+    struct MountedAssetPack
+    {
+        std::string filename;
+        /** The mount directory, ending with '/' */
+        std::string root;
+        AssetPack* pack;
+    };
+
+    /** The mounted asset packs, the last mounted is searched first. */
+    std::vector<MountedAssetPack> _assetPacks;
+
+    /**
+     *  Read locked by the reads from the packs, which may run on any thread, for as long as they use the pack.
+     *  Write locked by mounting and unmounting.
+     */
+    mutable pthread_rwlock_t _assetPacksLock;
     
     /**
      * Writable path.
@@ -115,6 +115,11 @@ public:
     /** Exchanges the front and back buffers, subclass must implement this method. */
     virtual void swapBuffers() = 0;
 
+    /** Whether the last frame stays displayed when a frame isn't drawn nor swapped.
+     * The render on demand mode of the Director only skips frames when it does.
+     */
+    virtual bool isFrameSkippingSupported() const { return true; }
+
     /** Open or close IME keyboard , subclass must implement this method. 
      *
      * @param open Open or close IME keyboard.
@@ -461,6 +461,8 @@ Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
 Image::Image()
 : _data(nullptr)
 , _dataLen(0)
+, _dataBuffer(nullptr)
+, _inflatedData(nullptr)
 , _width(0)
 , _height(0)
 , _unpack(false)
@@ -479,8 +481,9 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (! _dataBuffer)
         CC_SAFE_FREE(_data);
+    CC_SAFE_FREE(_dataBuffer);
 }
 
 bool Image::initWithImageFile(const std::string& path)
@@ -508,11 +511,13 @@ bool Image::initWithImageFile(const std::string& path)
 
     SDL_FreeSurface(iSurf);
 #else
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // the decoders read the mapped file, it isn't copied
+    MappedData* data = FileUtils::getInstance()->getMappedDataFromFile(_filePath);
 
-    if (!data.isNull())
+    if (data)
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(data->getBytes(), data->getSize());
+        data->release();
     }
 #endif // EMSCRIPTEN
 
@@ -524,11 +529,12 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    MappedData* data = FileUtils::getInstance()->getMappedDataFromFile(fullpath);
 
-    if (!data.isNull())
+    if (data)
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(data->getBytes(), data->getSize());
+        data->release();
     }
 
     return ret;
@@ -560,6 +566,9 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             unpackedLen = dataLen;
         }
 
+        // an inflated pvr.ccz becomes the image data as is, see takeImageData()
+        _inflatedData = (unpackedData != data) ? unpackedData : nullptr;
+
         _fileType = detectFormat(unpackedData, unpackedLen);
 
         switch (_fileType)
@@ -607,10 +616,8 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             }
         }
         
-        if(unpackedData != data)
-        {
-            free(unpackedData);
-        }
+        // unless it was kept
+        CC_SAFE_FREE(_inflatedData);
     } while (0);
     
     return ret;
@@ -1468,9 +1475,10 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     dataLength = CC_SWAP_INT32_LITTLE_TO_HOST(header->dataLength);
 
     //Move by size of header
-    _dataLen = dataLen - sizeof(PVRv2TexHeader);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, (unsigned char*)data + sizeof(PVRv2TexHeader), _dataLen);
+    if (! takeImageData(data, sizeof(PVRv2TexHeader), dataLen - sizeof(PVRv2TexHeader)))
+    {
+        return false;
+    }
 
     // Calculate the data size for each texture level and respect the minimum number of blocks
     while (dataOffset < dataLength)
@@ -1548,6 +1556,9 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     
     if(_unpack)
     {
+        // the compressed data isn't used anymore
+        free(_dataBuffer ? _dataBuffer : _data);
+        _dataBuffer = nullptr;
         _data = _mipmaps[0].address;
         _dataLen = _mipmaps[0].len;
     }
@@ -1618,9 +1629,10 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
 	int dataOffset = 0, dataSize = 0;
 	int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
 	
-    _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
+    if (! takeImageData(data, sizeof(PVRv3TexHeader) + header->metadataLength, dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength)))
+    {
+        return false;
+    }
 	
 	_numberOfMipmaps = header->numberOfMipmaps;
 	CCAssert(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increate the CC_MIPMAP_MAX value");
@@ -1721,6 +1733,9 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
     
     if (_unpack)
     {
+        // the compressed data isn't used anymore
+        free(_dataBuffer ? _dataBuffer : _data);
+        _dataBuffer = nullptr;
         _data = _mipmaps[0].address;
         _dataLen = _mipmaps[0].len;
     }
@@ -2139,6 +2154,34 @@ bool Image::initWithPVRData(const unsigned char * data, ssize_t dataLen)
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
 }
 
+bool Image::takeImageData(const unsigned char *data, ssize_t offset, ssize_t length)
+{
+    if (offset < 0 || length <= 0)
+    {
+        return false;
+    }
+
+    // the inflated file is kept and _data points after the header, saving a copy of the whole image.
+    // The pvrtc decoder reads 32 bit words, so the data must stay aligned.
+    if (data == _inflatedData && offset % 4 == 0)
+    {
+        _dataBuffer = _inflatedData;
+        _inflatedData = nullptr;
+        _data = _dataBuffer + offset;
+    }
+    else
+    {
+        _data = static_cast<unsigned char*>(malloc(length * sizeof(unsigned char)));
+        if (! _data)
+        {
+            return false;
+        }
+        memcpy(_data, data + offset, length);
+    }
+    _dataLen = length;
+    return true;
+}
+
 bool Image::initWithWebpData(const unsigned char * data, ssize_t dataLen)
 {
 #if 0
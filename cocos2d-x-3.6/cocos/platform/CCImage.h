@@ -170,6 +170,7 @@ protected:
     bool initWithATITCData(const unsigned char *data, ssize_t dataLen);
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
+    bool takeImageData(const unsigned char *data, ssize_t offset, ssize_t length);
 
     bool saveImageToPNG(const std::string& filePath, bool isToRGB = true);
     bool saveImageToJPG(const std::string& filePath);
@@ -184,6 +185,10 @@ protected:
     static const int MIPMAP_MAX = 16;
     unsigned char *_data;
     ssize_t _dataLen;
+    // the allocation _data points into, freed instead of _data
+    unsigned char *_dataBuffer;
+    // the buffer inflated by initWithImageData(), which takeImageData() may keep instead of copying it
+    unsigned char *_inflatedData;
     int _width;
     int _height;
     bool _unpack;
@@ -0,0 +1,788 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/CCValueFormats.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// Nesting limit of the containers, a corrupted file can't exhaust the stack, nor loop on itself in a binary plist
+static const int MAX_DEPTH = 256;
+
+//
+// BinaryPlist
+//
+
+namespace
+{
+
+class BinaryPlistReader
+{
+public:
+    BinaryPlistReader(const unsigned char* data, size_t size)
+    : _data(data)
+    , _size(size)
+    , _offsetTable(nullptr)
+    , _objectsEnd(0)
+    , _offsetSize(0)
+    , _refSize(0)
+    , _objectCount(0)
+    {
+    }
+
+    bool read(Value& root)
+    {
+        // trailer: 6 unused bytes, offset size, reference size, object count, root object, offset table offset
+        const unsigned char* trailer = _data + _size - 32;
+        _offsetSize = trailer[6];
+        _refSize = trailer[7];
+        _objectCount = readBigEndian(trailer + 8, 8);
+        uint64_t rootObject = readBigEndian(trailer + 16, 8);
+        uint64_t tableOffset = readBigEndian(trailer + 24, 8);
+
+        if (_offsetSize < 1 || _offsetSize > 8 || _refSize < 1 || _refSize > 8
+            || rootObject >= _objectCount || tableOffset < 8 || tableOffset > _size - 32
+            || _objectCount > (_size - 32 - tableOffset) / _offsetSize)
+        {
+            return false;
+        }
+        _offsetTable = _data + tableOffset;
+        _objectsEnd = tableOffset;
+
+        return readObject(rootObject, root, 0);
+    }
+
+private:
+    static uint64_t readBigEndian(const unsigned char* bytes, size_t count)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    // Reads the object count of a string or a container, which may follow the marker as an integer object
+    bool readCount(uint64_t offset, unsigned char info, uint64_t* count, uint64_t* contentOffset) const
+    {
+        if (info != 0x0F)
+        {
+            *count = info;
+            *contentOffset = offset + 1;
+            return true;
+        }
+
+        if (offset + 2 > _objectsEnd || (_data[offset + 1] & 0xF0) != 0x10)
+            return false;
+        size_t bytes = (size_t)1 << (_data[offset + 1] & 0x0F);
+        if (bytes > 8 || offset + 2 + bytes > _objectsEnd)
+            return false;
+        *count = readBigEndian(_data + offset + 2, bytes);
+        *contentOffset = offset + 2 + bytes;
+        return true;
+    }
+
+    bool readString(uint64_t offset, std::string& text) const
+    {
+        unsigned char marker = _data[offset];
+        uint64_t count = 0;
+        uint64_t content = 0;
+        if (!readCount(offset, marker & 0x0F, &count, &content))
+            return false;
+
+        switch (marker >> 4)
+        {
+        case 0x5: // ASCII
+        case 0x7: // UTF-8
+            if (count > _objectsEnd - content)
+                return false;
+            text.assign((const char*)_data + content, (size_t)count);
+            return true;
+
+        case 0x6: // UTF-16 big endian
+            {
+                if (count > (_objectsEnd - content) / 2)
+                    return false;
+                text.clear();
+                text.reserve((size_t)count);
+                const unsigned char* units = _data + content;
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    unsigned long code = (units[i * 2] << 8) | units[i * 2 + 1];
+                    if (code >= 0xD800 && code < 0xDC00 && i + 1 < count)
+                    {
+                        unsigned long low = (units[i * 2 + 2] << 8) | units[i * 2 + 3];
+                        if (low >= 0xDC00 && low < 0xE000)
+                        {
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            ++i;
+                        }
+                    }
+
+                    if (code < 0x80)
+                    {
+                        text += (char)code;
+                    }
+                    else if (code < 0x800)
+                    {
+                        text += (char)(0xC0 | (code >> 6));
+                        text += (char)(0x80 | (code & 0x3F));
+                    }
+                    else if (code < 0x10000)
+                    {
+                        text += (char)(0xE0 | (code >> 12));
+                        text += (char)(0x80 | ((code >> 6) & 0x3F));
+                        text += (char)(0x80 | (code & 0x3F));
+                    }
+                    else
+                    {
+                        text += (char)(0xF0 | (code >> 18));
+                        text += (char)(0x80 | ((code >> 12) & 0x3F));
+                        text += (char)(0x80 | ((code >> 6) & 0x3F));
+                        text += (char)(0x80 | (code & 0x3F));
+                    }
+                }
+                return true;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    bool objectOffset(uint64_t ref, uint64_t* offset) const
+    {
+        if (ref >= _objectCount)
+            return false;
+        *offset = readBigEndian(_offsetTable + ref * _offsetSize, _offsetSize);
+        return *offset >= 8 && *offset < _objectsEnd;
+    }
+
+    // Reads the references of a container
+    bool readRefs(uint64_t content, uint64_t count, std::vector<uint64_t>& refs) const
+    {
+        if (count > (_objectsEnd - content) / _refSize)
+            return false;
+        refs.resize((size_t)count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            refs[(size_t)i] = readBigEndian(_data + content + i * _refSize, _refSize);
+        }
+        return true;
+    }
+
+    // value is left null for the objects which aren't values: null, dates, data and UIDs
+    bool readObject(uint64_t ref, Value& value, int depth)
+    {
+        uint64_t offset = 0;
+        if (depth > MAX_DEPTH || !objectOffset(ref, &offset))
+            return false;
+
+        unsigned char marker = _data[offset];
+        unsigned char info = marker & 0x0F;
+        switch (marker >> 4)
+        {
+        case 0x0:
+            if (info == 0x08 || info == 0x09)
+                value = info == 0x09;
+            return true;
+
+        case 0x1:
+            {
+                size_t bytes = (size_t)1 << info;
+                if (bytes > 8 || offset + 1 + bytes > _objectsEnd)
+                    return false;
+                value = (int)(int64_t)readBigEndian(_data + offset + 1, bytes);
+                return true;
+            }
+
+        case 0x2:
+            {
+                size_t bytes = (size_t)1 << info;
+                if ((bytes != 4 && bytes != 8) || offset + 1 + bytes > _objectsEnd)
+                    return false;
+                uint64_t bits = readBigEndian(_data + offset + 1, bytes);
+                if (bytes == 4)
+                {
+                    uint32_t bits32 = (uint32_t)bits;
+                    float real;
+                    memcpy(&real, &bits32, sizeof(real));
+                    value = (double)real;
+                }
+                else
+                {
+                    double real;
+                    memcpy(&real, &bits, sizeof(real));
+                    value = real;
+                }
+                return true;
+            }
+
+        case 0x5:
+        case 0x6:
+        case 0x7:
+            {
+                std::string text;
+                if (!readString(offset, text))
+                    return false;
+                value = std::move(text);
+                return true;
+            }
+
+        case 0xA:
+            {
+                uint64_t count = 0;
+                uint64_t content = 0;
+                std::vector<uint64_t> refs;
+                if (!readCount(offset, info, &count, &content) || !readRefs(content, count, refs))
+                    return false;
+
+                ValueVector array;
+                array.reserve(refs.size());
+                //for (auto& itemRef : refs)
+                for (auto p_itemRef = refs.begin(); p_itemRef != refs.end(); ++p_itemRef)
+                {
+                    Value item;
+                    if (!readObject(*p_itemRef, item, depth + 1))
+                        return false;
+                    if (!item.isNull())
+                        array.push_back(std::move(item));
+                }
+                value = std::move(array);
+                return true;
+            }
+
+        case 0xD:
+            {
+                uint64_t count = 0;
+                uint64_t content = 0;
+                std::vector<uint64_t> refs;
+                // the references of the keys, then the ones of the values
+                if (!readCount(offset, info, &count, &content) || count > 0xffffffffu || !readRefs(content, count * 2, refs))
+                    return false;
+
+                ValueMap dict;
+                dict.reserve((size_t)count);
+                for (size_t i = 0; i < (size_t)count; ++i)
+                {
+                    uint64_t keyOffset = 0;
+                    std::string key;
+                    Value entry;
+                    if (!objectOffset(refs[i], &keyOffset) || !readString(keyOffset, key) || !readObject(refs[(size_t)count + i], entry, depth + 1))
+                        return false;
+                    if (!entry.isNull())
+                        dict[std::move(key)] = std::move(entry);
+                }
+                value = std::move(dict);
+                return true;
+            }
+
+        case 0x3: // date
+        case 0x4: // data
+        case 0x8: // UID
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    const unsigned char* _data;
+    size_t _size;
+    const unsigned char* _offsetTable;
+    uint64_t _objectsEnd;
+    size_t _offsetSize;
+    size_t _refSize;
+    uint64_t _objectCount;
+};
+
+}
+
+bool BinaryPlist::isBinaryPlist(const unsigned char* data, size_t size)
+{
+    // header and trailer
+    return size >= 8 + 32 && memcmp(data, "bplist00", 8) == 0;
+}
+
+bool BinaryPlist::read(const unsigned char* data, size_t size, Value& root)
+{
+    if (!isBinaryPlist(data, size))
+        return false;
+
+    BinaryPlistReader reader(data, size);
+    return reader.read(root);
+}
+
+//
+// CompiledValue
+//
+// Little endian layout:
+//   "CCVB", uint32 version, uint32 string count,
+//   the strings: varint length and bytes,
+//   the root value: a Value::Type byte followed by
+//     BYTE: 1 byte, INTEGER: zigzag varint, FLOAT: uint32 bits, DOUBLE: uint64 bits, BOOLEAN: 1 byte,
+//     STRING: varint string index, VECTOR: varint count and the values,
+//     MAP: varint count, and for each entry the varint key index and the value,
+//     INT_KEY_MAP: varint count, and for each entry the zigzag varint key and the value.
+//
+
+static const char COMPILED_MAGIC[4] = { 'C', 'C', 'V', 'B' };
+static const uint32_t COMPILED_VERSION = 1;
+
+namespace
+{
+
+class CompiledValueWriter
+{
+public:
+    explicit CompiledValueWriter(std::string& out)
+    : _out(out)
+    {
+    }
+
+    void write(const Value& root)
+    {
+        collectStrings(root);
+
+        _out.append(COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+        writeUInt32(COMPILED_VERSION);
+        writeUInt32((uint32_t)_strings.size());
+        //for (auto& text : _strings)
+        for (auto p_text = _strings.begin(); p_text != _strings.end(); ++p_text)
+        {
+            writeVarint(p_text->length());
+            _out.append(*p_text);
+        }
+
+        writeValue(root);
+    }
+
+private:
+    void addString(const std::string& text)
+    {
+        if (_indices.insert(std::make_pair(text, (uint32_t)_strings.size())).second)
+        {
+            _strings.push_back(text);
+        }
+    }
+
+    void collectStrings(const Value& value)
+    {
+        switch (value.getType())
+        {
+        case Value::Type::STRING:
+            addString(value.asString());
+            break;
+        case Value::Type::VECTOR:
+            {
+                const ValueVector& array = value.asValueVector();
+                //for (auto& item : array)
+                for (auto p_item = array.begin(); p_item != array.end(); ++p_item)
+                {
+                    collectStrings(*p_item);
+                }
+            }
+            break;
+        case Value::Type::MAP:
+            {
+                const ValueMap& dict = value.asValueMap();
+                //for (auto& entry : dict)
+                for (auto p_entry = dict.begin(); p_entry != dict.end(); ++p_entry)
+                {
+                    addString(p_entry->first);
+                    collectStrings(p_entry->second);
+                }
+            }
+            break;
+        case Value::Type::INT_KEY_MAP:
+            {
+                const ValueMapIntKey& dict = value.asIntKeyMap();
+                //for (auto& entry : dict)
+                for (auto p_entry = dict.begin(); p_entry != dict.end(); ++p_entry)
+                {
+                    collectStrings(p_entry->second);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void writeUInt32(uint32_t value)
+    {
+        unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+        _out.append((const char*)bytes, sizeof(bytes));
+    }
+
+    void writeUInt64(uint64_t value)
+    {
+        writeUInt32((uint32_t)value);
+        writeUInt32((uint32_t)(value >> 32));
+    }
+
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            _out += (char)((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        _out += (char)value;
+    }
+
+    void writeSigned(int value)
+    {
+        // computed on unsigned bits, shifting a negative int left is undefined
+        uint32_t bits = (uint32_t)value;
+        writeVarint((bits << 1) ^ (0u - (bits >> 31)));
+    }
+
+    void writeValue(const Value& value)
+    {
+        _out += (char)value.getType();
+        switch (value.getType())
+        {
+        case Value::Type::BYTE:
+            _out += (char)value.asByte();
+            break;
+        case Value::Type::INTEGER:
+            writeSigned(value.asInt());
+            break;
+        case Value::Type::FLOAT:
+            {
+                // the bit pattern, in the byte order of the file
+                float real = value.asFloat();
+                uint32_t bits;
+                memcpy(&bits, &real, sizeof(bits));
+                writeUInt32(bits);
+            }
+            break;
+        case Value::Type::DOUBLE:
+            {
+                double real = value.asDouble();
+                uint64_t bits;
+                memcpy(&bits, &real, sizeof(bits));
+                writeUInt64(bits);
+            }
+            break;
+        case Value::Type::BOOLEAN:
+            _out += (char)(value.asBool() ? 1 : 0);
+            break;
+        case Value::Type::STRING:
+            writeVarint(_indices[value.asString()]);
+            break;
+        case Value::Type::VECTOR:
+            {
+                const ValueVector& array = value.asValueVector();
+                writeVarint(array.size());
+                //for (auto& item : array)
+                for (auto p_item = array.begin(); p_item != array.end(); ++p_item)
+                {
+                    writeValue(*p_item);
+                }
+            }
+            break;
+        case Value::Type::MAP:
+            {
+                const ValueMap& dict = value.asValueMap();
+                writeVarint(dict.size());
+                //for (auto& entry : dict)
+                for (auto p_entry = dict.begin(); p_entry != dict.end(); ++p_entry)
+                {
+                    writeVarint(_indices[p_entry->first]);
+                    writeValue(p_entry->second);
+                }
+            }
+            break;
+        case Value::Type::INT_KEY_MAP:
+            {
+                const ValueMapIntKey& dict = value.asIntKeyMap();
+                writeVarint(dict.size());
+                //for (auto& entry : dict)
+                for (auto p_entry = dict.begin(); p_entry != dict.end(); ++p_entry)
+                {
+                    writeSigned(p_entry->first);
+                    writeValue(p_entry->second);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::string& _out;
+    std::unordered_map<std::string, uint32_t> _indices;
+    /** In the order of their indices */
+    std::vector<std::string> _strings;
+};
+
+class CompiledValueReader
+{
+public:
+    CompiledValueReader(const unsigned char* data, size_t size)
+    : _cur(data)
+    , _end(data + size)
+    {
+    }
+
+    bool read(Value& root)
+    {
+        _cur += sizeof(COMPILED_MAGIC);
+        uint32_t version = 0;
+        uint32_t count = 0;
+        if (!readUInt32(&version) || version != COMPILED_VERSION || !readUInt32(&count) || count > (size_t)(_end - _cur))
+            return false;
+
+        _strings.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t length = 0;
+            if (!readVarint(&length) || length > (uint64_t)(_end - _cur))
+                return false;
+            _strings[i].text = (const char*)_cur;
+            _strings[i].length = (size_t)length;
+            _cur += length;
+        }
+
+        return readValue(root, 0) && _cur == _end;
+    }
+
+private:
+    bool readUInt32(uint32_t* value)
+    {
+        if (_end - _cur < 4)
+            return false;
+        *value = _cur[0] | (_cur[1] << 8) | (_cur[2] << 16) | ((uint32_t)_cur[3] << 24);
+        _cur += 4;
+        return true;
+    }
+
+    bool readUInt64(uint64_t* value)
+    {
+        uint32_t low, high;
+        if (_end - _cur < 8 || !readUInt32(&low) || !readUInt32(&high))
+            return false;
+        *value = low | ((uint64_t)high << 32);
+        return true;
+    }
+
+    bool readVarint(uint64_t* value)
+    {
+        *value = 0;
+        for (int shift = 0; shift < 64 && _cur < _end; shift += 7)
+        {
+            unsigned char byte = *_cur++;
+            *value |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool readSigned(int* value)
+    {
+        uint64_t bits = 0;
+        if (!readVarint(&bits))
+            return false;
+        uint32_t zigzag = (uint32_t)bits;
+        *value = (int)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+        return true;
+    }
+
+    bool readString(std::string& text)
+    {
+        uint64_t index = 0;
+        if (!readVarint(&index) || index >= _strings.size())
+            return false;
+        const StringRef& string = _strings[(size_t)index];
+        text.assign(string.text, string.length);
+        return true;
+    }
+
+    bool readValue(Value& value, int depth)
+    {
+        if (_cur >= _end || depth > MAX_DEPTH)
+            return false;
+
+        Value::Type type = (Value::Type)*_cur++;
+        switch (type)
+        {
+        case Value::Type::NONE:
+            return true;
+
+        case Value::Type::BYTE:
+            if (_cur >= _end)
+                return false;
+            value = *_cur++;
+            return true;
+
+        case Value::Type::INTEGER:
+            {
+                int integer = 0;
+                if (!readSigned(&integer))
+                    return false;
+                value = integer;
+                return true;
+            }
+
+        case Value::Type::FLOAT:
+            {
+                uint32_t bits;
+                if (!readUInt32(&bits))
+                    return false;
+                float real;
+                memcpy(&real, &bits, sizeof(real));
+                value = real;
+                return true;
+            }
+
+        case Value::Type::DOUBLE:
+            {
+                uint64_t bits;
+                if (!readUInt64(&bits))
+                    return false;
+                double real;
+                memcpy(&real, &bits, sizeof(real));
+                value = real;
+                return true;
+            }
+
+        case Value::Type::BOOLEAN:
+            if (_cur >= _end)
+                return false;
+            value = *_cur++ != 0;
+            return true;
+
+        case Value::Type::STRING:
+            {
+                // the short strings are copied inside the value without allocating
+                std::string text;
+                if (!readString(text))
+                    return false;
+                value = std::move(text);
+                return true;
+            }
+
+        case Value::Type::VECTOR:
+            {
+                uint64_t count = 0;
+                // every value takes a byte at least
+                if (!readVarint(&count) || count > (uint64_t)(_end - _cur))
+                    return false;
+
+                ValueVector array((size_t)count);
+                for (size_t i = 0; i < (size_t)count; ++i)
+                {
+                    if (!readValue(array[i], depth + 1))
+                        return false;
+                }
+                value = std::move(array);
+                return true;
+            }
+
+        case Value::Type::MAP:
+            {
+                uint64_t count = 0;
+                if (!readVarint(&count) || count > (uint64_t)(_end - _cur))
+                    return false;
+
+                ValueMap dict;
+                dict.reserve((size_t)count);
+                for (size_t i = 0; i < (size_t)count; ++i)
+                {
+                    std::string key;
+                    if (!readString(key) || !readValue(dict[std::move(key)], depth + 1))
+                        return false;
+                }
+                value = std::move(dict);
+                return true;
+            }
+
+        case Value::Type::INT_KEY_MAP:
+            {
+                uint64_t count = 0;
+                if (!readVarint(&count) || count > (uint64_t)(_end - _cur))
+                    return false;
+
+                ValueMapIntKey dict;
+                dict.reserve((size_t)count);
+                for (size_t i = 0; i < (size_t)count; ++i)
+                {
+                    int key = 0;
+                    if (!readSigned(&key) || !readValue(dict[key], depth + 1))
+                        return false;
+                }
+                value = std::move(dict);
+                return true;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    // the strings of the table point in the data, and are copied once, in their key or value
+    struct StringRef
+    {
+        const char* text;
+        size_t length;
+    };
+
+    const unsigned char* _cur;
+    const unsigned char* _end;
+    std::vector<StringRef> _strings;
+};
+
+}
+
+bool CompiledValue::isCompiledValue(const unsigned char* data, size_t size)
+{
+    return size >= sizeof(COMPILED_MAGIC) && memcmp(data, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) == 0;
+}
+
+bool CompiledValue::read(const unsigned char* data, size_t size, Value& root)
+{
+    if (!isCompiledValue(data, size))
+        return false;
+
+    CompiledValueReader reader(data, size);
+    return reader.read(root);
+}
+
+void CompiledValue::write(const Value& root, std::string& out)
+{
+    CompiledValueWriter writer(out);
+    writer.write(root);
+}
+
+NS_CC_END
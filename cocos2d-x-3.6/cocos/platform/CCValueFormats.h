@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_VALUE_FORMATS_H__
+#define __CC_VALUE_FORMATS_H__
+
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCValue.h"
+
+/**
+ * @addtogroup support
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class BinaryPlist
+ * @brief Reads the Apple binary property lists (bplist00), as written by `plutil -convert binary1`.
+ *
+ * Dates, data and UIDs are skipped, like the XML plist parser does. Integers are read as int.
+ * FileUtils::getValueMapFromFile() and FileUtils::getValueVectorFromFile() recognize these files by themselves.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL BinaryPlist
+{
+public:
+    /** Checks whether a buffer starts like a binary plist. */
+    static bool isBinaryPlist(const unsigned char* data, size_t size);
+
+    /** Reads the root object of a binary plist.
+     * @return False if the plist is corrupted.
+     */
+    static bool read(const unsigned char* data, size_t size, Value& root);
+};
+
+/** @class CompiledValue
+ * @brief A compact binary serialization of the values, meant to load the plists of a game in one pass at startup.
+ *
+ * The strings, keys included, are stored once in a table at the beginning of the file, followed by the tree of values
+ * with the sizes of the containers, so they are reserved up front. Integers are variable length encoded.
+ * Files are written with FileUtils::writeValueMapToCompiledFile() or converted from plists at build time with
+ * FileUtils::compilePlistFile(), and read by FileUtils::getValueMapFromFile() and FileUtils::getValueVectorFromFile().
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL CompiledValue
+{
+public:
+    /** Checks whether a buffer starts like a compiled value. */
+    static bool isCompiledValue(const unsigned char* data, size_t size);
+
+    /** Reads a compiled value.
+     * @return False if the data is corrupted.
+     */
+    static bool read(const unsigned char* data, size_t size, Value& root);
+
+    /** Serializes a value, appended to out. */
+    static void write(const Value& root, std::string& out);
+};
+
+NS_CC_END
+
+// end of support group
+/// @}
+
+#endif // __CC_VALUE_FORMATS_H__
@@ -310,6 +310,10 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
 
 std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
 {
+    std::string packString;
+    if (getStringFromAssetPack(filename, &packString))
+        return packString;
+
     Data data = getData(filename, true);
     if (data.isNull())
         return "";
@@ -320,9 +324,66 @@ std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
     
 Data FileUtilsAndroid::getDataFromFile(const std::string& filename)
 {
+    Data packData;
+    if (getDataFromAssetPack(filename, &packData))
+        return packData;
+
     return getData(filename, false);
 }
 
+MappedData* FileUtilsAndroid::getMappedDataFromFile(const std::string& filename)
+{
+    if (filename.empty())
+        return nullptr;
+
+    MappedData* packData = nullptr;
+    if (getMappedDataFromAssetPack(filename, &packData))
+        return packData;
+
+    string fullPath = fullPathForFilename(filename);
+    if (fullPath[0] == '/' || nullptr == FileUtilsAndroid::assetmanager)
+    {
+        return FileUtils::getMappedDataFromFile(filename);
+    }
+
+    cocosplay::updateAssets(fullPath);
+
+    string relativePath = fullPath;
+    if (0 == fullPath.find("assets/"))
+    {
+        // "assets/" is at the beginning of the path and we don't want it
+        relativePath = fullPath.substr(strlen("assets/"));
+    }
+
+    AAsset* asset = AAssetManager_open(FileUtilsAndroid::assetmanager, relativePath.c_str(), AASSET_MODE_BUFFER);
+    if (nullptr == asset)
+    {
+        return FileUtils::getMappedDataFromFile(filename);
+    }
+
+    // the buffer of an asset stored uncompressed is mapped from the apk, a compressed one is inflated once
+    const void* buffer = AAsset_getBuffer(asset);
+    off_t size = AAsset_getLength(asset);
+    if (nullptr == buffer || size <= 0)
+    {
+        AAsset_close(asset);
+        return FileUtils::getMappedDataFromFile(filename);
+    }
+
+    cocosplay::notifyFileLoaded(fullPath);
+
+    MappedData* ret = new (std::nothrow) MappedData();
+    if (ret == nullptr)
+    {
+        AAsset_close(asset);
+        return nullptr;
+    }
+    ret->initWithBytes(static_cast<const unsigned char*>(buffer), size, [asset]() {
+        AAsset_close(asset);
+    });
+    return ret;
+}
+
 unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const char* mode, ssize_t * size)
 {    
     unsigned char * data = 0;
@@ -331,6 +392,9 @@ unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const
     {
         return 0;
     }
+
+    if (getFileDataFromAssetPack(filename, &data, size))
+        return data;
     
     string fullPath = fullPathForFilename(filename);
     cocosplay::updateAssets(fullPath);
@@ -77,6 +77,11 @@ public:
      */
     virtual Data getDataFromFile(const std::string& filename) override;
 
+    /**
+     *  Maps the buffer of the assets stored uncompressed in the apk.
+     */
+    virtual MappedData* getMappedDataFromFile(const std::string& filename) override;
+
     virtual std::string getWritablePath() const;
     virtual bool isAbsolutePath(const std::string& strPath) const;
     
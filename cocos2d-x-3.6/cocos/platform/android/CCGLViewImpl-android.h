@@ -48,6 +48,8 @@ public:
     void end() override;
     void swapBuffers() override;
     void setIMEKeyboardState(bool bOpen) override;
+    // GLSurfaceView swaps the buffers after every frame, a skipped frame would show an undefined back buffer
+    bool isFrameSkippingSupported() const override { return false; }
 
 protected:
     GLViewImpl();
@@ -205,6 +205,10 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
 {
+    std::string packString;
+    if (getStringFromAssetPack(filename, &packString))
+        return packString;
+
     Data data = getData(filename, true);
 	if (data.isNull())
 	{
@@ -217,6 +221,10 @@ std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
     
 Data FileUtilsWin32::getDataFromFile(const std::string& filename)
 {
+    Data packData;
+    if (getDataFromAssetPack(filename, &packData))
+        return packData;
+
     return getData(filename, false);
 }
 
@@ -224,6 +232,10 @@ unsigned char* FileUtilsWin32::getFileData(const std::string& filename, const ch
 {
     unsigned char * pBuffer = nullptr;
     *size = 0;
+
+    if (getFileDataFromAssetPack(filename, &pBuffer, size))
+        return pBuffer;
+
     do
     {
         // read the file from hardware
@@ -129,6 +129,8 @@ void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &
 	*_value.callback = callback;
 
     _useCallback = true;
+    // the new value only reaches the screen if render on demand draws a frame
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setFloat(float value)
@@ -136,6 +138,7 @@ void UniformValue::setFloat(float value)
     CCASSERT (_uniform->type == GL_FLOAT, "");
     _value.floatValue = value;
     _useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
@@ -144,12 +147,14 @@ void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
     _value.tex.textureId = textureId;
     _value.tex.textureUnit = textureUnit;
     _useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 void UniformValue::setInt(int value)
 {
     CCASSERT(_uniform->type == GL_INT, "Wrong type: expecting GL_INT");
     _value.intValue = value;
     _useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setVec2(const Vec2& value)
@@ -157,6 +162,7 @@ void UniformValue::setVec2(const Vec2& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC2, "");
 	memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
     _useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setVec3(const Vec3& value)
@@ -164,6 +170,7 @@ void UniformValue::setVec3(const Vec3& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC3, "");
 	memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
 	_useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setVec4(const Vec4& value)
@@ -171,6 +178,7 @@ void UniformValue::setVec4(const Vec4& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC4, "");
 	memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
 	_useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 void UniformValue::setMat4(const Mat4& value)
@@ -178,6 +186,7 @@ void UniformValue::setMat4(const Mat4& value)
     CCASSERT(_uniform->type == GL_FLOAT_MAT4, "");
 	memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
 	_useCallback = false;
+    Director::getInstance()->requestRedraw();
 }
 
 //
@@ -40,6 +40,8 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCProfiling.h"
+#include "base/ccUtils.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
@@ -199,6 +201,8 @@ Renderer::Renderer()
 ,_glViewAssigned(false)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_renderTimeEnabled(false)
+,_renderTime(0)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -220,14 +224,18 @@ Renderer::~Renderer()
     _renderGroups.clear();
     _groupCommandManager->release();
     
-    glDeleteBuffers(2, _buffersVBO);
-    glDeleteBuffers(2, _quadbuffersVBO);
-    
-    if (Configuration::getInstance()->supportsShareableVAO())
+    // the buffers are created with the GL view, a headless director has none
+    if (_glViewAssigned)
     {
-        glDeleteVertexArrays(1, &_buffersVAO);
-        glDeleteVertexArrays(1, &_quadVAO);
-        GL::bindVAO(0);
+        glDeleteBuffers(2, _buffersVBO);
+        glDeleteBuffers(2, _quadbuffersVBO);
+        
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            glDeleteVertexArrays(1, &_buffersVAO);
+            glDeleteVertexArrays(1, &_quadVAO);
+            GL::bindVAO(0);
+        }
     }
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_cacheTextureListener);
@@ -617,6 +625,10 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
 
 void Renderer::render()
 {
+    CC_PROFILER_ZONE("Renderer::render");
+
+    double startTime = _renderTimeEnabled ? utils::gettime() : 0;
+
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -637,6 +649,11 @@ void Renderer::render()
     }
     clean();
     _isRendering = false;
+
+    if (_renderTimeEnabled)
+    {
+        _renderTime += utils::gettime() - startTime;
+    }
 }
 
 void Renderer::clean()
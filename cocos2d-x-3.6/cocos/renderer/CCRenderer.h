@@ -176,6 +176,10 @@ public:
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
     /* clear draw stats */
     void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    /* enables measuring the time spent in render() and resets it, used by the performance stream of Console */
+    void setRenderTimeEnabled(bool enabled) { _renderTimeEnabled = enabled; _renderTime = 0; }
+    /* returns the seconds spent in render() since the measure was enabled */
+    double getRenderTime() const { return _renderTime; }
 
     /**
      * Enable/Disable depth test
@@ -254,6 +258,9 @@ protected:
     bool _isRendering;
     
     bool _isDepthTestFor2D;
+
+    bool _renderTimeEnabled;
+    double _renderTime;
     
     GroupCommandManager* _groupCommandManager;
     
@@ -690,6 +690,9 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
     // shader
     setGLProgram(GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE));
+
+    // the sprites using a reloaded or asynchronously loaded texture have to be drawn again
+    Director::getInstance()->requestRedraw();
     return true;
 }
 
@@ -701,6 +704,7 @@ bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int widt
         const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
         glTexSubImage2D(GL_TEXTURE_2D,0,offsetX,offsetY,width,height,info.format, info.type,data);
 
+        Director::getInstance()->requestRedraw();
         return true;
     }
     return false;
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCProfiling.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 
@@ -174,6 +175,7 @@ void TextureCache::unbindAllImageAsync()
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
+    CC_PROFILER_THREAD_NAME("TextureCache");
 
     while (true)
     {
@@ -222,6 +224,7 @@ void TextureCache::loadImage()
 
         if (generateImage)
         {
+            CC_PROFILER_ZONE("TextureCache::loadImage");
             const std::string& filename = asyncStruct->filename;
             // generate image      
             image = new (std::nothrow) Image();
@@ -575,6 +578,19 @@ std::string TextureCache::getCachedTextureInfo() const
     return buffer;
 }
 
+size_t TextureCache::getCachedTextureBytes() const
+{
+    size_t totalBytes = 0;
+
+    for( auto it = _textures.begin(); it != _textures.end(); ++it ) {
+        Texture2D* tex = it->second;
+        // Each texture takes up width * height * bytesPerPixel bytes.
+        totalBytes += (size_t)tex->getPixelsWide() * tex->getPixelsHigh() * tex->getBitsPerPixelForFormat() / 8;
+    }
+
+    return totalBytes;
+}
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 
 std::list<VolatileTexture*> VolatileTextureMgr::_textures;
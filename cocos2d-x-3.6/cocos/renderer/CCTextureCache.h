@@ -189,6 +189,12 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Returns the total texture memory used by the cached textures, calculated like getCachedTextureInfo does.
+     *
+     * @return The size in bytes.
+     */
+    size_t getCachedTextureBytes() const;
+
     //Wait for texture cahe to quit befor destroy instance.
     /**Called by director, please do not called outside.*/
     void waitForQuit();
@@ -1154,7 +1154,7 @@ namespace ui {
         }
         if( _reorderProtectedChildDirty )
         {
-            std::sort( std::begin(_protectedChildren), std::end(_protectedChildren), nodeComparisonLess );
+            sortNodes(_protectedChildren);
             _reorderProtectedChildDirty = false;
         }
     }
@@ -173,7 +173,7 @@ bool AssetsManager::checkUpdate()
     
     if (res != 0)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
             if (this->_delegate)
                 this->_delegate->onError(AssetsManager::ErrorCode::NETWORK);
         });
@@ -185,7 +185,7 @@ bool AssetsManager::checkUpdate()
     string recordedVersion = UserDefault::getInstance()->getStringForKey(keyOfVersion().c_str());
     if (recordedVersion == _version)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
             if (this->_delegate)
                 this->_delegate->onError(AssetsManager::ErrorCode::NO_NEW_VERSION);
         });
@@ -208,7 +208,7 @@ void AssetsManager::downloadAndUncompress()
         {
             if (! downLoad()) break;
             
-            Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+            Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
                 UserDefault::getInstance()->setStringForKey(this->keyOfDownloadedVersion().c_str(),
                                                             this->_version.c_str());
                 UserDefault::getInstance()->flush();
@@ -218,7 +218,7 @@ void AssetsManager::downloadAndUncompress()
         // Uncompress zip file.
         if (! uncompress())
         {
-            Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+            Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
             	UserDefault::getInstance()->setStringForKey(this->keyOfDownloadedVersion().c_str(),"");
                 UserDefault::getInstance()->flush();
                 if (this->_delegate)
@@ -227,7 +227,7 @@ void AssetsManager::downloadAndUncompress()
             break;
         }
         
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this] {
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this] {
             
             // Record new version code.
             UserDefault::getInstance()->setStringForKey(this->keyOfVersion().c_str(), this->_version.c_str());
@@ -508,7 +508,7 @@ int assetsManagerProgressFunc(void *ptr, double totalToDownload, double nowDownl
     if (percent != tmp)
     {
         percent = tmp;
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
             auto manager = static_cast<AssetsManager*>(ptr);
             if (manager->_delegate)
                 manager->_delegate->onProgress(percent);
@@ -527,7 +527,7 @@ bool AssetsManager::downLoad()
     FILE *fp = fopen(outFileName.c_str(), "wb");
     if (! fp)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
             if (this->_delegate)
                 this->_delegate->onError(AssetsManager::ErrorCode::CREATE_FILE);
         });
@@ -552,7 +552,7 @@ bool AssetsManager::downLoad()
     curl_easy_cleanup(_curl);
     if (res != 0)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
             if (this->_delegate)
                 this->_delegate->onError(AssetsManager::ErrorCode::NETWORK);
         });
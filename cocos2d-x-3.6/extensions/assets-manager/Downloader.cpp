@@ -80,7 +80,7 @@ int batchDownloadProgressFunc(Downloader::ProgressData *ptr, double totalToDownl
         
         if (nowDownloaded == totalToDownload)
         {
-            Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+            Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
                 if (!data.downloader.expired())
                 {
                     std::shared_ptr<Downloader> downloader = data.downloader.lock();
@@ -100,7 +100,7 @@ int batchDownloadProgressFunc(Downloader::ProgressData *ptr, double totalToDownl
         }
         else
         {
-            Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+            Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
                 if (!data.downloader.expired())
                 {
                     std::shared_ptr<Downloader> downloader = data.downloader.lock();
@@ -131,7 +131,7 @@ int downloadProgressFunc(Downloader::ProgressData *ptr, double totalToDownload,
         ptr->downloaded = nowDownloaded;
         Downloader::ProgressData data = *ptr;
         
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
             if (!data.downloader.expired())
             {
                 std::shared_ptr<Downloader> downloader = data.downloader.lock();
@@ -176,7 +176,7 @@ void Downloader::setConnectionTimeout(int timeout)
 void Downloader::notifyError(ErrorCode code, const std::string &msg/* ="" */, const std::string &customId/* ="" */, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
 {
     std::weak_ptr<Downloader> ptr = shared_from_this();
-    Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+    Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
         if (!ptr.expired())
         {
             std::shared_ptr<Downloader> downloader = ptr.lock();
@@ -380,7 +380,7 @@ void Downloader::downloadToBuffer(const std::string &srcUrl, const std::string &
     
     curl_easy_cleanup(curl);
     
-    Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+    Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
         if (!ptr.expired())
         {
             std::shared_ptr<Downloader> downloader = ptr.lock();
@@ -459,7 +459,7 @@ void Downloader::download(const std::string &srcUrl, const std::string &customId
     {
         _fileUtils->renameFile(data.path, data.name + TEMP_EXT, data.name);
         
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
+        Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([=]{
             if (!ptr.expired())
             {
                 std::shared_ptr<Downloader> downloader = ptr.lock();
@@ -524,7 +524,7 @@ void Downloader::batchDownloadSync(const DownloadUnits &units, const std::string
         }
     }
     
-    Director::getInstance()->getScheduler()->performFunctionInCocosThread([ptr, batchId]{
+    Director::getMainInstance()->getScheduler()->performFunctionInCocosThread([ptr, batchId]{
         if (!ptr.expired()) {
             std::shared_ptr<Downloader> downloader = ptr.lock();
             auto callback = downloader->getSuccessCallback();
@@ -1,5 +1,6 @@
 #include "HelloWorldScene.h"
 #include "AppMacros.h"
+#include "benchmarks/BenchmarkScene.h"
 
 USING_NS_CC;
 
@@ -44,8 +45,14 @@ bool HelloWorld::init()
     
     closeItem->setPosition(origin + Vec2(visibleSize) - Vec2(closeItem->getContentSize() / 2));
 
+    // add a "Benchmarks" item, which lists the scenes measuring the engine
+    auto benchmarksItem = MenuItemLabel::create(Label::createWithTTF("Benchmarks", "fonts/arial.ttf", TITLE_FONT_SIZE * 0.75f),
+                                                [](Ref*) { Director::getInstance()->replaceScene(BenchmarkList::scene()); });
+
+    benchmarksItem->setPosition(origin + Vec2(benchmarksItem->getContentSize() / 2 + Size(10, 10)));
+
     // create menu, it's an autorelease object
-    auto menu = Menu::create(closeItem, nullptr);
+    auto menu = Menu::create(closeItem, benchmarksItem, nullptr);
     menu->setPosition(Vec2::ZERO);
     this->addChild(menu, 1);
     
@@ -0,0 +1,250 @@
+#include "AssetPackBenchmark.h"
+#include "base/CCAssetPack.h"
+#include "base/ZipUtils.h"
+
+#include <zlib.h>
+
+USING_NS_CC;
+
+static const int TEXT_FILE_COUNT = 200;
+static const int TEXT_FILE_SIZE = 16 * 1024;
+static const int IMAGE_FILE_COUNT = 200;
+static const int IMAGE_FILE_SIZE = 32 * 1024;
+static const int PASS_COUNT = 3;
+
+std::string AssetPackBenchmark::title() const
+{
+    return "Asset pack";
+}
+
+static void writeUInt16(std::string& out, unsigned int value)
+{
+    out += (char)(value & 0xff);
+    out += (char)((value >> 8) & 0xff);
+}
+
+static void writeUInt32(std::string& out, unsigned int value)
+{
+    writeUInt16(out, value & 0xffff);
+    writeUInt16(out, value >> 16);
+}
+
+// Writes a zip archive, the "png" files stored and the others deflated, as the APK packaging does
+static bool writeZip(const std::string& sourceDir, const std::vector<std::string>& files, const std::string& zipPath)
+{
+    std::string archive;
+    std::string directory;
+
+    //for (const auto& file : files)
+    for (auto iter = files.begin(); iter != files.end(); ++iter)
+    {
+        const std::string& file = *iter;
+        Data data = FileUtils::getInstance()->getDataFromFile(sourceDir + file);
+        unsigned int crc = crc32(0, data.getBytes(), (uInt)data.getSize());
+        bool store = file.find(".png") != std::string::npos;
+
+        std::string content;
+        if (store)
+        {
+            content.assign((const char*)data.getBytes(), data.getSize());
+        }
+        else
+        {
+            z_stream stream;
+            memset(&stream, 0, sizeof(stream));
+            deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            content.resize(deflateBound(&stream, (uLong)data.getSize()));
+            stream.next_in = data.getBytes();
+            stream.avail_in = (uInt)data.getSize();
+            stream.next_out = (Bytef*)&content[0];
+            stream.avail_out = (uInt)content.size();
+            deflate(&stream, Z_FINISH);
+            content.resize(stream.total_out);
+            deflateEnd(&stream);
+        }
+
+        unsigned int offset = (unsigned int)archive.size();
+        unsigned int method = store ? 0 : Z_DEFLATED;
+
+        writeUInt32(archive, 0x04034b50);
+        writeUInt16(archive, 20);
+        writeUInt16(archive, 0);
+        writeUInt16(archive, method);
+        writeUInt32(archive, 0);
+        writeUInt32(archive, crc);
+        writeUInt32(archive, (unsigned int)content.size());
+        writeUInt32(archive, (unsigned int)data.getSize());
+        writeUInt16(archive, (unsigned int)file.size());
+        writeUInt16(archive, 0);
+        archive += file;
+        archive += content;
+
+        writeUInt32(directory, 0x02014b50);
+        writeUInt16(directory, 20);
+        writeUInt16(directory, 20);
+        writeUInt16(directory, 0);
+        writeUInt16(directory, method);
+        writeUInt32(directory, 0);
+        writeUInt32(directory, crc);
+        writeUInt32(directory, (unsigned int)content.size());
+        writeUInt32(directory, (unsigned int)data.getSize());
+        writeUInt16(directory, (unsigned int)file.size());
+        writeUInt16(directory, 0);
+        writeUInt16(directory, 0);
+        writeUInt16(directory, 0);
+        writeUInt16(directory, 0);
+        writeUInt32(directory, 0);
+        writeUInt32(directory, offset);
+        directory += file;
+    }
+
+    unsigned int directoryOffset = (unsigned int)archive.size();
+    archive += directory;
+    writeUInt32(archive, 0x06054b50);
+    writeUInt16(archive, 0);
+    writeUInt16(archive, 0);
+    writeUInt16(archive, (unsigned int)files.size());
+    writeUInt16(archive, (unsigned int)files.size());
+    writeUInt32(archive, (unsigned int)directory.size());
+    writeUInt32(archive, directoryOffset);
+    writeUInt16(archive, 0);
+
+    FILE* fp = fopen(zipPath.c_str(), "wb");
+    if (fp == nullptr)
+        return false;
+    fwrite(archive.data(), 1, archive.size(), fp);
+    fclose(fp);
+    return true;
+}
+
+void AssetPackBenchmark::runBenchmark()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string sourceDir = fileUtils->getWritablePath() + "benchmark_pack/";
+    std::string mountDir = fileUtils->getWritablePath() + "benchmark_pack_mount/";
+    std::string packPath = fileUtils->getWritablePath() + "benchmark.ccpk";
+    std::string zipPath = fileUtils->getWritablePath() + "benchmark.zip";
+
+    // text that compresses like plists and json do, and noise standing for the images
+    std::vector<std::string> files;
+    for (int i = 0; i < TEXT_FILE_COUNT; ++i)
+    {
+        files.push_back(StringUtils::format("data/level_%03d.json", i));
+    }
+    for (int i = 0; i < IMAGE_FILE_COUNT; ++i)
+    {
+        files.push_back(StringUtils::format("images/sprite_%03d.png", i));
+    }
+
+    if (!fileUtils->isFileExist(packPath) || !fileUtils->isFileExist(zipPath))
+    {
+        fileUtils->createDirectory(sourceDir + "data");
+        fileUtils->createDirectory(sourceDir + "images");
+
+        unsigned int seed = 1;
+        for (int i = 0; i < TEXT_FILE_COUNT + IMAGE_FILE_COUNT; ++i)
+        {
+            std::string content;
+            if (i < TEXT_FILE_COUNT)
+            {
+                while (content.size() < TEXT_FILE_SIZE)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    content += StringUtils::format("{\"id\": %u, \"x\": %u, \"y\": %u, \"type\": \"enemy\"},\n",
+                                                   (unsigned int)content.size(), (seed >> 16) % 2048, (seed >> 4) % 2048);
+                }
+            }
+            else
+            {
+                while (content.size() < IMAGE_FILE_SIZE)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    content += (char)(seed >> 16);
+                }
+            }
+
+            FILE* fp = fopen((sourceDir + files[i]).c_str(), "wb");
+            if (fp == nullptr)
+            {
+                addResult("can't write %s", (sourceDir + files[i]).c_str());
+                return;
+            }
+            fwrite(content.data(), 1, content.size(), fp);
+            fclose(fp);
+        }
+
+        if (!AssetPack::build(sourceDir, files, packPath) || !writeZip(sourceDir, files, zipPath))
+        {
+            addResult("can't write the archives");
+            return;
+        }
+    }
+
+    addResult("%d files, pack %ld KB, zip %ld KB", (int)files.size(),
+              fileUtils->getFileSize(packPath) / 1024, fileUtils->getFileSize(zipPath) / 1024);
+
+    // reads the text files then the images, the first pass warms the page cache
+    auto measure = [this, &files](const char* label, const std::function<ssize_t(const std::string&)>& read) {
+        double best[2] = { 0, 0 };
+        ssize_t total[2] = { 0, 0 };
+        for (int pass = 0; pass <= PASS_COUNT; ++pass)
+        {
+            for (int kind = 0; kind < 2; ++kind)
+            {
+                auto first = files.begin() + (kind == 0 ? 0 : TEXT_FILE_COUNT);
+                auto last = (kind == 0) ? files.begin() + TEXT_FILE_COUNT : files.end();
+
+                total[kind] = 0;
+                double start = now();
+                for (auto iter = first; iter != last; ++iter)
+                {
+                    total[kind] += read(*iter);
+                }
+                double elapsed = now() - start;
+                if (pass == 1 || (pass > 1 && elapsed < best[kind]))
+                    best[kind] = elapsed;
+            }
+        }
+        addResult("%s: text %.1f ms, %.0f MB/s, images %.1f ms, %.0f MB/s", label,
+                  best[0], total[0] / best[0] / 1000, best[1], total[1] / best[1] / 1000);
+    };
+
+    measure("loose files, getDataFromFile", [&](const std::string& file) {
+        return fileUtils->getDataFromFile(sourceDir + file).getSize();
+    });
+
+    measure("zip, getFileDataFromZip", [&](const std::string& file) {
+        ssize_t size = 0;
+        unsigned char* bytes = fileUtils->getFileDataFromZip(zipPath, file, &size);
+        free(bytes);
+        return size;
+    });
+
+    // as the OBB reader, with the central directory loaded once
+    ZipFile zipFile(zipPath);
+    measure("zip, ZipFile::getFileData", [&](const std::string& file) {
+        ssize_t size = 0;
+        unsigned char* bytes = zipFile.getFileData(file, &size);
+        free(bytes);
+        return size;
+    });
+
+    if (!fileUtils->mountAssetPack(packPath, mountDir))
+    {
+        addResult("can't mount the pack");
+        return;
+    }
+
+    measure("pack, getDataFromFile", [&](const std::string& file) {
+        return fileUtils->getDataFromFile(mountDir + file).getSize();
+    });
+
+    measure("pack, getMappedDataFromFile", [&](const std::string& file) {
+        MappedData* data = fileUtils->getMappedDataFromFile(mountDir + file);
+        ssize_t size = data ? data->getSize() : 0;
+        CC_SAFE_RELEASE(data);
+        return size;
+    });
+
+    fileUtils->unmountAssetPack(packPath);
+}
@@ -0,0 +1,16 @@
+#ifndef __ASSET_PACK_BENCHMARK_H__
+#define __ASSET_PACK_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Reads the same files loose, from a zip archive as the APK and OBB readers do, and from a mounted AssetPack
+class AssetPackBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(AssetPackBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __ASSET_PACK_BENCHMARK_H__
@@ -0,0 +1,292 @@
+#include "BenchmarkScene.h"
+#include "../HelloWorldScene.h"
+#include "TouchDispatchBenchmark.h"
+#include "CustomEventBenchmark.h"
+#include "BulletPoolBenchmark.h"
+#include "TransformHierarchyBenchmark.h"
+#include "ChildSortBenchmark.h"
+#include "MappedFileBenchmark.h"
+#include "AssetPackBenchmark.h"
+#include "PlistParseBenchmark.h"
+#include "PlistFormatBenchmark.h"
+#include "ValueMemoryBenchmark.h"
+#include "PvrCczBenchmark.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+USING_NS_CC;
+
+// The allocations are counted by replacing the global operator new of the app. The engine is a DLL on win32,
+// whose allocations wouldn't go through it, so nothing is counted there.
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
+#define BENCHMARK_COUNT_ALLOCATIONS 1
+
+static std::atomic<long> s_allocationCount(0);
+
+void* operator new(size_t size)
+{
+    ++s_allocationCount;
+    void* ptr = malloc(size ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    ++s_allocationCount;
+    void* ptr = malloc(size ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+    ++s_allocationCount;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+    ++s_allocationCount;
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) throw()
+{
+    free(ptr);
+}
+#endif
+
+static const float RESULT_FONT_SIZE = 12;
+
+BenchmarkLayer::BenchmarkLayer()
+: _resultsLabel(nullptr)
+{
+}
+
+Scene* BenchmarkLayer::scene(BenchmarkLayer* layer)
+{
+    auto scene = Scene::create();
+    scene->addChild(layer);
+    return scene;
+}
+
+bool BenchmarkLayer::init()
+{
+    if ( !Layer::init() )
+    {
+        return false;
+    }
+
+    auto visibleSize = Director::getInstance()->getVisibleSize();
+    auto origin = Director::getInstance()->getVisibleOrigin();
+
+    auto titleLabel = Label::createWithTTF(title(), "fonts/arial.ttf", 20);
+    titleLabel->setPosition(origin.x + visibleSize.width/2, origin.y + visibleSize.height - 20);
+    this->addChild(titleLabel, 1);
+
+    _resultsLabel = Label::createWithTTF("Running...", "fonts/arial.ttf", RESULT_FONT_SIZE);
+    _resultsLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _resultsLabel->setAlignment(TextHAlignment::LEFT);
+    _resultsLabel->setPosition(origin.x + 10, origin.y + visibleSize.height - 40);
+    this->addChild(_resultsLabel, 1);
+
+    auto backItem = MenuItemLabel::create(Label::createWithTTF("Back", "fonts/arial.ttf", 20),
+                                          CC_CALLBACK_1(BenchmarkLayer::menuBackCallback, this));
+    backItem->setPosition(origin.x + visibleSize.width - 40, origin.y + 20);
+
+    auto menu = Menu::create(backItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    this->addChild(menu, 1);
+
+    return true;
+}
+
+void BenchmarkLayer::onEnter()
+{
+    Layer::onEnter();
+
+    // runs on the next frame, after the title is shown
+    scheduleOnce([this](float) {
+        runBenchmark();
+        log("%s: done", title().c_str());
+    }, 0, "runBenchmark");
+}
+
+void BenchmarkLayer::addResult(const char* format, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    log("%s: %s", title().c_str(), buf);
+
+    if (!_results.empty())
+        _results += "\n";
+    _results += buf;
+    _resultsLabel->setString(_results);
+}
+
+double BenchmarkLayer::now()
+{
+    return utils::gettime() * 1000;
+}
+
+// reads a field in KB of /proc/self/status
+static long getStatusField(const char* field)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    FILE* fp = fopen("/proc/self/status", "r");
+    if (fp == nullptr)
+        return -1;
+
+    long value = -1;
+    size_t length = strlen(field);
+    char line[256];
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (strncmp(line, field, length) == 0 && line[length] == ':')
+        {
+            value = atol(line + length + 1);
+            break;
+        }
+    }
+    fclose(fp);
+    return value;
+#else
+    return -1;
+#endif
+}
+
+long BenchmarkLayer::getPeakMemory()
+{
+    return getStatusField("VmHWM");
+}
+
+void BenchmarkLayer::resetPeakMemory()
+{
+#ifdef __GLIBC__
+    // the freed heap pages stay resident otherwise, and the next allocations wouldn't raise the peak
+    malloc_trim(0);
+#endif
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    // "5" resets the peak resident size to the current one, since Linux 4.0
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (fp)
+    {
+        fputs("5", fp);
+        fclose(fp);
+    }
+#endif
+}
+
+long BenchmarkLayer::getAnonymousMemory()
+{
+    // since Linux 4.5
+    return getStatusField("RssAnon");
+}
+
+long BenchmarkLayer::getAllocationCount()
+{
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+    return s_allocationCount;
+#else
+    return -1;
+#endif
+}
+
+void BenchmarkLayer::menuBackCallback(Ref* sender)
+{
+    Director::getInstance()->replaceScene(BenchmarkList::scene());
+}
+
+const std::vector<BenchmarkList::Entry>& BenchmarkList::getBenchmarks()
+{
+    static std::vector<Entry> benchmarks;
+    if (benchmarks.empty())
+    {
+        benchmarks.push_back({ "Touch dispatch", []() -> BenchmarkLayer* { return TouchDispatchBenchmark::create(); } });
+        benchmarks.push_back({ "Custom event dispatch", []() -> BenchmarkLayer* { return CustomEventBenchmark::create(); } });
+        benchmarks.push_back({ "Bullet pool", []() -> BenchmarkLayer* { return BulletPoolBenchmark::create(); } });
+        benchmarks.push_back({ "Transform hierarchy", []() -> BenchmarkLayer* { return TransformHierarchyBenchmark::create(); } });
+        benchmarks.push_back({ "Child sort", []() -> BenchmarkLayer* { return ChildSortBenchmark::create(); } });
+        benchmarks.push_back({ "Mapped files", []() -> BenchmarkLayer* { return MappedFileBenchmark::create(); } });
+        benchmarks.push_back({ "Asset pack", []() -> BenchmarkLayer* { return AssetPackBenchmark::create(); } });
+        benchmarks.push_back({ "Plist parse", []() -> BenchmarkLayer* { return PlistParseBenchmark::create(); } });
+        benchmarks.push_back({ "Plist formats", []() -> BenchmarkLayer* { return PlistFormatBenchmark::create(); } });
+        benchmarks.push_back({ "Value memory", []() -> BenchmarkLayer* { return ValueMemoryBenchmark::create(); } });
+        benchmarks.push_back({ "pvr.ccz load", []() -> BenchmarkLayer* { return PvrCczBenchmark::create(); } });
+    }
+    return benchmarks;
+}
+
+Scene* BenchmarkList::scene()
+{
+    auto scene = Scene::create();
+    scene->addChild(BenchmarkList::create());
+    return scene;
+}
+
+bool BenchmarkList::init()
+{
+    if ( !Layer::init() )
+    {
+        return false;
+    }
+
+    auto visibleSize = Director::getInstance()->getVisibleSize();
+    auto origin = Director::getInstance()->getVisibleOrigin();
+
+    auto menu = Menu::create();
+    const auto& benchmarks = getBenchmarks();
+    //for (const auto& entry : benchmarks)
+    for (auto iter = benchmarks.cbegin(); iter != benchmarks.cend(); ++iter)
+    {
+        auto create = iter->create;
+        auto item = MenuItemLabel::create(Label::createWithTTF(iter->name, "fonts/arial.ttf", 16), [create](Ref*) {
+            Director::getInstance()->replaceScene(BenchmarkLayer::scene(create()));
+        });
+        menu->addChild(item);
+    }
+    menu->alignItemsVertically();
+    menu->setPosition(Vec2(visibleSize / 2) + origin);
+    this->addChild(menu);
+
+    auto backItem = MenuItemLabel::create(Label::createWithTTF("Back", "fonts/arial.ttf", 20), [](Ref*) {
+        Director::getInstance()->replaceScene(HelloWorld::scene());
+    });
+    backItem->setPosition(origin.x + visibleSize.width - 40, origin.y + 20);
+
+    auto backMenu = Menu::create(backItem, nullptr);
+    backMenu->setPosition(Vec2::ZERO);
+    this->addChild(backMenu, 1);
+
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef __BENCHMARK_SCENE_H__
+#define __BENCHMARK_SCENE_H__
+
+#include "cocos2d.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Base of the benchmark scenes: runs its measurements once the scene is on screen and lists the results,
+// which are logged too, so they can be read from logcat or the console of the desktop builds.
+class BenchmarkLayer : public cocos2d::Layer
+{
+public:
+    static cocos2d::Scene* scene(BenchmarkLayer* layer);
+
+    virtual bool init() override;
+    virtual void onEnter() override;
+
+    virtual std::string title() const = 0;
+    virtual void runBenchmark() = 0;
+
+protected:
+    BenchmarkLayer();
+
+    void addResult(const char* format, ...) CC_FORMAT_PRINTF(2, 3);
+
+    // current time in milliseconds
+    static double now();
+
+    // peak resident memory in KB since the last resetPeakMemory(), or -1 where the platform doesn't report it
+    static long getPeakMemory();
+    static void resetPeakMemory();
+
+    // current anonymous resident memory in KB, the heap without the mapped files, or -1 where it isn't reported
+    static long getAnonymousMemory();
+
+    // number of operator new calls since the start, or -1 where they aren't counted
+    static long getAllocationCount();
+
+    void menuBackCallback(cocos2d::Ref* sender);
+
+    cocos2d::Label* _resultsLabel;
+    std::string _results;
+};
+
+// Lists the benchmarks, reached from the menu of HelloWorld
+class BenchmarkList : public cocos2d::Layer
+{
+public:
+    struct Entry
+    {
+        const char* name;
+        std::function<BenchmarkLayer*()> create;
+    };
+
+    static const std::vector<Entry>& getBenchmarks();
+
+    static cocos2d::Scene* scene();
+
+    virtual bool init() override;
+
+    CREATE_FUNC(BenchmarkList);
+};
+
+#endif // __BENCHMARK_SCENE_H__
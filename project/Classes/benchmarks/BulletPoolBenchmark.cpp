@@ -0,0 +1,67 @@
+#include "BulletPoolBenchmark.h"
+
+USING_NS_CC;
+
+static const int WAVE_COUNT = 200;
+static const int BULLETS_PER_WAVE = 500;
+
+std::string BulletPoolBenchmark::title() const
+{
+    return "Bullet pool";
+}
+
+void BulletPoolBenchmark::runBenchmark()
+{
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ALLOCATOR_OBJECT_POOLS
+    addResult("object pools: on");
+#else
+    addResult("object pools: off");
+#endif
+
+    auto texture = Director::getInstance()->getTextureCache()->addImage("CloseNormal.png");
+    auto layer = Node::create();
+    this->addChild(layer);
+
+    resetPeakMemory();
+    long startMemory = getPeakMemory();
+    long allocations = getAllocationCount();
+    double spawnTime = 0;
+    double removeTime = 0;
+
+    for (int wave = 0; wave < WAVE_COUNT; ++wave)
+    {
+        double start = now();
+        for (int i = 0; i < BULLETS_PER_WAVE; ++i)
+        {
+            auto bullet = Sprite::createWithTexture(texture);
+            bullet->setPosition(i % 480, wave % 320);
+            auto move = MoveBy::create(1, Vec2(0, 320));
+            auto remove = CallFunc::create([bullet]() {
+                bullet->removeFromParent();
+            });
+            bullet->runAction(Sequence::create(move, remove, nullptr));
+            layer->addChild(bullet);
+        }
+        double removeStart = now();
+        spawnTime += removeStart - start;
+
+        // the bullets are released by the autorelease pool at the end of each frame
+        layer->removeAllChildren();
+        PoolManager::getInstance()->getCurrentPool()->clear();
+        removeTime += now() - removeStart;
+    }
+
+    int bulletCount = WAVE_COUNT * BULLETS_PER_WAVE;
+    addResult("%d bullets spawned in %.1f ms, removed in %.1f ms", bulletCount, spawnTime, removeTime);
+    addResult("per bullet: %.2f us", (spawnTime + removeTime) * 1000 / bulletCount);
+
+    allocations = getAllocationCount() - allocations;
+    if (allocations >= 0)
+        addResult("operator new per bullet: %.2f", (double)allocations / bulletCount);
+
+    long peakMemory = getPeakMemory();
+    if (peakMemory >= 0 && startMemory >= 0)
+        addResult("peak memory growth: %ld KB", peakMemory - startMemory);
+
+    layer->removeFromParent();
+}
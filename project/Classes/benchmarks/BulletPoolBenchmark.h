@@ -0,0 +1,18 @@
+#ifndef __BULLET_POOL_BENCHMARK_H__
+#define __BULLET_POOL_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Spawns and removes waves of bullets, sprites running a move and a callback, to measure the cost of creating
+// the pooled classes. The pools are compiled in with CC_ENABLE_ALLOCATOR and CC_ENABLE_ALLOCATOR_OBJECT_POOLS,
+// so the results of both builds are compared.
+class BulletPoolBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(BulletPoolBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __BULLET_POOL_BENCHMARK_H__
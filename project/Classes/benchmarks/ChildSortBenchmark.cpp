@@ -0,0 +1,115 @@
+#include "ChildSortBenchmark.h"
+
+#include <algorithm>
+
+USING_NS_CC;
+
+static const int CHILD_COUNT = 5000;
+static const int FRAME_COUNT = 100;
+
+namespace {
+
+bool nodeComparisonLessY(Node* n1, Node* n2)
+{
+    if (n1->getLocalZOrder() != n2->getLocalZOrder())
+        return n1->getLocalZOrder() < n2->getLocalZOrder();
+    if (n1->getPositionY() != n2->getPositionY())
+        return n1->getPositionY() > n2->getPositionY();
+    return n1->getOrderOfArrival() < n2->getOrderOfArrival();
+}
+
+// same sequence on every run
+unsigned int s_seed = 1;
+int nextRandom()
+{
+    s_seed = s_seed * 1103515245 + 12345;
+    return (s_seed >> 16) & 0x7fff;
+}
+
+}
+
+std::string ChildSortBenchmark::title() const
+{
+    return "Child sort";
+}
+
+void ChildSortBenchmark::runBenchmark()
+{
+    s_seed = 1;
+
+    auto parent = Node::create();
+    for (int i = 0; i < CHILD_COUNT; ++i)
+    {
+        auto child = Node::create();
+        child->setPosition(nextRandom() % 480, nextRandom() % 3200);
+        parent->addChild(child, nextRandom() % 10);
+    }
+    this->addChild(parent);
+    parent->sortAllChildren();
+
+    const auto& children = parent->getChildren();
+    std::vector<Node*> expected;
+
+    // reorders then sorts, the same children are sorted with std::sort to check the result
+    auto measure = [&](const char* label, bool ySort, const std::function<void()>& change) {
+        double sortTime = 0;
+        double fullSortTime = 0;
+        int mismatches = 0;
+        for (int frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            change();
+            expected.assign(children.begin(), children.end());
+
+            double start = now();
+            parent->sortAllChildren();
+            double end = now();
+            sortTime += end - start;
+
+            if (ySort)
+                std::sort(expected.begin(), expected.end(), nodeComparisonLessY);
+            else
+                std::sort(expected.begin(), expected.end(), nodeComparisonLess);
+            fullSortTime += now() - end;
+
+            if (!std::equal(expected.begin(), expected.end(), children.begin()))
+                ++mismatches;
+        }
+        addResult("%s: %.3f ms, std::sort %.3f ms, %d mismatches", label,
+                  sortTime / FRAME_COUNT, fullSortTime / FRAME_COUNT, mismatches);
+    };
+
+    int reorderCounts[] = { 1, 10, 100 };
+    for (int i = 0; i < 3; ++i)
+    {
+        int count = reorderCounts[i];
+        measure(StringUtils::format("z order, %d reordered", count).c_str(), false, [&children, count]() {
+            for (int j = 0; j < count; ++j)
+            {
+                children.at(nextRandom() % CHILD_COUNT)->setLocalZOrder(nextRandom() % 10);
+            }
+        });
+    }
+
+    parent->setYSortEnabled(true);
+    parent->sortAllChildren();
+
+    measure("y-sort, none moved", true, []() {});
+
+    measure("y-sort, 50 moved", true, [&children]() {
+        for (int j = 0; j < 50; ++j)
+        {
+            auto child = children.at(nextRandom() % CHILD_COUNT);
+            child->setPositionY(child->getPositionY() + nextRandom() % 11 - 5);
+        }
+    });
+
+    measure("y-sort, all moved", true, [&children]() {
+        //for (auto child : children)
+        for (auto iter = children.begin(); iter != children.end(); ++iter)
+        {
+            (*iter)->setPositionY((*iter)->getPositionY() + nextRandom() % 11 - 5);
+        }
+    });
+
+    parent->removeFromParent();
+}
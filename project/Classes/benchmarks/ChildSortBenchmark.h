@@ -0,0 +1,17 @@
+#ifndef __CHILD_SORT_BENCHMARK_H__
+#define __CHILD_SORT_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Sorts 5000 children after reordering a few of them, by local z order and in the y-sort mode,
+// against a full std::sort of the same children, which also checks the order
+class ChildSortBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(ChildSortBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __CHILD_SORT_BENCHMARK_H__
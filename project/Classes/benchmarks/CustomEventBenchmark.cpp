@@ -0,0 +1,76 @@
+#include "CustomEventBenchmark.h"
+
+USING_NS_CC;
+
+static const int EVENT_NAME_COUNT = 50;
+static const int DISPATCH_COUNT = 100000;
+
+std::string CustomEventBenchmark::title() const
+{
+    return "Custom event dispatch";
+}
+
+void CustomEventBenchmark::runBenchmark()
+{
+    // names longer than the small string buffers of the standard libraries, as game event names usually are
+    std::vector<std::string> names;
+    std::vector<EventListenerCustom*> listeners;
+    int called = 0;
+    for (int i = 0; i < EVENT_NAME_COUNT; ++i)
+    {
+        names.push_back(StringUtils::format("benchmark_custom_event_%02d", i));
+        listeners.push_back(_eventDispatcher->addCustomEventListener(names.back(), [&called](EventCustom*) {
+            ++called;
+        }));
+    }
+
+    const std::string& name = names[EVENT_NAME_COUNT / 2];
+    const EventCustomID* eventID = EventCustomID::get(name);
+
+    // the first dispatches sort the listeners and fill the caches
+    _eventDispatcher->dispatchCustomEvent(name);
+    _eventDispatcher->dispatchCustomEvent(eventID);
+
+    auto measure = [this, &called](const char* label, const std::function<void()>& dispatch) {
+        called = 0;
+        long allocations = getAllocationCount();
+        double start = now();
+        for (int i = 0; i < DISPATCH_COUNT; ++i)
+        {
+            dispatch();
+        }
+        double elapsed = now() - start;
+        allocations = getAllocationCount() - allocations;
+
+        if (allocations >= 0)
+            addResult("%s: %.0f ns, %.2f allocations", label, elapsed * 1000000 / DISPATCH_COUNT, (double)allocations / DISPATCH_COUNT);
+        else
+            addResult("%s: %.0f ns", label, elapsed * 1000000 / DISPATCH_COUNT);
+
+        CCASSERT(called == DISPATCH_COUNT, "every dispatch should reach the listener");
+    };
+
+    measure("dispatchCustomEvent(name)", [this, &name]() {
+        _eventDispatcher->dispatchCustomEvent(name);
+    });
+
+    EventCustom namedEvent(name);
+    measure("reused EventCustom(name)", [this, &namedEvent]() {
+        _eventDispatcher->dispatchEvent(&namedEvent);
+    });
+
+    measure("dispatchCustomEvent(eventID)", [this, eventID]() {
+        _eventDispatcher->dispatchCustomEvent(eventID);
+    });
+
+    EventCustom internedEvent(eventID);
+    measure("reused EventCustom(eventID)", [this, &internedEvent]() {
+        _eventDispatcher->dispatchEvent(&internedEvent);
+    });
+
+    //for (auto listener : listeners)
+    for (auto iter = listeners.begin(); iter != listeners.end(); ++iter)
+    {
+        _eventDispatcher->removeEventListener(*iter);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef __CUSTOM_EVENT_BENCHMARK_H__
+#define __CUSTOM_EVENT_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Dispatches custom events by name and by interned ID, counting the time and the allocations of each dispatch
+class CustomEventBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(CustomEventBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __CUSTOM_EVENT_BENCHMARK_H__
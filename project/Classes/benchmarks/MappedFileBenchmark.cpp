@@ -0,0 +1,126 @@
+#include "MappedFileBenchmark.h"
+
+USING_NS_CC;
+
+static const int FILE_SIZE = 32 * 1024 * 1024;
+static const int IMAGE_SIZE = 2048;
+static const int LOAD_COUNT = 5;
+
+std::string MappedFileBenchmark::title() const
+{
+    return "Mapped files";
+}
+
+// reads every page, as a parser would
+static unsigned int checksum(const unsigned char* bytes, ssize_t size)
+{
+    unsigned int sum = 0;
+    for (ssize_t i = 0; i < size; i += 64)
+    {
+        sum += bytes[i];
+    }
+    return sum;
+}
+
+void MappedFileBenchmark::runBenchmark()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string filePath = fileUtils->getWritablePath() + "benchmark_mapped.bin";
+    std::string imagePath = fileUtils->getWritablePath() + "benchmark_mapped.png";
+
+    // noise, so the PNG isn't compressed much
+    unsigned int seed = 1;
+    if (fileUtils->getFileSize(filePath) != FILE_SIZE)
+    {
+        std::vector<unsigned int> words(FILE_SIZE / sizeof(unsigned int));
+        for (size_t i = 0; i < words.size(); ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            words[i] = seed;
+        }
+        FILE* fp = fopen(filePath.c_str(), "wb");
+        if (fp == nullptr)
+        {
+            addResult("can't write %s", filePath.c_str());
+            return;
+        }
+        fwrite(words.data(), 1, FILE_SIZE, fp);
+        fclose(fp);
+    }
+    if (!fileUtils->isFileExist(imagePath))
+    {
+        Data pixels = fileUtils->getDataFromFile(filePath);
+        auto image = new (std::nothrow) Image();
+        image->initWithRawData(pixels.getBytes(), IMAGE_SIZE * IMAGE_SIZE * 4, IMAGE_SIZE, IMAGE_SIZE, 8);
+        image->saveToFile(imagePath, false);
+        image->release();
+    }
+
+    // the files are in the page cache after the first load, the loads measure the copy and the mapping
+    auto measure = [this](const char* label, const std::function<void()>& load) {
+        load();
+
+        double start = now();
+        for (int i = 0; i < LOAD_COUNT; ++i)
+        {
+            load();
+        }
+        double elapsed = (now() - start) / LOAD_COUNT;
+
+        resetPeakMemory();
+        long startPeak = getPeakMemory();
+        load();
+        long peak = getPeakMemory();
+
+        if (peak >= 0 && startPeak >= 0)
+            addResult("%s: %.1f ms, peak resident +%ld KB", label, elapsed, peak - startPeak);
+        else
+            addResult("%s: %.1f ms", label, elapsed);
+    };
+
+    long heldMemory = -1;
+    auto measureHeld = [&heldMemory](long start) {
+        long current = getAnonymousMemory();
+        heldMemory = (current >= 0 && start >= 0) ? current - start : -1;
+    };
+
+    unsigned int readSum = 0;
+    unsigned int mappedSum = 0;
+
+    measure("getDataFromFile + read", [&]() {
+        long start = getAnonymousMemory();
+        Data data = fileUtils->getDataFromFile(filePath);
+        readSum = checksum(data.getBytes(), data.getSize());
+        measureHeld(start);
+    });
+    addResult("  heap held while loaded: %ld KB", heldMemory);
+
+    bool mapped = false;
+    measure("getMappedDataFromFile + read", [&]() {
+        long start = getAnonymousMemory();
+        MappedData* data = fileUtils->getMappedDataFromFile(filePath);
+        mappedSum = checksum(data->getBytes(), data->getSize());
+        mapped = data->isMapped();
+        measureHeld(start);
+        data->release();
+    });
+    addResult("  heap held while loaded: %ld KB, %s", heldMemory, mapped ? "mapped" : "read, not mapped");
+
+    if (readSum != mappedSum)
+        addResult("checksums differ!");
+
+    addResult("%dx%d PNG, %ld KB:", IMAGE_SIZE, IMAGE_SIZE, fileUtils->getFileSize(imagePath) / 1024);
+
+    measure("  decoded from a read copy", [&]() {
+        Data data = fileUtils->getDataFromFile(imagePath);
+        auto image = new (std::nothrow) Image();
+        image->initWithImageData(data.getBytes(), data.getSize());
+        image->release();
+    });
+
+    measure("  decoded from the mapping", [&]() {
+        auto image = new (std::nothrow) Image();
+        image->initWithImageFile(imagePath);
+        image->release();
+    });
+}
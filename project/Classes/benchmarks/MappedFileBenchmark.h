@@ -0,0 +1,17 @@
+#ifndef __MAPPED_FILE_BENCHMARK_H__
+#define __MAPPED_FILE_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Loads a large file and a large PNG through a read copy and through FileUtils::getMappedDataFromFile(),
+// comparing the time and the memory they take
+class MappedFileBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(MappedFileBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __MAPPED_FILE_BENCHMARK_H__
@@ -0,0 +1,249 @@
+#include "PlistFormatBenchmark.h"
+
+#include <unordered_map>
+
+USING_NS_CC;
+
+static const int FRAME_COUNT = 4500;
+static const int LOAD_COUNT = 5;
+
+std::string PlistFormatBenchmark::title() const
+{
+    return "Plist formats";
+}
+
+// a sprite sheet in the format 2 of TexturePacker, as read by SpriteFrameCache
+static ValueMap makeSpriteSheet()
+{
+    ValueMap frames;
+    char name[64];
+    char rect[64];
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        ValueMap frame;
+        snprintf(rect, sizeof(rect), "{{%d,%d},{30,31}}", (i % 64) * 32, (i / 64) * 32);
+        frame["frame"] = rect;
+        snprintf(rect, sizeof(rect), "{%d,-1}", i % 3 - 1);
+        frame["offset"] = rect;
+        frame["rotated"] = i % 5 == 0;
+        frame["sourceColorRect"] = "{{1,0},{30,31}}";
+        frame["sourceSize"] = "{32,32}";
+
+        snprintf(name, sizeof(name), "character_%04d.png", i);
+        frames[name] = frame;
+    }
+
+    ValueMap metadata;
+    metadata["format"] = 2;
+    metadata["realTextureFileName"] = "characters.png";
+    metadata["size"] = "{2048,4096}";
+    metadata["textureFileName"] = "characters.png";
+
+    ValueMap sheet;
+    sheet["frames"] = frames;
+    sheet["metadata"] = metadata;
+    return sheet;
+}
+
+// Writes the bplist00 format, as `plutil -convert binary1` does for these values: the strings are stored once,
+// with 4 byte object references and offsets. There is no writer in the engine, which only reads them.
+class BinaryPlistWriter
+{
+public:
+    std::string write(const Value& root)
+    {
+        _data = "bplist00";
+        _offsets.clear();
+        _strings.clear();
+
+        unsigned int top = writeObject(root);
+        unsigned int tableOffset = (unsigned int)_data.size();
+        //for (auto offset : _offsets)
+        for (auto iter = _offsets.cbegin(); iter != _offsets.cend(); ++iter)
+        {
+            appendBigEndian(*iter, 4);
+        }
+
+        // trailer: 6 unused bytes, the offset and reference sizes, then the object count, the top object and the table offset
+        _data.append(6, '\0');
+        _data += (char)4;
+        _data += (char)4;
+        appendBigEndian(0, 4);
+        appendBigEndian((unsigned int)_offsets.size(), 4);
+        appendBigEndian(0, 4);
+        appendBigEndian(top, 4);
+        appendBigEndian(0, 4);
+        appendBigEndian(tableOffset, 4);
+        return _data;
+    }
+
+private:
+    void appendBigEndian(unsigned int value, int size)
+    {
+        for (int shift = (size - 1) * 8; shift >= 0; shift -= 8)
+        {
+            _data += (char)((value >> shift) & 0xFF);
+        }
+    }
+
+    // marker with the count in its low bits, or followed by an integer object from 15 on
+    void appendMarker(unsigned char type, size_t count)
+    {
+        if (count < 15)
+        {
+            _data += (char)(type | count);
+        }
+        else
+        {
+            _data += (char)(type | 0xF);
+            _data += (char)0x12;
+            appendBigEndian((unsigned int)count, 4);
+        }
+    }
+
+    unsigned int addObject()
+    {
+        _offsets.push_back((unsigned int)_data.size());
+        return (unsigned int)_offsets.size() - 1;
+    }
+
+    unsigned int writeString(const std::string& text)
+    {
+        auto iter = _strings.find(text);
+        if (iter != _strings.end())
+            return iter->second;
+
+        unsigned int ref = addObject();
+        appendMarker(0x50, text.length());
+        _data += text;
+        _strings[text] = ref;
+        return ref;
+    }
+
+    unsigned int writeObject(const Value& value)
+    {
+        switch (value.getType())
+        {
+            case Value::Type::MAP:
+            {
+                const ValueMap& dict = value.asValueMap();
+                std::vector<unsigned int> refs;
+                //for (const auto& entry : dict)
+                for (auto iter = dict.cbegin(); iter != dict.cend(); ++iter)
+                {
+                    refs.push_back(writeString(iter->first));
+                }
+                for (auto iter = dict.cbegin(); iter != dict.cend(); ++iter)
+                {
+                    refs.push_back(writeObject(iter->second));
+                }
+                return writeContainer(0xD0, dict.size(), refs);
+            }
+            case Value::Type::VECTOR:
+            {
+                const ValueVector& array = value.asValueVector();
+                std::vector<unsigned int> refs;
+                //for (const auto& item : array)
+                for (auto iter = array.cbegin(); iter != array.cend(); ++iter)
+                {
+                    refs.push_back(writeObject(*iter));
+                }
+                return writeContainer(0xA0, array.size(), refs);
+            }
+            case Value::Type::BOOLEAN:
+            {
+                unsigned int ref = addObject();
+                _data += (char)(value.asBool() ? 0x09 : 0x08);
+                return ref;
+            }
+            case Value::Type::INTEGER:
+            {
+                unsigned int ref = addObject();
+                _data += (char)0x12;
+                appendBigEndian((unsigned int)value.asInt(), 4);
+                return ref;
+            }
+            default:
+                return writeString(value.asString());
+        }
+    }
+
+    unsigned int writeContainer(unsigned char type, size_t count, const std::vector<unsigned int>& refs)
+    {
+        unsigned int ref = addObject();
+        appendMarker(type, count);
+        //for (auto child : refs)
+        for (auto iter = refs.cbegin(); iter != refs.cend(); ++iter)
+        {
+            appendBigEndian(*iter, 4);
+        }
+        return ref;
+    }
+
+    std::string _data;
+    std::vector<unsigned int> _offsets;
+    std::unordered_map<std::string, unsigned int> _strings;
+};
+
+void PlistFormatBenchmark::runBenchmark()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string xmlPath = fileUtils->getWritablePath() + "benchmark_formats.plist";
+    std::string binaryPath = fileUtils->getWritablePath() + "benchmark_formats.bplist";
+    std::string compiledPath = fileUtils->getWritablePath() + "benchmark_formats.ccv";
+
+    ValueMap sheet = makeSpriteSheet();
+
+    std::string binary = BinaryPlistWriter().write(Value(sheet));
+    FILE* fp = fopen(binaryPath.c_str(), "wb");
+    if (fp == nullptr || !fileUtils->writeToFile(sheet, xmlPath) || !fileUtils->writeValueMapToCompiledFile(sheet, compiledPath))
+    {
+        if (fp)
+            fclose(fp);
+        addResult("can't write the files in %s", fileUtils->getWritablePath().c_str());
+        return;
+    }
+    fwrite(binary.data(), 1, binary.size(), fp);
+    fclose(fp);
+
+    addResult("%d frames", FRAME_COUNT);
+
+    Value expected(sheet);
+    auto measure = [&](const char* label, const std::string& path) {
+        // the first load checks the result and brings the file in the page cache
+        if (Value(fileUtils->getValueMapFromFile(path)) != expected)
+        {
+            addResult("%s: wrong result!", label);
+            return;
+        }
+
+        double best = 0;
+        double total = 0;
+        for (int i = 0; i < LOAD_COUNT; ++i)
+        {
+            double start = now();
+            fileUtils->getValueMapFromFile(path);
+            double elapsed = now() - start;
+            total += elapsed;
+            if (i == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        resetPeakMemory();
+        long startPeak = getPeakMemory();
+        long startCount = getAllocationCount();
+        fileUtils->getValueMapFromFile(path);
+        long allocations = getAllocationCount() - startCount;
+        long peak = getPeakMemory();
+
+        addResult("%s, %ld KB: %.1f ms (best %.1f)", label, fileUtils->getFileSize(path) / 1024, total / LOAD_COUNT, best);
+        if (startCount >= 0)
+            addResult("  %ld allocations", allocations);
+        if (peak >= 0 && startPeak >= 0)
+            addResult("  peak resident +%ld KB", peak - startPeak);
+    };
+
+    measure("XML plist", xmlPath);
+    measure("binary plist", binaryPath);
+    measure("compiled", compiledPath);
+}
@@ -0,0 +1,17 @@
+#ifndef __PLIST_FORMAT_BENCHMARK_H__
+#define __PLIST_FORMAT_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Loads the same sprite sheet saved as an XML plist, a binary plist and a compiled value file,
+// comparing the file sizes and the load times of FileUtils::getValueMapFromFile()
+class PlistFormatBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(PlistFormatBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __PLIST_FORMAT_BENCHMARK_H__
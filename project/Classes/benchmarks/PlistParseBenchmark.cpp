@@ -0,0 +1,127 @@
+#include "PlistParseBenchmark.h"
+
+USING_NS_CC;
+
+static const int FRAME_COUNT = 4500;
+static const int PARSE_COUNT = 5;
+
+std::string PlistParseBenchmark::title() const
+{
+    return "Plist parse";
+}
+
+// a sprite sheet in the format 2 of TexturePacker, as read by SpriteFrameCache
+static std::string makeSpriteSheet()
+{
+    std::string text =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+        "<plist version=\"1.0\">\n"
+        "    <dict>\n"
+        "        <key>frames</key>\n"
+        "        <dict>\n";
+
+    char buf[1024];
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        int x = (i % 64) * 32;
+        int y = (i / 64) * 32;
+        snprintf(buf, sizeof(buf),
+            "            <key>character_%04d.png</key>\n"
+            "            <dict>\n"
+            "                <key>frame</key>\n"
+            "                <string>{{%d,%d},{30,31}}</string>\n"
+            "                <key>offset</key>\n"
+            "                <string>{%d,-1}</string>\n"
+            "                <key>rotated</key>\n"
+            "                <%s/>\n"
+            "                <key>sourceColorRect</key>\n"
+            "                <string>{{1,0},{30,31}}</string>\n"
+            "                <key>sourceSize</key>\n"
+            "                <string>{32,32}</string>\n"
+            "            </dict>\n",
+            i, x, y, i % 3 - 1, i % 5 == 0 ? "true" : "false");
+        text += buf;
+    }
+
+    text +=
+        "        </dict>\n"
+        "        <key>metadata</key>\n"
+        "        <dict>\n"
+        "            <key>format</key>\n"
+        "            <integer>2</integer>\n"
+        "            <key>realTextureFileName</key>\n"
+        "            <string>characters.png</string>\n"
+        "            <key>size</key>\n"
+        "            <string>{2048,4096}</string>\n"
+        "            <key>textureFileName</key>\n"
+        "            <string>characters.png</string>\n"
+        "        </dict>\n"
+        "    </dict>\n"
+        "</plist>\n";
+    return text;
+}
+
+void PlistParseBenchmark::runBenchmark()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string path = fileUtils->getWritablePath() + "benchmark_sheet.plist";
+
+    std::string text = makeSpriteSheet();
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr)
+    {
+        addResult("can't write %s", path.c_str());
+        return;
+    }
+    fwrite(text.data(), 1, text.size(), fp);
+    fclose(fp);
+
+    double megabytes = text.size() / (1024.0 * 1024.0);
+    addResult("%d frames, %.2f MB", FRAME_COUNT, megabytes);
+
+    auto measure = [&](const char* label, const std::function<ValueMap()>& parse) {
+        // the first parse checks the result and brings the file in the page cache
+        ValueMap dict = parse();
+        auto frames = dict.find("frames");
+        if (frames == dict.end() || frames->second.getType() != Value::Type::MAP || (int)frames->second.asValueMap().size() != FRAME_COUNT)
+        {
+            addResult("%s: wrong result!", label);
+            return;
+        }
+        dict.clear();
+
+        double best = 0;
+        double total = 0;
+        for (int i = 0; i < PARSE_COUNT; ++i)
+        {
+            double start = now();
+            parse();
+            double elapsed = now() - start;
+            total += elapsed;
+            if (i == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        resetPeakMemory();
+        long startPeak = getPeakMemory();
+        long startCount = getAllocationCount();
+        parse();
+        long allocations = getAllocationCount() - startCount;
+        long peak = getPeakMemory();
+
+        addResult("%s: %.1f ms (best %.1f), %.0f MB/s", label, total / PARSE_COUNT, best, megabytes * 1000 / best);
+        if (startCount >= 0)
+            addResult("  %ld allocations, %.1f per frame", allocations, (double)allocations / FRAME_COUNT);
+        if (peak >= 0 && startPeak >= 0)
+            addResult("  peak resident +%ld KB", peak - startPeak);
+    };
+
+    measure("getValueMapFromFile", [&]() {
+        return fileUtils->getValueMapFromFile(path);
+    });
+
+    measure("getValueMapFromData", [&]() {
+        return fileUtils->getValueMapFromData(text.data(), (int)text.size());
+    });
+}
@@ -0,0 +1,17 @@
+#ifndef __PLIST_PARSE_BENCHMARK_H__
+#define __PLIST_PARSE_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Parses a 2 MB sprite sheet plist with FileUtils::getValueMapFromFile() and getValueMapFromData(),
+// reporting the time, the allocations and the peak memory of a parse
+class PlistParseBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(PlistParseBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __PLIST_PARSE_BENCHMARK_H__
@@ -0,0 +1,147 @@
+#include "PvrCczBenchmark.h"
+
+#include <zlib.h>
+
+USING_NS_CC;
+
+static const int IMAGE_SIZE = 2048;
+static const int LOAD_COUNT = 5;
+
+std::string PvrCczBenchmark::title() const
+{
+    return "pvr.ccz load";
+}
+
+static void appendLittleEndian(std::string& out, uint64_t value, int size)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        out += (char)((value >> (i * 8)) & 0xFF);
+    }
+}
+
+static void appendBigEndian(std::string& out, uint32_t value, int size)
+{
+    for (int shift = (size - 1) * 8; shift >= 0; shift -= 8)
+    {
+        out += (char)((value >> shift) & 0xFF);
+    }
+}
+
+// A PVRv3 RGBA8888 texture without mipmaps, zlib compressed in a CCZ file as TexturePacker writes them.
+// The pixels are sprite like, flat areas with some noise, so the compression ratio is close to a real sheet.
+static std::string makePvrCcz()
+{
+    std::string pvr = "PVR\x03";
+    appendLittleEndian(pvr, 0, 4);                          // flags
+    appendLittleEndian(pvr, 0x0808080861626772ULL, 8);      // pixel format: r8g8b8a8
+    appendLittleEndian(pvr, 0, 4);                          // color space
+    appendLittleEndian(pvr, 0, 4);                          // channel type
+    appendLittleEndian(pvr, IMAGE_SIZE, 4);                 // height
+    appendLittleEndian(pvr, IMAGE_SIZE, 4);                 // width
+    appendLittleEndian(pvr, 1, 4);                          // depth
+    appendLittleEndian(pvr, 1, 4);                          // surfaces
+    appendLittleEndian(pvr, 1, 4);                          // faces
+    appendLittleEndian(pvr, 1, 4);                          // mipmaps
+    appendLittleEndian(pvr, 0, 4);                          // metadata length
+
+    size_t headerSize = pvr.size();
+    pvr.resize(headerSize + IMAGE_SIZE * IMAGE_SIZE * 4);
+    unsigned char* pixels = (unsigned char*)&pvr[headerSize];
+    unsigned int seed = 1;
+    for (int y = 0; y < IMAGE_SIZE; ++y)
+    {
+        for (int x = 0; x < IMAGE_SIZE; ++x)
+        {
+            unsigned char* pixel = pixels + (y * IMAGE_SIZE + x) * 4;
+            seed = seed * 1103515245 + 12345;
+            bool inSprite = ((x / 64) + (y / 64)) % 3 != 0;
+            unsigned char noise = (seed >> 16) & 0x0F;
+            pixel[0] = inSprite ? (unsigned char)(x / 8 + noise) : 0;
+            pixel[1] = inSprite ? (unsigned char)(y / 8 + noise) : 0;
+            pixel[2] = inSprite ? (unsigned char)(128 + noise) : 0;
+            pixel[3] = inSprite ? 255 : 0;
+        }
+    }
+
+    uLongf compressedSize = compressBound((uLong)pvr.size());
+    std::string ccz = "CCZ!";
+    appendBigEndian(ccz, 0, 2);                             // compression: zlib
+    appendBigEndian(ccz, 2, 2);                             // version
+    appendBigEndian(ccz, 0, 4);                             // reserved
+    appendBigEndian(ccz, (uint32_t)pvr.size(), 4);          // inflated length
+    size_t cczHeaderSize = ccz.size();
+    ccz.resize(cczHeaderSize + compressedSize);
+    compress((Bytef*)&ccz[cczHeaderSize], &compressedSize, (const Bytef*)pvr.data(), (uLong)pvr.size());
+    ccz.resize(cczHeaderSize + compressedSize);
+    return ccz;
+}
+
+void PvrCczBenchmark::runBenchmark()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string path = fileUtils->getWritablePath() + "benchmark_texture.pvr.ccz";
+
+    std::string ccz = makePvrCcz();
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr)
+    {
+        addResult("can't write %s", path.c_str());
+        return;
+    }
+    fwrite(ccz.data(), 1, ccz.size(), fp);
+    fclose(fp);
+
+    int pixelsSize = IMAGE_SIZE * IMAGE_SIZE * 4 / 1024;
+    addResult("%dx%d RGBA8888, %d KB, %ld KB compressed", IMAGE_SIZE, IMAGE_SIZE, pixelsSize, (long)ccz.size() / 1024);
+    ccz.clear();
+    ccz.shrink_to_fit();
+
+    auto measure = [this](const char* label, const std::function<bool()>& load) {
+        // the first load checks the file and brings it in the page cache
+        if (!load())
+        {
+            addResult("%s: failed!", label);
+            return;
+        }
+
+        double start = now();
+        for (int i = 0; i < LOAD_COUNT; ++i)
+        {
+            load();
+        }
+        double elapsed = (now() - start) / LOAD_COUNT;
+
+        resetPeakMemory();
+        long startPeak = getPeakMemory();
+        long startCount = getAllocationCount();
+        load();
+        long allocations = getAllocationCount() - startCount;
+        long peak = getPeakMemory();
+
+        std::string line = StringUtils::format("%s: %.1f ms", label, elapsed);
+        if (startCount >= 0)
+            line += StringUtils::format(", %ld allocations", allocations);
+        if (peak >= 0 && startPeak >= 0)
+            line += StringUtils::format(", peak resident +%ld KB", peak - startPeak);
+        addResult("%s", line.c_str());
+    };
+
+    measure("Image", [&path]() {
+        auto image = new (std::nothrow) Image();
+        bool loaded = image->initWithImageFile(path) && image->getWidth() == IMAGE_SIZE;
+        image->release();
+        return loaded;
+    });
+
+    // the GL driver keeps its own copy of the pixels, which counts in the peak too
+    measure("Image + Texture2D", [&path]() {
+        auto image = new (std::nothrow) Image();
+        bool loaded = image->initWithImageFile(path);
+        auto texture = new (std::nothrow) Texture2D();
+        loaded = loaded && texture->initWithImage(image);
+        texture->release();
+        image->release();
+        return loaded;
+    });
+}
@@ -0,0 +1,16 @@
+#ifndef __PVR_CCZ_BENCHMARK_H__
+#define __PVR_CCZ_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Loads a 2048x2048 RGBA8888 pvr.ccz into an Image and a Texture2D, reporting the time and the peak memory
+class PvrCczBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(PvrCczBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __PVR_CCZ_BENCHMARK_H__
@@ -0,0 +1,83 @@
+#include "TouchDispatchBenchmark.h"
+
+USING_NS_CC;
+
+static const int PANEL_COUNT = 100;
+static const int WIDGETS_PER_PANEL = 100;
+static const int DISPATCH_COUNT = 100;
+
+std::string TouchDispatchBenchmark::title() const
+{
+    return "Touch dispatch";
+}
+
+void TouchDispatchBenchmark::runBenchmark()
+{
+    // the listeners don't claim the touches, so each of them sees every touch
+    int called = 0;
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->onTouchBegan = [&called](Touch*, Event*) {
+        ++called;
+        return false;
+    };
+
+    auto root = Node::create();
+    std::vector<Node*> panels;
+    std::vector<Node*> widgets;
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        auto panel = Node::create();
+        root->addChild(panel, i);
+        panels.push_back(panel);
+
+        for (int j = 0; j < WIDGETS_PER_PANEL; ++j)
+        {
+            auto widget = Node::create();
+            panel->addChild(widget, j);
+            _eventDispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), widget);
+            widgets.push_back(widget);
+        }
+    }
+    this->addChild(root);
+
+    auto touch = new (std::nothrow) Touch();
+    touch->setTouchInfo(0, 100, 100);
+    std::vector<Touch*> touches(1, touch);
+    EventTouch event;
+    event.setEventCode(EventTouch::EventCode::BEGAN);
+    event.setTouches(touches);
+
+    // the first dispatch sorts all the listeners
+    double start = now();
+    _eventDispatcher->dispatchEvent(&event);
+    addResult("%d listeners, first dispatch: %.2f ms", (int)widgets.size(), now() - start);
+
+    called = 0;
+    start = now();
+    for (int i = 0; i < DISPATCH_COUNT; ++i)
+    {
+        _eventDispatcher->dispatchEvent(&event);
+    }
+    addResult("dispatch: %.3f ms", (now() - start) / DISPATCH_COUNT);
+
+    start = now();
+    for (int i = 0; i < DISPATCH_COUNT; ++i)
+    {
+        widgets[(i * 7919) % widgets.size()]->setLocalZOrder(WIDGETS_PER_PANEL + i);
+        _eventDispatcher->dispatchEvent(&event);
+    }
+    addResult("reorder a widget + dispatch: %.3f ms", (now() - start) / DISPATCH_COUNT);
+
+    start = now();
+    for (int i = 0; i < DISPATCH_COUNT; ++i)
+    {
+        panels[(i * 31) % panels.size()]->setLocalZOrder(PANEL_COUNT + i);
+        _eventDispatcher->dispatchEvent(&event);
+    }
+    addResult("reorder a panel + dispatch: %.3f ms", (now() - start) / DISPATCH_COUNT);
+
+    addResult("listeners called per touch: %d", called / (DISPATCH_COUNT * 3));
+
+    touch->release();
+    root->removeFromParent();
+}
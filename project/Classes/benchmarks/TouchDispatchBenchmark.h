@@ -0,0 +1,16 @@
+#ifndef __TOUCH_DISPATCH_BENCHMARK_H__
+#define __TOUCH_DISPATCH_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Dispatches touches to 10000 scene graph listeners, with and without reordering a node between the touches
+class TouchDispatchBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(TouchDispatchBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __TOUCH_DISPATCH_BENCHMARK_H__
@@ -0,0 +1,134 @@
+#include "TransformHierarchyBenchmark.h"
+#include "2d/CCTransformHierarchy.h"
+
+#include <math.h>
+
+USING_NS_CC;
+
+static const int FRAME_COUNT = 100;
+
+namespace {
+
+// exposes the transform computed by the last visit, and whether the hierarchy computed it
+class TransformNode : public Node
+{
+public:
+    CREATE_FUNC(TransformNode);
+
+    const Mat4& getModelViewTransform() const { return _modelViewTransform; }
+
+    bool isBatched() const
+    {
+        return _transformHierarchy && _transformIndex > 0 && _transformHierarchy->isUpToDate(_transformIndex);
+    }
+};
+
+}
+
+std::string TransformHierarchyBenchmark::title() const
+{
+    return "Transform hierarchy";
+}
+
+void TransformHierarchyBenchmark::runBenchmark()
+{
+    // 50 chains of 40 nodes
+    auto deepRoot = Node::create();
+    std::vector<Node*> deepNodes;
+    for (int i = 0; i < 50; ++i)
+    {
+        Node* parent = deepRoot;
+        for (int j = 0; j < 40; ++j)
+        {
+            auto node = TransformNode::create();
+            node->setPosition(1, 1);
+            parent->addChild(node);
+            deepNodes.push_back(node);
+            parent = node;
+        }
+    }
+    measure("deep", deepRoot, deepNodes);
+
+    // 20 groups of 100 nodes
+    auto wideRoot = Node::create();
+    std::vector<Node*> wideNodes;
+    for (int i = 0; i < 20; ++i)
+    {
+        auto group = TransformNode::create();
+        group->setPosition(i * 20, 0);
+        wideRoot->addChild(group);
+        wideNodes.push_back(group);
+        for (int j = 0; j < 100; ++j)
+        {
+            auto node = TransformNode::create();
+            node->setPosition(j, j);
+            group->addChild(node);
+            wideNodes.push_back(node);
+        }
+    }
+    measure("wide", wideRoot, wideNodes);
+}
+
+void TransformHierarchyBenchmark::measure(const char* shape, Node* root, const std::vector<Node*>& nodes)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    this->addChild(root);
+
+    std::vector<Mat4> perNodeTransforms;
+    double perNodeTimes[3] = { 0, 0, 0 };
+    for (int batched = 0; batched <= 1; ++batched)
+    {
+        root->setTransformHierarchyEnabled(batched != 0);
+
+        // the same absolute changes in both modes, so the last frame has the same transforms:
+        // every node moved, one node in ten moved, nothing moved
+        double times[3] = { 0, 0, 0 };
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            double start = now();
+            for (int frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                int step = (pass == 0) ? 1 : 10;
+                for (size_t i = (frame % step); pass < 2 && i < nodes.size(); i += step)
+                {
+                    nodes[i]->setRotation(fmodf(frame + i, 360));
+                }
+                root->visit(renderer, Mat4::IDENTITY, 0);
+            }
+            times[pass] = (now() - start) / FRAME_COUNT;
+        }
+
+        if (!batched)
+        {
+            //for (auto node : nodes)
+            for (auto iter = nodes.begin(); iter != nodes.end(); ++iter)
+            {
+                perNodeTransforms.push_back(static_cast<TransformNode*>(*iter)->getModelViewTransform());
+            }
+            memcpy(perNodeTimes, times, sizeof(times));
+            continue;
+        }
+
+        int batchedCount = 0;
+        float maxError = 0;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            auto node = static_cast<TransformNode*>(nodes[i]);
+            if (node->isBatched())
+                ++batchedCount;
+
+            const Mat4& transform = node->getModelViewTransform();
+            for (int j = 0; j < 16; ++j)
+            {
+                maxError = std::max(maxError, fabsf(transform.m[j] - perNodeTransforms[i].m[j]));
+            }
+        }
+
+        addResult("%s, %d nodes, %d updated by the hierarchy, max difference %g", shape, (int)nodes.size(), batchedCount, maxError);
+        addResult("  all moved: %.3f ms per node, %.3f ms batched", perNodeTimes[0], times[0]);
+        addResult("  1/10 moved: %.3f ms per node, %.3f ms batched", perNodeTimes[1], times[1]);
+        addResult("  none moved: %.3f ms per node, %.3f ms batched", perNodeTimes[2], times[2]);
+    }
+
+    root->removeFromParent();
+}
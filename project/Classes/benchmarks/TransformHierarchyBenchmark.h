@@ -0,0 +1,20 @@
+#ifndef __TRANSFORM_HIERARCHY_BENCHMARK_H__
+#define __TRANSFORM_HIERARCHY_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Visits a deep and a wide hierarchy of nodes with the per node transform update and with the batched one
+// of Node::setTransformHierarchyEnabled(), checking that both give the same transforms
+class TransformHierarchyBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(TransformHierarchyBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+
+protected:
+    void measure(const char* shape, cocos2d::Node* root, const std::vector<cocos2d::Node*>& nodes);
+};
+
+#endif // __TRANSFORM_HIERARCHY_BENCHMARK_H__
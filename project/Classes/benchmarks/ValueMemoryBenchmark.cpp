@@ -0,0 +1,87 @@
+#include "ValueMemoryBenchmark.h"
+
+USING_NS_CC;
+
+static const int VALUE_COUNT = 200000;
+static const int FRAME_COUNT = 4500;
+
+std::string ValueMemoryBenchmark::title() const
+{
+    return "Value memory";
+}
+
+// a sprite sheet in the format 2 of TexturePacker: mostly strings shorter than 16 chars
+static std::string makeSpriteSheet()
+{
+    std::string text = "<plist version=\"1.0\"><dict><key>frames</key><dict>";
+    char buf[512];
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        snprintf(buf, sizeof(buf),
+            "<key>character_%04d.png</key><dict>"
+            "<key>frame</key><string>{{%d,%d},{30,31}}</string>"
+            "<key>offset</key><string>{%d,-1}</string>"
+            "<key>rotated</key><%s/>"
+            "<key>sourceColorRect</key><string>{{1,0},{30,31}}</string>"
+            "<key>sourceSize</key><string>{32,32}</string>"
+            "</dict>",
+            i, (i % 64) * 32, (i / 64) * 32, i % 3 - 1, i % 5 == 0 ? "true" : "false");
+        text += buf;
+    }
+    text += "</dict></dict></plist>";
+    return text;
+}
+
+void ValueMemoryBenchmark::runBenchmark()
+{
+    addResult("sizeof(Value): %d bytes", (int)sizeof(Value));
+
+    // reports the time and the allocations of step, and the heap held by what it built
+    auto measure = [this](const char* label, const std::function<void()>& step) {
+        // trims the heap too, so the measures start from the same point
+        resetPeakMemory();
+        long startMemory = getAnonymousMemory();
+        long startCount = getAllocationCount();
+        double start = now();
+        step();
+        double elapsed = now() - start;
+        long allocations = getAllocationCount() - startCount;
+        long memory = getAnonymousMemory();
+
+        std::string line = StringUtils::format("%s: %.1f ms", label, elapsed);
+        if (startCount >= 0)
+            line += StringUtils::format(", %ld allocations", allocations);
+        if (memory >= 0 && startMemory >= 0)
+            line += StringUtils::format(", heap +%ld KB", memory - startMemory);
+        addResult("%s", line.c_str());
+    };
+
+    const char* strings[] = { "{{1,0},{30,31}}", "a string longer than fifteen chars" };
+    //for (auto text : strings)
+    for (size_t s = 0; s < sizeof(strings) / sizeof(strings[0]); ++s)
+    {
+        const char* text = strings[s];
+        addResult("%d strings of %d chars:", VALUE_COUNT, (int)strlen(text));
+
+        ValueVector values;
+        values.reserve(VALUE_COUNT);
+        measure("  built", [&]() {
+            for (int i = 0; i < VALUE_COUNT; ++i)
+            {
+                values.push_back(Value(text));
+            }
+        });
+
+        ValueVector copy;
+        measure("  copied", [&]() {
+            copy = values;
+        });
+    }
+
+    std::string plist = makeSpriteSheet();
+    addResult("sprite sheet of %d frames, %d KB:", FRAME_COUNT, (int)plist.size() / 1024);
+    ValueMap sheet;
+    measure("  parsed", [&]() {
+        sheet = FileUtils::getInstance()->getValueMapFromData(plist.data(), (int)plist.size());
+    });
+}
@@ -0,0 +1,17 @@
+#ifndef __VALUE_MEMORY_BENCHMARK_H__
+#define __VALUE_MEMORY_BENCHMARK_H__
+
+#include "BenchmarkScene.h"
+
+// Builds and copies vectors of string Values, short ones and long ones, and parses a sprite sheet plist,
+// reporting the time, the allocations and the heap the values hold
+class ValueMemoryBenchmark : public BenchmarkLayer
+{
+public:
+    CREATE_FUNC(ValueMemoryBenchmark);
+
+    virtual std::string title() const override;
+    virtual void runBenchmark() override;
+};
+
+#endif // __VALUE_MEMORY_BENCHMARK_H__
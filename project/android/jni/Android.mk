@@ -8,7 +8,19 @@ LOCAL_MODULE_FILENAME := libcpp_empty_test
 
 LOCAL_SRC_FILES := main.cpp \
                    ../../Classes/AppDelegate.cpp \
-                   ../../Classes/HelloWorldScene.cpp
+                   ../../Classes/HelloWorldScene.cpp \
+                   ../../Classes/benchmarks/BenchmarkScene.cpp \
+                   ../../Classes/benchmarks/TouchDispatchBenchmark.cpp \
+                   ../../Classes/benchmarks/CustomEventBenchmark.cpp \
+                   ../../Classes/benchmarks/BulletPoolBenchmark.cpp \
+                   ../../Classes/benchmarks/TransformHierarchyBenchmark.cpp \
+                   ../../Classes/benchmarks/ChildSortBenchmark.cpp \
+                   ../../Classes/benchmarks/MappedFileBenchmark.cpp \
+                   ../../Classes/benchmarks/AssetPackBenchmark.cpp \
+                   ../../Classes/benchmarks/PlistParseBenchmark.cpp \
+                   ../../Classes/benchmarks/PlistFormatBenchmark.cpp \
+                   ../../Classes/benchmarks/ValueMemoryBenchmark.cpp \
+                   ../../Classes/benchmarks/PvrCczBenchmark.cpp
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes \
                     $(LOCAL_PATH)/../../../../extensions \
@@ -0,0 +1,165 @@
+/*
+ * Checks of the XML plist parser of FileUtils: the markup it accepts, the entities, and the broken files,
+ * which must be rejected without reading out of the buffer.
+ * Linked with the engine and the platform of the host, built for example with:
+ *   g++ -std=c++11 -g -fsanitize=address,undefined PlistParserTest.cpp <engine and platform libs> -lz -lpthread
+ * Prints OK when all the checks pass.
+ */
+
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+USING_NS_CC;
+
+static int s_failures = 0;
+
+#define CHECK(__cond__) do { if (!(__cond__)) { printf("%s:%d: %s failed\n", __FILE__, __LINE__, #__cond__); ++s_failures; } } while (0)
+
+static const char PLIST[] =
+    "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+    "<plist version=\"1.0\">\n"
+    "<dict>\n"
+    "    <!-- a comment <dict> -->\n"
+    "    <key>frames</key>\n"
+    "    <dict>\n"
+    "        <key>a&amp;b.png</key>\n"
+    "        <dict>\n"
+    "            <key>frame</key>\n"
+    "            <string>{{1,2},{3,4}}</string>\n"
+    "            <key>rotated</key>\n"
+    "            <false/>\n"
+    "            <key>trimmed</key>\n"
+    "            <true></true>\n"
+    "            <key>data</key>\n"
+    "            <data>AAA=</data>\n"
+    "        </dict>\n"
+    "    </dict>\n"
+    "    <key>items</key>\n"
+    "    <array>\n"
+    "        <integer>42</integer>\n"
+    "        <real>1.5</real>\n"
+    "        <string/>\n"
+    "        <string>&lt;&#65;&#x42;&#x20AC;<![CDATA[x<y&amp;]]>&gt;</string>\n"
+    "        <array/>\n"
+    "        <dict/>\n"
+    "    </array>\n"
+    "    <key attr=\"a > b\">name</key>\n"
+    "    <string>a string longer than the small buffer of Value</string>\n"
+    "</dict>\n"
+    "</plist>\n";
+
+static ValueMap parse(const std::string& text)
+{
+    return FileUtils::getInstance()->getValueMapFromData(text.data(), (int)text.size());
+}
+
+static void testValues()
+{
+    ValueMap root = parse(PLIST);
+    CHECK(root.size() == 3);
+
+    const ValueMap& frames = root["frames"].asValueMap();
+    CHECK(frames.size() == 1 && frames.find("a&b.png") != frames.end());
+    if (frames.find("a&b.png") != frames.end())
+    {
+        ValueMap frame = frames.at("a&b.png").asValueMap();
+        CHECK(frame["frame"].asString() == "{{1,2},{3,4}}");
+        CHECK(frame["rotated"].getType() == Value::Type::BOOLEAN && !frame["rotated"].asBool());
+        CHECK(frame["trimmed"].getType() == Value::Type::BOOLEAN && frame["trimmed"].asBool());
+        // <data> isn't a value of cocos2d, the key is left out
+        CHECK(frame.find("data") == frame.end());
+    }
+
+    const ValueVector& items = root["items"].asValueVector();
+    CHECK(items.size() == 6);
+    if (items.size() == 6)
+    {
+        CHECK(items[0].getType() == Value::Type::INTEGER && items[0].asInt() == 42);
+        CHECK(items[1].asDouble() == 1.5);
+        CHECK(items[2].getType() == Value::Type::STRING && items[2].asString().empty());
+        CHECK(items[3].asString() == "<AB\xE2\x82\xAC" "x<y&amp;>");
+        CHECK(items[4].getType() == Value::Type::VECTOR && items[4].asValueVector().empty());
+        CHECK(items[5].getType() == Value::Type::MAP && items[5].asValueMap().empty());
+    }
+
+    CHECK(root["name"].asString() == "a string longer than the small buffer of Value");
+
+    // without the <plist> tag
+    ValueMap bare = parse("<dict><key>a</key><integer>1</integer></dict>");
+    CHECK(bare.size() == 1 && bare["a"].asInt() == 1);
+}
+
+static void testBrokenFiles()
+{
+    CHECK(parse("<plist><dict><key>a</key><string>x</dict></plist>").empty());
+    CHECK(parse("<plist><dict><key>a</key><string>x</string></array></plist>").empty());
+    CHECK(parse("<plist><dict><string>no key</string></dict></plist>").empty());
+    CHECK(parse("<plist><dict><key>a</key></dict></plist>").empty());
+    CHECK(parse("<plist><array><integer>1</integer></array></plist>").empty());
+    CHECK(parse("not a plist").empty());
+    CHECK(parse("<").empty());
+
+    // every truncation of the file, each stopping before the end of the root dictionary
+    std::string text(PLIST);
+    size_t rootEnd = text.rfind("</dict>");
+    for (size_t size = 1; size <= rootEnd; ++size)
+    {
+        // copied, so the sanitizer catches the reads past the end
+        std::vector<char> truncated(text.begin(), text.begin() + size);
+        CHECK(FileUtils::getInstance()->getValueMapFromData(truncated.data(), (int)size).empty());
+    }
+
+    // the nesting is limited
+    std::string deep = "<dict>";
+    for (int i = 0; i < 1000; ++i)
+        deep += "<key>k</key><dict>";
+    CHECK(parse(deep).empty());
+
+    std::string nested;
+    for (int i = 0; i < 100; ++i)
+        nested += "<dict><key>k</key>";
+    nested += "<true/>";
+    for (int i = 0; i < 100; ++i)
+        nested += "</dict>";
+    CHECK(parse(nested).size() == 1);
+}
+
+static void testWrittenFile()
+{
+    ValueMap frame;
+    frame["frame"] = "{{0,0},{32,32}}";
+    frame["rotated"] = true;
+    frame["sourceColorRect"] = "{{1,1},{30,30}}";
+    ValueMap frames;
+    frames["hero & <friends>.png"] = frame;
+    ValueVector sizes;
+    sizes.push_back(Value(1));
+    sizes.push_back(Value(-2));
+    ValueMap dict;
+    dict["frames"] = frames;
+    dict["sizes"] = sizes;
+    dict["scale"] = 0.25;
+
+    FileUtils* fileUtils = FileUtils::getInstance();
+    std::string path = fileUtils->getWritablePath() + "PlistParserTest.plist";
+    CHECK(fileUtils->writeToFile(dict, path));
+    CHECK(Value(fileUtils->getValueMapFromFile(path)) == Value(dict));
+}
+
+int main()
+{
+    testValues();
+    testBrokenFiles();
+    testWrittenFile();
+
+    if (s_failures == 0)
+    {
+        printf("OK\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}
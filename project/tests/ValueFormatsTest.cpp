@@ -0,0 +1,168 @@
+/*
+ * Round trip checks of the binary plist reader and of the compiled values, see CCValueFormats.h.
+ * Linked with the engine and the platform of the host, built for example with:
+ *   g++ -std=c++11 -g -fsanitize=address,undefined ValueFormatsTest.cpp <engine and platform libs> -lz -lpthread
+ * Prints OK when all the checks pass.
+ */
+
+#include "cocos2d.h"
+#include "platform/CCValueFormats.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+USING_NS_CC;
+
+static int s_failures = 0;
+
+#define CHECK(__cond__) do { if (!(__cond__)) { printf("%s:%d: %s failed\n", __FILE__, __LINE__, #__cond__); ++s_failures; } } while (0)
+
+// plistlib.dumps({'big': 1e10, 'frames': [1, 2, -3], 'name': 'hero', 'nested': {'key': 'value'},
+//                 'scale': 0.5, 'visible': True}, fmt=plistlib.FMT_BINARY)
+static const unsigned char BINARY_PLIST[] = {
+    0x62, 0x70, 0x6c, 0x69, 0x73, 0x74, 0x30, 0x30, 0xd6, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x0c, 0x0d, 0x10, 0x11, 0x53, 0x62, 0x69, 0x67, 0x56, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x73,
+    0x54, 0x6e, 0x61, 0x6d, 0x65, 0x56, 0x6e, 0x65, 0x73, 0x74, 0x65, 0x64, 0x55, 0x73, 0x63, 0x61,
+    0x6c, 0x65, 0x57, 0x76, 0x69, 0x73, 0x69, 0x62, 0x6c, 0x65, 0x23, 0x42, 0x02, 0xa0, 0x5f, 0x20,
+    0x00, 0x00, 0x00, 0xa3, 0x09, 0x0a, 0x0b, 0x10, 0x01, 0x10, 0x02, 0x13, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xfd, 0x54, 0x68, 0x65, 0x72, 0x6f, 0xd1, 0x0e, 0x0f, 0x53, 0x6b, 0x65, 0x79,
+    0x55, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x23, 0x3f, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+    0x08, 0x15, 0x19, 0x20, 0x25, 0x2c, 0x32, 0x3a, 0x43, 0x47, 0x49, 0x4b, 0x54, 0x59, 0x5c, 0x60,
+    0x66, 0x6f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x70
+};
+
+static void testBinaryPlist()
+{
+    CHECK(BinaryPlist::isBinaryPlist(BINARY_PLIST, sizeof(BINARY_PLIST)));
+
+    Value root;
+    CHECK(BinaryPlist::read(BINARY_PLIST, sizeof(BINARY_PLIST), root));
+    CHECK(root.getType() == Value::Type::MAP);
+    if (root.getType() != Value::Type::MAP)
+        return;
+
+    ValueMap& dict = root.asValueMap();
+    CHECK(dict["name"].asString() == "hero");
+    CHECK(dict["scale"].asDouble() == 0.5);
+    CHECK(dict["big"].asDouble() == 1e10);
+    CHECK(dict["visible"].asBool());
+    CHECK(dict["nested"].getType() == Value::Type::MAP && dict["nested"].asValueMap()["key"].asString() == "value");
+
+    const ValueVector& frames = dict["frames"].asValueVector();
+    CHECK(frames.size() == 3 && frames[0].asInt() == 1 && frames[1].asInt() == 2 && frames[2].asInt() == -3);
+
+    // truncated plists are rejected
+    for (size_t size = 0; size < sizeof(BINARY_PLIST); ++size)
+    {
+        Value truncated;
+        CHECK(!BinaryPlist::read(BINARY_PLIST, size, truncated));
+    }
+}
+
+static Value makeTree()
+{
+    ValueMap dict;
+    dict["byte"] = Value((unsigned char)200);
+    dict["zero"] = Value(0);
+    dict["negative"] = Value(-1);
+    dict["min"] = Value(INT_MIN);
+    dict["max"] = Value(INT_MAX);
+    dict["float"] = Value(0.1f);
+    dict["double"] = Value(-1234.5678e100);
+    dict["true"] = Value(true);
+    dict["false"] = Value(false);
+    dict["empty"] = Value("");
+    dict["utf8"] = Value("\xe4\xbd\xa0\xe5\xa5\xbd");
+    dict["none"] = Value();
+
+    ValueVector frames;
+    for (int i = 0; i < 100; ++i)
+    {
+        ValueMap frame;
+        frame["name"] = Value(StringUtils::format("frame_%02d.png", i % 10));
+        frame["rect"] = Value("{{0,0},{64,64}}");
+        frame["rotated"] = Value(i % 2 == 0);
+        frames.push_back(Value(frame));
+    }
+    dict["frames"] = Value(frames);
+
+    ValueMapIntKey tiles;
+    tiles[-7] = Value("negative key");
+    tiles[42] = Value(ValueVector());
+    dict["tiles"] = Value(tiles);
+    dict["emptyMap"] = Value(ValueMap());
+
+    return Value(dict);
+}
+
+static void testCompiledRoundTrip()
+{
+    Value tree = makeTree();
+    std::string compiled;
+    CompiledValue::write(tree, compiled);
+    CHECK(CompiledValue::isCompiledValue((const unsigned char*)compiled.data(), compiled.size()));
+
+    Value read;
+    CHECK(CompiledValue::read((const unsigned char*)compiled.data(), compiled.size(), read));
+    CHECK(read == tree);
+
+    // the file is the same whatever the byte order of the host: the reals are stored as little endian bits
+    std::string single;
+    CompiledValue::write(Value(1.0f), single);
+    const unsigned char floatTail[] = { (unsigned char)Value::Type::FLOAT, 0x00, 0x00, 0x80, 0x3f };
+    CHECK(single.size() >= sizeof(floatTail) && memcmp(single.data() + single.size() - sizeof(floatTail), floatTail, sizeof(floatTail)) == 0);
+
+    single.clear();
+    CompiledValue::write(Value(1.0), single);
+    const unsigned char doubleTail[] = { (unsigned char)Value::Type::DOUBLE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f };
+    CHECK(single.size() >= sizeof(doubleTail) && memcmp(single.data() + single.size() - sizeof(doubleTail), doubleTail, sizeof(doubleTail)) == 0);
+
+    // truncated and corrupted data is rejected, or read without going out of the buffer
+    for (size_t size = 0; size < compiled.size(); size += 7)
+    {
+        Value truncated;
+        CHECK(!CompiledValue::read((const unsigned char*)compiled.data(), size, truncated));
+    }
+    for (size_t i = 0; i < compiled.size(); i += 13)
+    {
+        std::string corrupted = compiled;
+        corrupted[i] ^= 0x55;
+        Value ignored;
+        CompiledValue::read((const unsigned char*)corrupted.data(), corrupted.size(), ignored);
+    }
+}
+
+static void testCompiledFile()
+{
+    FileUtils* fileUtils = FileUtils::getInstance();
+    std::string path = fileUtils->getWritablePath() + "ValueFormatsTest.ccv";
+    Value tree = makeTree();
+    CHECK(fileUtils->writeValueMapToCompiledFile(tree.asValueMap(), path));
+    CHECK(Value(fileUtils->getValueMapFromFile(path)) == tree);
+
+    // the same file as xml, compiled by the build time converter
+    std::string plistPath = fileUtils->getWritablePath() + "ValueFormatsTest.plist";
+    std::string compiledPath = fileUtils->getWritablePath() + "ValueFormatsTest.plist.ccv";
+    ValueMap frames;
+    frames["frames"] = tree.asValueMap()["frames"];
+    CHECK(fileUtils->writeToFile(frames, plistPath));
+    CHECK(fileUtils->compilePlistFile(plistPath, compiledPath));
+    CHECK(Value(fileUtils->getValueMapFromFile(compiledPath)) == Value(fileUtils->getValueMapFromFile(plistPath)));
+}
+
+int main()
+{
+    testBinaryPlist();
+    testCompiledRoundTrip();
+    testCompiledFile();
+
+    if (s_failures == 0)
+    {
+        printf("OK\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}
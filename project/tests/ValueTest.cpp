@@ -0,0 +1,135 @@
+/*
+ * Checks of the strings of Value: the short ones stored inside the value, the long ones allocated,
+ * through the copies, the moves, the assignments, the conversions and the comparisons.
+ * Linked with the engine and the platform of the host, built for example with:
+ *   g++ -std=c++11 -g -fsanitize=address,undefined ValueTest.cpp <engine and platform libs> -lz -lpthread
+ * Prints OK when all the checks pass.
+ */
+
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <string>
+#include <utility>
+
+USING_NS_CC;
+
+static int s_failures = 0;
+
+#define CHECK(__cond__) do { if (!(__cond__)) { printf("%s:%d: %s failed\n", __FILE__, __LINE__, #__cond__); ++s_failures; } } while (0)
+
+static const char* SHORT_STRING = "short";
+// the longest string stored inside the value
+static const char* FULL_STRING = "0123456789abcde";
+static const char* LONG_STRING = "a string longer than fifteen chars";
+
+static void testCopies()
+{
+    Value shortValue(SHORT_STRING);
+    Value fullValue = Value(std::string(FULL_STRING));
+    Value longValue = Value(std::string(LONG_STRING));
+    CHECK(shortValue.asString() == SHORT_STRING);
+    CHECK(fullValue.asString() == FULL_STRING);
+    CHECK(longValue.asString() == LONG_STRING);
+
+    Value copy(shortValue);
+    CHECK(copy == shortValue);
+    copy = longValue;
+    CHECK(copy == longValue && copy != shortValue);
+    copy = shortValue;
+    CHECK(copy == shortValue && copy != longValue);
+    copy = fullValue;
+    CHECK(copy.asString() == FULL_STRING);
+
+    copy = std::string("another string longer than fifteen chars");
+    CHECK(copy.asString() == "another string longer than fifteen chars");
+    copy = "x";
+    CHECK(copy.asString() == "x");
+    copy = Value("");
+    CHECK(copy.getType() == Value::Type::STRING && copy.asString().empty());
+    copy = 5;
+    CHECK(copy.getType() == Value::Type::INTEGER && copy.asInt() == 5);
+
+    // self assignment
+    Value& self = fullValue;
+    fullValue = self;
+    CHECK(fullValue.asString() == FULL_STRING);
+    longValue = longValue;
+    CHECK(longValue.asString() == LONG_STRING);
+
+    // a container replaced by a string
+    ValueMap dict;
+    dict["key"] = Value("value");
+    Value container(dict);
+    container = Value("z");
+    CHECK(container.getType() == Value::Type::STRING && container.asString() == "z");
+}
+
+static void testMoves()
+{
+    Value shortValue(SHORT_STRING);
+    Value longValue = Value(std::string(LONG_STRING));
+
+    Value movedShort(std::move(shortValue));
+    CHECK(movedShort.asString() == SHORT_STRING && shortValue.isNull());
+    Value movedLong(std::move(longValue));
+    CHECK(movedLong.asString() == LONG_STRING && longValue.isNull());
+
+    movedShort = std::move(movedLong);
+    CHECK(movedShort.asString() == LONG_STRING && movedLong.isNull());
+
+    // a short std::string is copied inside the value, and keeps its content
+    std::string text(FULL_STRING);
+    Value fromString;
+    fromString = std::move(text);
+    CHECK(fromString.asString() == FULL_STRING && text == FULL_STRING);
+
+    std::string longText(LONG_STRING);
+    Value fromLongString(std::move(longText));
+    CHECK(fromLongString.asString() == LONG_STRING);
+}
+
+static void testConversions()
+{
+    CHECK(Value("12").asInt() == 12);
+    CHECK(!Value("false").asBool());
+    CHECK(Value("true").asBool());
+    CHECK(Value("1.5").asFloat() == 1.5f);
+    CHECK(Value("2.25").asDouble() == 2.25);
+    CHECK(Value(42).asString() == "42");
+    CHECK(Value(true).asString() == "true");
+}
+
+static void testContainers()
+{
+    ValueVector values;
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back(Value(i % 2 ? SHORT_STRING : LONG_STRING));
+    }
+    ValueVector copy = values;
+    CHECK(Value(values) == Value(copy));
+
+    copy[1] = LONG_STRING;
+    CHECK(Value(values) != Value(copy));
+
+    ValueMap dict;
+    dict[LONG_STRING] = Value(FULL_STRING);
+    dict[SHORT_STRING] = Value(LONG_STRING);
+    ValueMap other = dict;
+    CHECK(Value(dict) == Value(other));
+}
+
+int main()
+{
+    testCopies();
+    testMoves();
+    testConversions();
+    testContainers();
+
+    if (s_failures == 0)
+    {
+        printf("OK\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}
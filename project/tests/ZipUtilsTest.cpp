@@ -0,0 +1,208 @@
+/*
+ * Checks of ZipUtils, meant to run under AddressSanitizer and UndefinedBehaviorSanitizer.
+ * Linked with the engine and the platform of the host, built for example with:
+ *   g++ -std=c++11 -g -fsanitize=address,undefined ZipUtilsTest.cpp <engine and platform libs> -lz -lpthread
+ * with the engine also built with -fsanitize=address,undefined. Prints OK when all the checks pass.
+ */
+
+#include "cocos2d.h"
+#include "base/ZipUtils.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+USING_NS_CC;
+
+static int s_failures = 0;
+
+#define CHECK(__cond__) do { if (!(__cond__)) { printf("%s:%d: %s failed\n", __FILE__, __LINE__, #__cond__); ++s_failures; } } while (0)
+
+static std::vector<unsigned char> deflateData(const std::string& data, int windowBits)
+{
+    std::vector<unsigned char> out(compressBound(data.size()) + 64);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    stream.next_in = (Bytef*)data.data();
+    stream.avail_in = (uInt)data.size();
+    stream.next_out = out.data();
+    stream.avail_out = (uInt)out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+static std::string writeFile(const std::string& name, const unsigned char* bytes, size_t size)
+{
+    std::string path = FileUtils::getInstance()->getWritablePath() + name;
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (fp)
+    {
+        if (size > 0)
+            fwrite(bytes, 1, size, fp);
+        fclose(fp);
+    }
+    return path;
+}
+
+static bool sameBytes(const unsigned char* bytes, ssize_t size, const std::string& expected)
+{
+    return size == (ssize_t)expected.size() && (size == 0 || memcmp(bytes, expected.data(), size) == 0);
+}
+
+static void testInflateMemory(const std::string& text)
+{
+    const std::string second = "second gzip member";
+    std::vector<unsigned char> gzip = deflateData(text, 15 + 16);
+    std::vector<unsigned char> gzipSecond = deflateData(second, 15 + 16);
+    std::vector<unsigned char> members = gzip;
+    members.insert(members.end(), gzipSecond.begin(), gzipSecond.end());
+
+    CHECK(ZipUtils::getGZipBufferInflatedLengthHint(gzip.data(), gzip.size()) == (ssize_t)text.size());
+
+    // concatenated members are inflated one after the other
+    unsigned char* out = nullptr;
+    ssize_t len = ZipUtils::inflateMemory(members.data(), members.size(), &out);
+    CHECK(sameBytes(out, len, text + second));
+    free(out);
+
+    // a small hint only makes the buffer grow
+    out = nullptr;
+    len = ZipUtils::inflateMemoryWithHint(gzip.data(), gzip.size(), &out, 16);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+
+    std::vector<unsigned char> zlib = deflateData(text, 15);
+    out = nullptr;
+    len = ZipUtils::inflateMemoryWithHint(zlib.data(), zlib.size(), &out, 100);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+
+    // inflating into a given buffer fails if it is too small or the input is truncated
+    std::vector<unsigned char> buffer(text.size());
+    CHECK(ZipUtils::inflateMemoryToBuffer(zlib.data(), zlib.size(), buffer.data(), buffer.size()) == (ssize_t)text.size());
+    CHECK(ZipUtils::inflateMemoryToBuffer(zlib.data(), zlib.size(), buffer.data(), buffer.size() - 1) == -1);
+    CHECK(ZipUtils::inflateMemoryToBuffer(zlib.data(), zlib.size() / 2, buffer.data(), buffer.size()) == -1);
+}
+
+static void testCCZ(const std::string& text)
+{
+    std::vector<unsigned char> zlib = deflateData(text, 15);
+    std::vector<unsigned char> ccz(sizeof(CCZHeader) + zlib.size());
+    // the header is big endian, swapping from the host order is the same operation
+    CCZHeader header;
+    memcpy(header.sig, "CCZ!", 4);
+    header.compression_type = CC_SWAP_INT16_BIG_TO_HOST(CCZ_COMPRESSION_ZLIB);
+    header.version = CC_SWAP_INT16_BIG_TO_HOST(2);
+    header.reserved = 0;
+    header.len = CC_SWAP_INT32_BIG_TO_HOST((unsigned int)text.size());
+    memcpy(ccz.data(), &header, sizeof(header));
+    memcpy(ccz.data() + sizeof(header), zlib.data(), zlib.size());
+
+    CHECK(ZipUtils::isCCZBuffer(ccz.data(), ccz.size()));
+    CHECK(ZipUtils::getCCZBufferInflatedLength(ccz.data(), ccz.size()) == (ssize_t)text.size());
+
+    unsigned char* out = nullptr;
+    ssize_t len = ZipUtils::inflateCCZBuffer(ccz.data(), ccz.size(), &out);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+
+    std::vector<unsigned char> buffer(text.size());
+    CHECK(ZipUtils::inflateCCZBufferToBuffer(ccz.data(), ccz.size(), buffer.data(), buffer.size()) == (ssize_t)text.size());
+    CHECK(ZipUtils::inflateCCZBufferToBuffer(ccz.data(), ccz.size(), buffer.data(), buffer.size() - 1) == -1);
+
+    // a header shorter than announced
+    CHECK(ZipUtils::inflateCCZBuffer(ccz.data(), sizeof(CCZHeader) - 1, &out) < 0);
+
+    std::string path = writeFile("ZipUtilsTest.ccz", ccz.data(), ccz.size());
+    CHECK(ZipUtils::isCCZFile(path.c_str()));
+    out = nullptr;
+    len = ZipUtils::inflateCCZFile(path.c_str(), &out);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+}
+
+static void testGZipFile(const std::string& text)
+{
+    std::vector<unsigned char> gzip = deflateData(text, 15 + 16);
+    std::string path = writeFile("ZipUtilsTest.gz", gzip.data(), gzip.size());
+    CHECK(ZipUtils::isGZipFile(path.c_str()));
+    unsigned char* out = nullptr;
+    int len = ZipUtils::inflateGZipFile(path.c_str(), &out);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+
+    // the files which aren't compressed are passed through, as gzread() does
+    path = writeFile("ZipUtilsTest.txt", (const unsigned char*)text.data(), text.size());
+    CHECK(!ZipUtils::isGZipFile(path.c_str()));
+    out = nullptr;
+    len = ZipUtils::inflateGZipFile(path.c_str(), &out);
+    CHECK(sameBytes(out, len, text));
+    free(out);
+
+    // an empty file can't be read, as with getDataFromFile()
+    path = writeFile("ZipUtilsTest.empty", nullptr, 0);
+    out = nullptr;
+    len = ZipUtils::inflateGZipFile(path.c_str(), &out);
+    CHECK(len < 0 && out == nullptr);
+
+    // a truncated stream fails
+    path = writeFile("ZipUtilsTest.truncated.gz", gzip.data(), gzip.size() / 2);
+    out = nullptr;
+    len = ZipUtils::inflateGZipFile(path.c_str(), &out);
+    CHECK(len < 0 && out == nullptr);
+
+    out = nullptr;
+    CHECK(ZipUtils::inflateGZipFile((path + ".missing").c_str(), &out) < 0);
+}
+
+static void testInflateParallel(const std::string& text)
+{
+    std::vector<unsigned char> gzip = deflateData(text, 15 + 16);
+    std::vector<unsigned char> zlib = deflateData(text, 15);
+
+    const int count = 8;
+    std::vector<std::vector<unsigned char> > outs(count, std::vector<unsigned char>(text.size()));
+    ZipUtils::InflateJob jobs[count];
+    for (int i = 0; i < count; ++i)
+    {
+        jobs[i].in = (i % 2) ? zlib.data() : gzip.data();
+        jobs[i].inLength = (i % 2) ? zlib.size() : gzip.size();
+        jobs[i].out = outs[i].data();
+        jobs[i].outLength = text.size();
+        jobs[i].result = 0;
+    }
+    CHECK(ZipUtils::inflateMemoryParallel(jobs, count));
+    for (int i = 0; i < count; ++i)
+    {
+        CHECK(sameBytes(outs[i].data(), jobs[i].result, text));
+    }
+
+    // one truncated input fails the whole batch
+    jobs[3].inLength = 10;
+    CHECK(!ZipUtils::inflateMemoryParallel(jobs, count));
+}
+
+int main()
+{
+    std::string text(300000, 'a');
+    for (size_t i = 0; i < text.size(); i += 7)
+    {
+        text[i] = (char)('x' + i % 3);
+    }
+
+    testInflateMemory(text);
+    testCCZ(text);
+    testGZipFile(text);
+    testInflateParallel(text);
+
+    if (s_failures == 0)
+    {
+        printf("OK\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}